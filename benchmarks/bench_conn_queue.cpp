@@ -0,0 +1,62 @@
+#include "bench_utility.hpp"
+
+namespace {
+
+using queue_type = beast_router::base::conn_queue<bench::session::impl>;
+
+/// Queues the given number of the responses and completes their writes
+void conn_queue(benchmark::State& state)
+{
+    const auto depth = state.range(0);
+
+    bench::net::io_context ioc;
+    bench::session::impl impl { ioc };
+    queue_type queue { impl };
+    const beast_router::prepared_response response {
+        beast_router::make_string_response(beast_router::http::status::ok, 11, "Hello World!")
+    };
+
+    bench::allocation_counter allocations { state };
+    for (auto _ : state) {
+        for (auto idx = 0; idx < depth; ++idx) {
+            queue(response.keep_alive(true));
+        }
+        for (auto idx = 0; idx < depth; ++idx) {
+            queue.on_write();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+
+/// Queues the responses along with the completion handlers
+void conn_queue_handler(benchmark::State& state)
+{
+    const auto depth = state.range(0);
+
+    bench::net::io_context ioc;
+    bench::session::impl impl { ioc };
+    queue_type queue { impl };
+    const beast_router::prepared_response response {
+        beast_router::make_string_response(beast_router::http::status::ok, 11, "Hello World!")
+    };
+
+    std::size_t completed = 0;
+    bench::allocation_counter allocations { state };
+    for (auto _ : state) {
+        for (auto idx = 0; idx < depth; ++idx) {
+            queue(response.keep_alive(true), [&completed](boost::system::error_code, std::size_t) {
+                ++completed;
+            });
+        }
+        for (auto idx = 0; idx < depth; ++idx) {
+            queue.on_write();
+        }
+    }
+    benchmark::DoNotOptimize(completed);
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+
+} // namespace
+
+BENCHMARK(conn_queue)->ArgNames({ "depth" })->Arg(1)->Arg(16);
+BENCHMARK(conn_queue_handler)->ArgNames({ "depth" })->Arg(1)->Arg(16);
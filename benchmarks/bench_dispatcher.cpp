@@ -0,0 +1,103 @@
+#include <string>
+
+#include "bench_utility.hpp"
+
+namespace {
+
+/// The kinds of the route patterns
+enum pattern_type : int {
+    /// e.g. `^/r7$`
+    literal,
+    /// e.g. `^/r7/([^/]+)/([0-9]+)$`
+    capture,
+    /// e.g. `^/r7/.*$`
+    wildcard
+};
+
+std::string make_route(pattern_type pattern, int idx)
+{
+    const auto prefix = "^/r" + std::to_string(idx);
+    switch (pattern) {
+    case literal:
+        return prefix + "$";
+    case capture:
+        return prefix + "/([^/]+)/([0-9]+)$";
+    default:
+        return prefix + "/.*$";
+    }
+}
+
+std::string make_target(pattern_type pattern, int idx)
+{
+    const auto prefix = "/r" + std::to_string(idx);
+    switch (pattern) {
+    case literal:
+        return prefix;
+    case capture:
+        return prefix + "/items/42";
+    default:
+        return prefix + "/some/nested/path";
+    }
+}
+
+/// Dispatches a request matching the last of the routes; every route is
+/// tried by the dispatcher
+void dispatch(benchmark::State& state)
+{
+    const auto routes = static_cast<int>(state.range(0));
+    const auto pattern = static_cast<pattern_type>(state.range(1));
+
+    bench::session::router_type router;
+    for (int idx = 0; idx < routes; ++idx) {
+        router.get(make_route(pattern, idx), [](const bench::session::message_type& rq,
+                                                 bench::session::context_type&) {
+            benchmark::DoNotOptimize(rq);
+        });
+    }
+    bench::session::dispatcher_type dispatcher { router };
+
+    bench::net::io_context ioc;
+    auto impl = std::make_shared<bench::session::impl>(ioc);
+    auto request = beast_router::make_empty_request(beast_router::http::verb::get, 11,
+        make_target(pattern, routes - 1));
+
+    bench::allocation_counter allocations { state };
+    for (auto _ : state) {
+        // the request is moved from by the offloaded routes only
+        dispatcher.do_process_request(std::move(request), *impl);
+    }
+}
+
+/// Dispatches a request matching no route, i.e. the "not_found" handler
+void dispatch_not_found(benchmark::State& state)
+{
+    const auto routes = static_cast<int>(state.range(0));
+
+    bench::session::router_type router;
+    for (int idx = 0; idx < routes; ++idx) {
+        router.get(make_route(literal, idx), [](bench::session::context_type&) {});
+    }
+    router.not_found([](bench::session::context_type&) {});
+    bench::session::dispatcher_type dispatcher { router };
+
+    bench::net::io_context ioc;
+    auto impl = std::make_shared<bench::session::impl>(ioc);
+    auto request = beast_router::make_empty_request(beast_router::http::verb::get, 11, "/missing");
+
+    bench::allocation_counter allocations { state };
+    for (auto _ : state) {
+        dispatcher.do_process_request(std::move(request), *impl);
+    }
+}
+
+} // namespace
+
+BENCHMARK(dispatch)
+    ->ArgNames({ "routes", "pattern" })
+    ->ArgsProduct({ { 1, 10, 100 }, { literal, capture, wildcard } });
+
+BENCHMARK(dispatch_not_found)
+    ->ArgNames({ "routes" })
+    ->Arg(1)
+    ->Arg(10)
+    ->Arg(100);
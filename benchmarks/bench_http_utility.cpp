@@ -0,0 +1,59 @@
+#include <string>
+
+#include "bench_utility.hpp"
+
+namespace {
+
+using beast_router::http::status;
+
+void make_empty_response(benchmark::State& state)
+{
+    bench::allocation_counter allocations { state };
+    for (auto _ : state) {
+        auto rp = beast_router::make_empty_response(status::no_content, 11);
+        benchmark::DoNotOptimize(rp);
+    }
+}
+
+void make_moved_response(benchmark::State& state)
+{
+    bench::allocation_counter allocations { state };
+    for (auto _ : state) {
+        auto rp = beast_router::make_moved_response(11, "/new/location");
+        benchmark::DoNotOptimize(rp);
+    }
+}
+
+/// Builds a response within the body of the given size
+void make_string_response(benchmark::State& state)
+{
+    const std::string body(static_cast<std::size_t>(state.range(0)), 'x');
+
+    bench::allocation_counter allocations { state };
+    for (auto _ : state) {
+        auto rp = beast_router::make_string_response(status::ok, 11, body);
+        benchmark::DoNotOptimize(rp);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+/// Shares the serialized bytes of a prepared response
+void prepared_response(benchmark::State& state)
+{
+    beast_router::prepared_response response {
+        beast_router::make_string_response(status::ok, 11, "Hello World!")
+    };
+
+    bench::allocation_counter allocations { state };
+    for (auto _ : state) {
+        auto rp = response.keep_alive(true);
+        benchmark::DoNotOptimize(rp.buffers());
+    }
+}
+
+} // namespace
+
+BENCHMARK(make_empty_response);
+BENCHMARK(make_moved_response);
+BENCHMARK(make_string_response)->ArgNames({ "bytes" })->Arg(16)->Arg(4096);
+BENCHMARK(prepared_response);
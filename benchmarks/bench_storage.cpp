@@ -0,0 +1,42 @@
+#include <regex>
+#include <utility>
+
+#include "bench_utility.hpp"
+
+namespace {
+
+template <std::size_t Idx>
+bool chained(const bench::session::message_type& rq, bench::session::context_type&)
+{
+    benchmark::DoNotOptimize(rq);
+    return true;
+}
+
+template <std::size_t... Idxs>
+bench::session::storage_type make_storage(std::index_sequence<Idxs...>)
+{
+    return bench::session::storage_type { &chained<Idxs>... };
+}
+
+/// Runs a chain of the given length
+template <std::size_t Length>
+void begin_execute(benchmark::State& state)
+{
+    auto storage = make_storage(std::make_index_sequence<Length> {});
+
+    bench::net::io_context ioc;
+    auto impl = std::make_shared<bench::session::impl>(ioc);
+    const auto request = beast_router::make_empty_request(beast_router::http::verb::get, 11, "/");
+
+    bench::allocation_counter allocations { state };
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(storage.begin_execute(request,
+            bench::session::context_type { *impl }, std::smatch {}));
+    }
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(begin_execute, 1);
+BENCHMARK_TEMPLATE(begin_execute, 4);
+BENCHMARK_TEMPLATE(begin_execute, 16);
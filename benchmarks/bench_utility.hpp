@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <type_traits>
+
+#include "beast_router.hpp"
+
+namespace bench {
+
+namespace net = boost::asio;
+
+/// The number of the heap allocations made by the program
+extern std::atomic<std::size_t> allocations;
+
+/// Reports the heap allocations per iteration of the benchmark
+/**
+ * Has to be constructed right before the loop of the benchmark
+ */
+class allocation_counter {
+public:
+    explicit allocation_counter(benchmark::State& state)
+        : m_state { state }
+        , m_start { allocations.load(std::memory_order_relaxed) }
+    {
+    }
+
+    allocation_counter(const allocation_counter&) = delete;
+
+    allocation_counter& operator=(const allocation_counter&) = delete;
+
+    ~allocation_counter()
+    {
+        const auto count = allocations.load(std::memory_order_relaxed) - m_start;
+        m_state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(count),
+            benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    benchmark::State& m_state;
+    const std::size_t m_start;
+};
+
+/// The session which only dispatches, nothing is read or written
+struct session {
+    struct impl;
+
+    using timer_type = beast_router::timer<beast_router::base::strand_stream::asio_type,
+        boost::asio::steady_timer>;
+
+    using timer_duration_type = typename timer_type::duration_type;
+
+    using is_request = std::true_type;
+
+    using body_type = beast_router::http::empty_body;
+
+    using message_type = beast_router::http::request<body_type>;
+
+    using method_type = beast_router::http::verb;
+
+    using impl_type = impl;
+
+    using context_type = beast_router::http_server_type::context<impl_type>;
+
+    using router_type = beast_router::router<session>;
+
+    using storage_type = typename router_type::storage_type;
+
+    using dispatcher_type = beast_router::base::dispatcher<session>;
+
+    struct connection {
+        bool is_open() const { return true; }
+    };
+
+    struct impl : public beast_router::base::strand_stream,
+                  public std::enable_shared_from_this<impl> {
+        using self_type = impl;
+
+        explicit impl(net::io_context& ioc)
+            : beast_router::base::strand_stream { ioc.get_executor() }
+        {
+        }
+
+        self_type& recv() { return *this; }
+
+        template <class Message>
+        self_type& send([[maybe_unused]] Message&& message)
+        {
+            return *this;
+        }
+
+        template <class Message>
+        self_type& send([[maybe_unused]] Message&& message,
+            [[maybe_unused]] timer_duration_type duration)
+        {
+            return *this;
+        }
+
+        /// Called by the connection queue
+        template <class Message>
+        void do_write(Message& message)
+        {
+            benchmark::DoNotOptimize(message);
+        }
+
+        connection m_connection;
+    };
+};
+
+} // namespace bench
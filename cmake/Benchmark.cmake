@@ -0,0 +1,32 @@
+include(CMakeParseArguments)
+
+function(add_benchmark TARGET)
+    set(multi_value_args SOURCES)
+
+    cmake_parse_arguments(
+        BENCHMARK
+        ""
+        ""
+        "${multi_value_args}"
+        ${ARGN}
+    )
+
+    message(STATUS "Adding benchmark \"${TARGET}\"")
+
+    if (NOT BENCHMARK_SOURCES)
+        set(BENCHMARK_SOURCES "${TARGET}.cpp")
+    endif()
+
+    add_executable(${TARGET} ${BENCHMARK_SOURCES})
+
+    target_link_libraries(
+        ${TARGET}
+        PRIVATE
+            beast_router::beast_router
+            beast_router::compile_options
+            benchmark::benchmark
+    )
+
+endfunction()
+
+find_package(benchmark REQUIRED)
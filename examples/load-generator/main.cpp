@@ -0,0 +1,488 @@
+#include "beast_router.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Load generator
+/**
+ * Drives an HTTP server by the client side of the library, i.e. the
+ * connections are made by `http_connector_type` and the requests are sent
+ * and the responses are parsed by `http_client_type`. Every connection keeps
+ * up to the given number of the requests in flight (pipelining).
+ *
+ * Two modes are supported:
+ * - closed loop (default): a request is sent as soon as a response arrives,
+ *   the latency is measured from the moment the request is sent
+ * - fixed rate (`-r`): the requests are scheduled at the given total rate
+ *   and the latency is measured from the moment the request was due rather
+ *   than sent, so that a stalled server is not hidden by the generator
+ *   waiting for it (the coordinated omission)
+ *
+ * A server serving a small response on the loopback interface is started
+ * when no URL is given.
+ *
+ * Usage: load_generator [-c connections=32] [-t threads=1] [-d seconds=5]
+ *     [-p pipeline=1] [-r requests per second] [-s server threads=1] [--close]
+ *     [http://host:port/target]
+ */
+
+namespace net = boost::asio;
+namespace http = beast_router::http;
+
+using namespace std::chrono_literals;
+using clock_type = std::chrono::steady_clock;
+
+/// The options of the command line
+struct options {
+    int connections = 32;
+    unsigned threads = 1;
+    int seconds = 5;
+    std::size_t pipeline = 1;
+    double rate = 0;
+    unsigned server_threads = 1;
+    bool close = false;
+    std::string host;
+    std::string port;
+    std::string target = "/";
+};
+
+/// The counters of a connection, merged once the load is stopped
+struct report {
+    beast_router::latency_histogram latency;
+    std::uint64_t responses = 0;
+    std::uint64_t non_2xx = 0;
+    std::uint64_t errors = 0;
+    std::uint64_t unfinished = 0;
+    std::uint64_t connects = 0;
+    std::uint64_t body_bytes = 0;
+
+    void merge(const report& other)
+    {
+        for (std::size_t idx = 0; idx < latency.counts.size(); ++idx) {
+            latency.counts[idx] += other.latency.counts[idx];
+        }
+        latency.count += other.latency.count;
+        latency.sum += other.latency.sum;
+        responses += other.responses;
+        non_2xx += other.non_2xx;
+        errors += other.errors;
+        unfinished += other.unfinished;
+        connects += other.connects;
+        body_bytes += other.body_bytes;
+    }
+};
+
+/// Drives a single connection
+/**
+ * The state is kept on the strand of the driver; the session is used by its
+ * thread safe context only. Exactly one read is outstanding while there are
+ * the requests in flight, the responses arrive in the order of the requests.
+ */
+class driver : public std::enable_shared_from_this<driver> {
+public:
+    using strand_type = net::strand<net::io_context::executor_type>;
+    using context_type = beast_router::http_client_type::context_type;
+
+    driver(net::io_context& ioc, const options& opts, clock_type::time_point start,
+        clock_type::time_point deadline, clock_type::duration interval)
+        : m_strand { net::make_strand(ioc) }
+        , m_timer { m_strand }
+        , m_retry { m_strand }
+        , m_options { opts }
+        , m_deadline { deadline }
+        , m_interval { interval }
+        , m_next { start }
+        , m_request { beast_router::make_empty_request(http::verb::get, 11, opts.target) }
+        , m_router {}
+        , m_context {}
+        , m_connecting { false }
+        , m_generation { 0 }
+        , m_pending {}
+        , m_inflight {}
+        , m_report {}
+    {
+        m_request.set(http::field::host, opts.host);
+    }
+
+    void run()
+    {
+        m_router.handle_response([weak = weak_from_this()](
+                                     const beast_router::http_client_type::message_type& rp,
+                                     context_type&) {
+            if (auto self = weak.lock()) {
+                net::dispatch(self->m_strand, [self, status = rp.result_int(),
+                                                  keep_alive = rp.keep_alive(),
+                                                  bytes = rp.body().size()]() {
+                    self->on_response(status, keep_alive, bytes);
+                });
+            }
+        });
+
+        net::dispatch(m_strand, [self = shared_from_this()]() {
+            if (self->m_interval == clock_type::duration::zero()) {
+                self->m_pending.assign(self->m_options.pipeline, clock_type::now());
+                self->do_pump();
+            } else {
+                self->do_schedule();
+            }
+        });
+    }
+
+    /// Stops the driver, drops the session
+    /**
+     * Must be called once the event loop is stopped
+     */
+    const report& finish()
+    {
+        m_report.unfinished += m_inflight.size();
+        m_context.reset();
+        m_router = {};
+        return m_report;
+    }
+
+private:
+    void do_schedule()
+    {
+        const auto now = clock_type::now();
+        for (; m_next <= now && m_next < m_deadline; m_next += m_interval) {
+            m_pending.push_back(m_next);
+        }
+        do_pump();
+
+        if (m_next < m_deadline) {
+            m_timer.expires_at(m_next);
+            m_timer.async_wait([self = shared_from_this()](boost::system::error_code ec) {
+                if (!ec) {
+                    self->do_schedule();
+                }
+            });
+        }
+    }
+
+    void do_pump()
+    {
+        if (!m_context) {
+            if (!m_connecting && !m_pending.empty() && clock_type::now() < m_deadline) {
+                do_connect();
+            }
+            return;
+        }
+
+        while (!m_pending.empty() && m_inflight.size() < m_options.pipeline) {
+            const bool idle = m_inflight.empty();
+            m_inflight.push_back(m_pending.front());
+            m_pending.pop_front();
+
+            m_context->send(beast_router::http_empty_request { m_request });
+            if (idle) {
+                m_context->recv();
+            }
+        }
+    }
+
+    void do_connect()
+    {
+        m_connecting = true;
+        beast_router::http_connector_type::async_connect(m_strand.context(),
+            m_options.host, m_options.port,
+            net::bind_executor(m_strand, [self = shared_from_this()](boost::system::error_code ec, beast_router::http_connector_type::socket_type socket) {
+                self->on_connect(ec, std::move(socket));
+            }));
+    }
+
+    void on_connect(boost::system::error_code ec, beast_router::http_connector_type::socket_type socket)
+    {
+        m_connecting = false;
+        if (ec) {
+            ++m_report.errors;
+            m_retry.expires_after(100ms);
+            m_retry.async_wait([self = shared_from_this()](boost::system::error_code ec) {
+                if (!ec) {
+                    self->do_pump();
+                }
+            });
+            return;
+        }
+
+        ++m_report.connects;
+        socket.set_option(net::ip::tcp::no_delay(true));
+
+        const auto generation = ++m_generation;
+        beast_router::http_client_type::on_error_type on_error =
+            [weak = weak_from_this(), generation](boost::system::error_code, std::string_view) {
+                if (auto self = weak.lock()) {
+                    net::dispatch(self->m_strand, [self, generation]() {
+                        self->on_failure(generation);
+                    });
+                }
+            };
+
+        m_inflight.push_back(m_pending.front());
+        m_pending.pop_front();
+        m_context = beast_router::http_client_type::send(std::move(socket),
+            beast_router::http_empty_request { m_request },
+            m_router, std::move(on_error));
+        m_context->recv();
+        do_pump();
+    }
+
+    void on_response(unsigned status, bool keep_alive, std::size_t bytes)
+    {
+        if (m_inflight.empty()) {
+            return;
+        }
+
+        const auto now = clock_type::now();
+        m_report.latency.record(std::chrono::duration_cast<std::chrono::microseconds>(
+            now - m_inflight.front())
+                                    .count());
+        m_inflight.pop_front();
+        ++m_report.responses;
+        m_report.body_bytes += bytes;
+        if (status < 200 || status > 299) {
+            ++m_report.non_2xx;
+        }
+
+        if (m_interval == clock_type::duration::zero() && now < m_deadline) {
+            m_pending.push_back(now);
+        }
+
+        /// the client closes the connection itself, as the session shuts down
+        /// the socket once a request of `Connection: close` is written
+        if (!keep_alive || m_options.close) {
+            do_drop(now);
+        } else if (!m_inflight.empty()) {
+            m_context->recv();
+        }
+        do_pump();
+    }
+
+    void on_failure(std::size_t generation)
+    {
+        if (generation != m_generation || !m_context) {
+            return;
+        }
+
+        ++m_report.errors;
+        do_drop(clock_type::now());
+        do_pump();
+    }
+
+    /// Drops the connection, the requests in flight are counted as the errors
+    void do_drop(clock_type::time_point now)
+    {
+        m_report.errors += m_inflight.size();
+        if (m_interval == clock_type::duration::zero() && now < m_deadline) {
+            m_pending.insert(m_pending.end(), m_inflight.size(), now);
+        }
+        m_inflight.clear();
+        m_context.reset();
+    }
+
+    strand_type m_strand;
+    net::steady_timer m_timer;
+    net::steady_timer m_retry;
+    const options& m_options;
+    clock_type::time_point m_deadline;
+    clock_type::duration m_interval;
+    clock_type::time_point m_next;
+    beast_router::http_empty_request m_request;
+    beast_router::http_client_type::router_type m_router;
+    std::optional<context_type> m_context;
+    bool m_connecting;
+    std::size_t m_generation;
+    std::deque<clock_type::time_point> m_pending;
+    std::deque<clock_type::time_point> m_inflight;
+    report m_report;
+};
+
+/// Parses `http://host:port/target`
+bool parse_url(std::string_view url, options& opts)
+{
+    constexpr std::string_view scheme = "http://";
+    if (url.substr(0, scheme.size()) != scheme) {
+        return false;
+    }
+    url.remove_prefix(scheme.size());
+
+    const auto slash = url.find('/');
+    const auto authority = url.substr(0, slash);
+    opts.target = slash == std::string_view::npos ? "/" : std::string { url.substr(slash) };
+
+    const auto colon = authority.rfind(':');
+    opts.host = std::string { authority.substr(0, colon) };
+    opts.port = colon == std::string_view::npos ? "80" : std::string { authority.substr(colon + 1) };
+    return !opts.host.empty() && !opts.port.empty();
+}
+
+std::optional<options> parse_options(int argc, char** argv)
+{
+    options opts;
+    for (int idx = 1; idx < argc; ++idx) {
+        const std::string_view arg = argv[idx];
+        const auto value = [&]() -> const char* {
+            return idx + 1 < argc ? argv[++idx] : "0";
+        };
+
+        if (arg == "-c") {
+            opts.connections = std::atoi(value());
+        } else if (arg == "-t") {
+            opts.threads = static_cast<unsigned>(std::atoi(value()));
+        } else if (arg == "-d") {
+            opts.seconds = std::atoi(value());
+        } else if (arg == "-p") {
+            opts.pipeline = static_cast<std::size_t>(std::atoi(value()));
+        } else if (arg == "-r") {
+            opts.rate = std::atof(value());
+        } else if (arg == "-s") {
+            opts.server_threads = static_cast<unsigned>(std::atoi(value()));
+        } else if (arg == "--close") {
+            opts.close = true;
+        } else if (!parse_url(arg, opts)) {
+            return std::nullopt;
+        }
+    }
+
+    if (opts.connections < 1 || opts.threads < 1 || opts.seconds < 1 || opts.pipeline < 1
+        || opts.rate < 0 || opts.server_threads < 1) {
+        return std::nullopt;
+    }
+    if (opts.close) {
+        opts.pipeline = 1;
+    }
+    return opts;
+}
+
+void print_report(const options& opts, const report& total, clock_type::duration elapsed)
+{
+    const auto seconds = std::chrono::duration<double> { elapsed }.count();
+    const auto to_ms = [](std::uint64_t us) {
+        return static_cast<double>(us) / 1000.0;
+    };
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "Running " << opts.seconds << "s test @ http://" << opts.host << ':' << opts.port
+              << opts.target << '\n'
+              << "  " << opts.threads << " threads and " << opts.connections << " connections, pipeline "
+              << opts.pipeline << (opts.close ? ", connection close" : ", keep alive") << '\n';
+    if (opts.rate > 0) {
+        std::cout << "  fixed rate " << opts.rate << " req/s, latency from the intended send time\n";
+    } else {
+        std::cout << "  closed loop, latency from the send time\n";
+    }
+
+    const auto& latency = total.latency;
+    if (latency.count != 0) {
+        std::cout << "  Latency mean " << to_ms(latency.sum / latency.count) << "ms\n"
+                  << "  Latency Distribution (upper bounds of the buckets)\n";
+        for (double quantile : { 0.5, 0.75, 0.9, 0.99, 0.999, 0.9999, 1.0 }) {
+            std::cout << std::setw(9) << quantile * 100 << "%  "
+                      << to_ms(latency.value_at(quantile)) << "ms\n";
+        }
+    }
+
+    std::cout << "  " << total.responses << " requests in " << seconds << "s, "
+              << total.body_bytes << " body bytes, " << total.connects << " connects\n"
+              << "  errors " << total.errors << ", non-2xx " << total.non_2xx
+              << ", unfinished " << total.unfinished << '\n'
+              << "Requests/sec: " << static_cast<double>(total.responses) / seconds << '\n'
+              << "Transfer/sec: " << static_cast<double>(total.body_bytes) / seconds / 1024.0
+              << "KB (body)" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    auto opts = parse_options(argc, argv);
+    if (!opts) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [-c connections] [-t threads] [-d seconds] [-p pipeline] [-r rate]"
+                     " [-s server threads] [--close] [http://host:port/target]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    /// the server on the loopback interface unless given
+    beast_router::http_server_type::router_type router {};
+    beast_router::event_loop::event_loop_ptr_type server_loop;
+    beast_router::http_listener_type::listener_ptr_type listener;
+    std::thread server_thread;
+
+    if (opts->host.empty()) {
+        router.get(R"(^/.*$)", [](const auto& rq, auto& ctx) {
+            static const beast_router::prepared_response hello {
+                beast_router::make_string_response(http::status::ok, 11, "Hello World")
+            };
+            ctx.send(hello.keep_alive(rq.keep_alive()));
+            if (rq.keep_alive()) {
+                ctx.recv();
+            }
+        });
+
+        server_loop = beast_router::event_loop::create(opts->server_threads,
+            beast_router::event_loop::settings { beast_router::event_loop::topology::per_core });
+
+        beast_router::http_listener_type::on_error_type on_error = [](boost::system::error_code, std::string_view) {};
+        beast_router::http_listener_type::on_accept_type on_accept = [on_error, &router](beast_router::http_listener_type::socket_type socket) {
+            socket.set_option(net::ip::tcp::no_delay(true));
+            beast_router::http_server_type::recv(std::move(socket), router, on_error);
+        };
+
+        listener = beast_router::http_listener_type::launch(*server_loop,
+            { net::ip::address_v4::loopback(), 0 }, beast_router::reuse_port,
+            std::move(on_accept), beast_router::http_listener_type::on_error_type { on_error });
+
+        opts->host = "127.0.0.1";
+        opts->port = std::to_string(listener->local_endpoint().port());
+        server_thread = std::thread { [&server_loop]() { server_loop->exec(); } };
+    }
+
+    /// drive the load
+    auto client_loop = beast_router::event_loop::create(opts->threads,
+        beast_router::event_loop::settings { beast_router::event_loop::topology::per_core });
+
+    const auto start = clock_type::now();
+    const auto deadline = start + std::chrono::seconds { opts->seconds };
+    const auto interval = opts->rate > 0
+        ? std::chrono::duration_cast<clock_type::duration>(
+            std::chrono::duration<double> { opts->connections / opts->rate })
+        : clock_type::duration::zero();
+
+    std::vector<std::shared_ptr<driver>> drivers;
+    for (int idx = 0; idx < opts->connections; ++idx) {
+        /// the connections are spread over the threads and, in the fixed rate
+        /// mode, over the interval
+        auto& ioc = client_loop->get_context(static_cast<std::size_t>(idx) % client_loop->get_contexts());
+        drivers.push_back(std::make_shared<driver>(ioc, *opts,
+            start + interval * idx / opts->connections, deadline, interval));
+        drivers.back()->run();
+    }
+
+    std::thread client_thread { [&client_loop]() { client_loop->exec(); } };
+    std::this_thread::sleep_until(deadline);
+    client_loop->stop();
+    client_thread.join();
+    const auto elapsed = clock_type::now() - start;
+
+    if (listener) {
+        listener->close();
+        server_loop->stop();
+        server_thread.join();
+    }
+
+    /// report
+    report total;
+    for (const auto& drv : drivers) {
+        total.merge(drv->finish());
+    }
+    print_report(*opts, total, elapsed);
+
+    return total.responses != 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,168 @@
+#include "beast_router.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/// Loopback benchmark
+/**
+ * Serves a small response on the loopback interface and drives it by the
+ * given number of keep alive connections, each sending the requests one by
+ * one. Built twice when liburing is available: `loopback_bench` runs on the
+ * default reactor whereas `loopback_bench_uring` runs on io_uring.
+ *
+ * Usage: loopback_bench [connections=32] [seconds=5] [server threads=1]
+ */
+
+namespace net = boost::asio;
+namespace http = beast_router::http;
+
+using namespace std::chrono_literals;
+using clock_type = std::chrono::steady_clock;
+
+#if defined(BOOST_ASIO_HAS_IO_URING) && defined(BOOST_ASIO_DISABLE_EPOLL) && BOOST_VERSION >= 107800
+static constexpr std::string_view backend = "io_uring";
+#else
+static constexpr std::string_view backend = "epoll";
+#endif
+
+/// Sends the requests one by one and records the latencies
+class client : public std::enable_shared_from_this<client> {
+public:
+    client(net::io_context& ioc, net::ip::tcp::endpoint endpoint,
+        clock_type::time_point deadline)
+        : m_socket { ioc }
+        , m_endpoint { endpoint }
+        , m_deadline { deadline }
+        , m_request { beast_router::make_empty_request(http::verb::get, 11, "/") }
+    {
+    }
+
+    void run()
+    {
+        m_socket.async_connect(m_endpoint, [self = shared_from_this()](boost::system::error_code ec) {
+            if (!ec) {
+                self->m_socket.set_option(net::ip::tcp::no_delay(true));
+                self->do_write();
+            }
+        });
+    }
+
+    const std::vector<clock_type::duration>& latencies() const
+    {
+        return m_latencies;
+    }
+
+private:
+    void do_write()
+    {
+        m_start = clock_type::now();
+        if (m_start >= m_deadline) {
+            m_socket.close();
+            return;
+        }
+
+        http::async_write(m_socket, m_request,
+            [self = shared_from_this()](boost::system::error_code ec, std::size_t) {
+                if (!ec) {
+                    self->do_read();
+                }
+            });
+    }
+
+    void do_read()
+    {
+        m_response = {};
+        http::async_read(m_socket, m_buffer, m_response,
+            [self = shared_from_this()](boost::system::error_code ec, std::size_t) {
+                if (!ec) {
+                    self->m_latencies.push_back(clock_type::now() - self->m_start);
+                    self->do_write();
+                }
+            });
+    }
+
+    net::ip::tcp::socket m_socket;
+    net::ip::tcp::endpoint m_endpoint;
+    clock_type::time_point m_deadline;
+    clock_type::time_point m_start;
+    beast_router::http_empty_request m_request;
+    beast_router::http_string_response m_response;
+    boost::beast::flat_buffer m_buffer;
+    std::vector<clock_type::duration> m_latencies;
+};
+
+int main(int argc, char** argv)
+{
+    const auto connections = argc > 1 ? std::atoi(argv[1]) : 32;
+    const auto seconds = argc > 2 ? std::atoi(argv[2]) : 5;
+    const auto threads = argc > 3 ? static_cast<unsigned>(std::atoi(argv[3])) : 1u;
+
+    /// routing table
+    beast_router::http_server_type::router_type router {};
+    router.get(R"(^/$)", [](const auto& rq, auto& ctx) {
+        static const beast_router::prepared_response hello {
+            beast_router::make_string_response(http::status::ok, 11, "Hello World")
+        };
+        ctx.send(hello.keep_alive(rq.keep_alive()));
+        ctx.recv();
+    });
+
+    auto event_loop = beast_router::event_loop::create(threads,
+        beast_router::event_loop::settings { beast_router::event_loop::topology::per_core });
+
+    beast_router::http_listener_type::on_error_type on_error = [](boost::system::error_code, std::string_view) {};
+    beast_router::http_listener_type::on_accept_type on_accept = [&on_error, &router](beast_router::http_listener_type::socket_type socket) {
+        socket.set_option(net::ip::tcp::no_delay(true));
+        beast_router::http_server_type::recv(std::move(socket), router, on_error);
+    };
+
+    auto listener = beast_router::http_listener_type::launch(*event_loop,
+        { net::ip::address_v4::loopback(), 0 }, beast_router::reuse_port,
+        std::move(on_accept), beast_router::http_listener_type::on_error_type { on_error });
+
+    std::thread server_thread { [&event_loop]() { event_loop->exec(); } };
+
+    /// drive the load
+    net::io_context client_ioc { 1 };
+    const auto deadline = clock_type::now() + std::chrono::seconds { seconds };
+    std::vector<std::shared_ptr<client>> clients;
+    for (int i = 0; i < connections; ++i) {
+        clients.push_back(std::make_shared<client>(client_ioc, listener->local_endpoint(), deadline));
+        clients.back()->run();
+    }
+    client_ioc.run();
+
+    listener->close();
+    event_loop->stop();
+    server_thread.join();
+
+    /// report
+    std::vector<clock_type::duration> latencies;
+    for (const auto& clnt : clients) {
+        latencies.insert(latencies.end(), clnt->latencies().begin(), clnt->latencies().end());
+    }
+    if (latencies.empty()) {
+        std::cerr << "No responses received" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    const auto percentile = [&latencies](double pct) {
+        const auto idx = static_cast<std::size_t>(pct * static_cast<double>(latencies.size() - 1));
+        return std::chrono::duration_cast<std::chrono::microseconds>(latencies[idx]).count();
+    };
+
+    std::cout << "backend:     " << backend << '\n'
+              << "connections: " << connections << '\n'
+              << "requests:    " << latencies.size() << '\n'
+              << "req/s:       " << latencies.size() / static_cast<std::size_t>(std::max(seconds, 1)) << '\n'
+              << "p50 (us):    " << percentile(0.50) << '\n'
+              << "p99 (us):    " << percentile(0.99) << '\n'
+              << "p99.9 (us):  " << percentile(0.999) << std::endl;
+
+    return EXIT_SUCCESS;
+}
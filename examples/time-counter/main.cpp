@@ -2,9 +2,7 @@
 #include "config_ex.hpp"
 #include <chrono>
 #include <exception>
-#include <iomanip>
 #include <iostream>
-#include <sstream>
 #include <string_view>
 
 using namespace std::chrono_literals;
@@ -44,15 +42,19 @@ int main(int, char**)
         return ctx.send(std::move(rp));
     });
     router.get(R"(^/$)", [](const auto& rq, auto& ctx) {
-        ctx.send(beast_router::make_moved_response(rq.version(), "/index.html"));
+        // The redirection is serialized once and shared among the requests
+        static const beast_router::prepared_response moved {
+            beast_router::make_moved_response(11, "/index.html")
+        };
+        if (rq.version() != moved.version()) {
+            return ctx.send(beast_router::make_moved_response(rq.version(), "/index.html"));
+        }
+        ctx.send(moved.keep_alive(rq.keep_alive()));
     });
     router.get(R"(^/update$)", [](const auto& rq, auto& ctx) {
-        auto now = std::chrono::system_clock::now();
-        auto itt = std::chrono::system_clock::to_time_t(now);
-
-        std::stringstream i_str;
-        i_str << std::put_time(std::gmtime(&itt), "%FT%TZ");
-        ctx.send(beast_router::make_string_response(beast_router::http::status::ok, rq.version(), i_str.str()));
+        // The date is cached and refreshed by the event loop once a second
+        ctx.send(beast_router::make_string_response(beast_router::http::status::ok, rq.version(),
+            beast_router::http_date::now()));
     });
 
     /// Create event loop to serve the io context
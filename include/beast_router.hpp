@@ -1,7 +1,19 @@
 #pragma once
 
+#include "beast_router/common/admission_controller.hpp"
+#include "beast_router/common/connection_limiter.hpp"
+#include "beast_router/common/dns_cache.hpp"
 #include "beast_router/common/event_loop.hpp"
+#include "beast_router/common/http_date.hpp"
 #include "beast_router/common/http_utility.hpp"
+#include "beast_router/common/metrics.hpp"
+#include "beast_router/common/prepared_response.hpp"
+#include "beast_router/common/route_options.hpp"
+#include "beast_router/common/timeouts.hpp"
+#include "beast_router/common/timer_wheel.hpp"
+#include "beast_router/common/tracing.hpp"
+#include "beast_router/common/worker_pool.hpp"
+#include "beast_router/connection_pool.hpp"
 #include "beast_router/connector.hpp"
 #include "beast_router/listener.hpp"
 #include "beast_router/router.hpp"
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <boost/asio/detail/config.hpp>
 #include <boost/config.hpp>
 #include <boost/core/ignore_unused.hpp>
 #include <boost/noncopyable.hpp>
@@ -23,6 +24,12 @@
 #error The library requires C++17: a conforming compiler is needed
 #endif
 
+#if defined(BOOST_ASIO_HAS_CO_AWAIT)
+/// Defined if the C++20 coroutines are available i.e. the handlers may return
+/// `boost::asio::awaitable`
+#define ROUTER_HAS_CO_AWAIT 1
+#endif
+
 #define ROUTER_BASE_NAMESPACE_BEGIN() namespace beast_router::base {
 #define ROUTER_BASE_NAMESPACE_END() }
 #define ROUTER_NAMESPACE_BEGIN() namespace beast_router {
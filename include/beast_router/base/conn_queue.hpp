@@ -1,6 +1,7 @@
 #pragma once
 
 #include "config.hpp"
+#include <boost/system/error_code.hpp>
 #include <memory>
 #include <queue>
 #include <utility>
@@ -13,6 +14,7 @@ class conn_queue {
     struct wrk {
         virtual ~wrk() = default;
         virtual void operator()() = 0;
+        virtual void complete(boost::system::error_code, std::size_t) { }
     };
 
 public:
@@ -44,22 +46,85 @@ public:
             response_type m_response;
         };
 
-        m_items.push(
-            std::make_unique<wrk_impl>(m_impl, std::forward<Response>(rsp)));
+        push(std::make_unique<wrk_impl>(m_impl, std::forward<Response>(rsp)));
+    }
 
-        if (m_items.size() == 1) {
-            do_handle();
-        }
+    /// Enqueues a package along with a handler invoked once it is written
+    /**
+     * The equivalent function signature of the handler must be as the following:
+     * @code
+     * handler(boost::system::error_code ec, std::size_t bytes_transferred);
+     * @endcode
+     */
+    template <class Response, class Handler>
+    void operator()(Response&& rsp, Handler&& handler)
+    {
+        struct wrk_impl : wrk {
+            using response_type = std::decay_t<Response>;
+
+            using handler_type = std::decay_t<Handler>;
+
+            wrk_impl(impl_type& impl, Response&& rsp, Handler&& handler)
+                : m_impl { impl }
+                , m_response { std::forward<Response>(rsp) }
+                , m_handler { std::forward<Handler>(handler) }
+            {
+            }
+
+            void operator()() override { m_impl.do_write(m_response); }
+
+            void complete(boost::system::error_code ec,
+                std::size_t bytes_transferred) override
+            {
+                m_handler(ec, bytes_transferred);
+            }
+
+            impl_type& m_impl;
+            response_type m_response;
+            handler_type m_handler;
+        };
+
+        push(std::make_unique<wrk_impl>(m_impl, std::forward<Response>(rsp),
+            std::forward<Handler>(handler)));
     }
 
-    void on_write()
+    /// Completes the package being written and proceeds with the next one
+    /**
+     * @param ec The result of the write operation
+     * @param bytes_transferred The number of bytes written
+     * @param proceed Whether the next package has to be written
+     * @returns void
+     */
+    void on_write(boost::system::error_code ec = {},
+        std::size_t bytes_transferred = 0, bool proceed = true)
     {
+        BOOST_ASSERT(m_items.size());
+        wrk_ptr_type item = std::move(m_items.front());
         m_items.pop();
-        if (m_items.size()) {
+        if (proceed && m_items.size()) {
             do_handle();
         }
+        item->complete(ec, bytes_transferred);
+    }
+
+    /// Drops all the pending packages and completes them with the given error
+    /**
+     * @param ec The error code passed to the completion handlers
+     * @returns void
+     */
+    void cancel(boost::system::error_code ec)
+    {
+        std::queue<wrk_ptr_type> items;
+        std::swap(items, m_items);
+        while (items.size()) {
+            items.front()->complete(ec, 0);
+            items.pop();
+        }
     }
 
+    /// Returns the number of packages waiting to be written
+    std::size_t size() const { return m_items.size(); }
+
 protected:
     void do_handle()
     {
@@ -70,6 +135,15 @@ protected:
 private:
     using wrk_ptr_type = std::unique_ptr<wrk>;
 
+    void push(wrk_ptr_type&& item)
+    {
+        m_items.push(std::move(item));
+
+        if (m_items.size() == 1) {
+            do_handle();
+        }
+    }
+
     impl_type& m_impl;
     std::queue<wrk_ptr_type> m_items;
 };
@@ -0,0 +1,224 @@
+#pragma once
+
+#include "config.hpp"
+#include <algorithm>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/beast/core/bind_handler.hpp>
+#include <boost/system/error_code.hpp>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+ROUTER_BASE_NAMESPACE_BEGIN()
+
+/// The operation racing the connection attempts to the endpoints
+/**
+ * The attempts start one after another, each either once the previous one
+ * fails or once the delay expires, whichever is first. The first attempt to
+ * succeed wins, the rest are cancelled.
+ */
+template <class Socket, class Handler>
+class race_connect_op : public std::enable_shared_from_this<race_connect_op<Socket, Handler>> {
+public:
+    using endpoint_type = typename Socket::endpoint_type;
+
+    using duration_type = std::chrono::steady_clock::duration;
+
+    race_connect_op(Socket& socket, std::vector<endpoint_type>&& endpoints,
+        duration_type attempt_delay, duration_type attempt_timeout, Handler&& handler)
+        : m_socket { socket }
+        , m_strand { boost::asio::make_strand(socket.get_executor()) }
+        , m_endpoints { std::move(endpoints) }
+        , m_attempts {}
+        , m_delay { m_strand }
+        , m_attempt_delay { attempt_delay }
+        , m_attempt_timeout { attempt_timeout }
+        , m_pending { 0 }
+        , m_completed { false }
+        , m_error { boost::asio::error::host_not_found }
+        , m_handler { std::move(handler) }
+    {
+    }
+
+    void start()
+    {
+        boost::asio::dispatch(m_strand, [self = this->shared_from_this()]() {
+            self->do_attempt();
+        });
+    }
+
+private:
+    struct attempt {
+        Socket socket;
+        boost::asio::steady_timer timer;
+        bool timed_out;
+    };
+
+    void do_attempt()
+    {
+        if (m_completed) {
+            return;
+        }
+        if (m_attempts.size() == m_endpoints.size()) {
+            if (m_pending == 0) {
+                do_complete(m_error, endpoint_type {});
+            }
+            return;
+        }
+
+        const auto idx = m_attempts.size();
+        m_attempts.push_back(std::make_unique<attempt>(
+            attempt { Socket { m_socket.get_executor() }, boost::asio::steady_timer { m_strand }, false }));
+        ++m_pending;
+
+        auto& at = *m_attempts.back();
+        at.socket.async_connect(m_endpoints[idx],
+            boost::asio::bind_executor(m_strand,
+                [self = this->shared_from_this(), idx](boost::system::error_code ec) {
+                    self->on_connect(idx, ec);
+                }));
+
+        if (m_attempt_timeout != duration_type::zero()) {
+            at.timer.expires_after(m_attempt_timeout);
+            at.timer.async_wait([self = this->shared_from_this(), idx](boost::system::error_code ec) {
+                if (!ec) {
+                    self->on_timeout(idx);
+                }
+            });
+        }
+
+        /// the next attempt starts unless this one completes first
+        if (m_attempt_delay != duration_type::zero() && m_attempts.size() < m_endpoints.size()) {
+            m_delay.expires_after(m_attempt_delay);
+            m_delay.async_wait([self = this->shared_from_this()](boost::system::error_code ec) {
+                if (!ec) {
+                    self->do_attempt();
+                }
+            });
+        }
+    }
+
+    void on_timeout(std::size_t idx)
+    {
+        auto& at = *m_attempts[idx];
+        at.timed_out = true;
+
+        boost::system::error_code ignored;
+        at.socket.close(ignored);
+    }
+
+    void on_connect(std::size_t idx, boost::system::error_code ec)
+    {
+        auto& at = *m_attempts[idx];
+        at.timer.cancel();
+        --m_pending;
+
+        if (m_completed) {
+            return;
+        }
+
+        if (!ec) {
+            m_delay.cancel();
+            for (auto& other : m_attempts) {
+                if (other.get() != &at) {
+                    boost::system::error_code ignored;
+                    other->socket.close(ignored);
+                }
+            }
+
+            m_socket = std::move(at.socket);
+            do_complete(ec, m_endpoints[idx]);
+            return;
+        }
+
+        m_error = at.timed_out ? boost::asio::error::timed_out : ec;
+        m_delay.cancel();
+        do_attempt();
+    }
+
+    void do_complete(boost::system::error_code ec, endpoint_type endpoint)
+    {
+        m_completed = true;
+        const auto executor = boost::asio::get_associated_executor(m_handler, m_socket.get_executor());
+        boost::asio::dispatch(executor,
+            boost::beast::bind_front_handler(std::move(m_handler), ec, std::move(endpoint)));
+    }
+
+    Socket& m_socket;
+    boost::asio::strand<typename Socket::executor_type> m_strand;
+    const std::vector<endpoint_type> m_endpoints;
+    std::vector<std::unique_ptr<attempt>> m_attempts;
+    boost::asio::steady_timer m_delay;
+    const duration_type m_attempt_delay;
+    const duration_type m_attempt_timeout;
+    std::size_t m_pending;
+    bool m_completed;
+    boost::system::error_code m_error;
+    Handler m_handler;
+};
+
+/// Connects the socket to the first endpoint reachable in a race (RFC 8305)
+/**
+ * The endpoints are tried alternating the address families, starting with
+ * the family of the first one. A new attempt starts every `attempt_delay`
+ * while the previous ones are in progress; the attempts are made one after
+ * another if zero. The attempt not connected within `attempt_timeout` fails
+ * with `boost::asio::error::timed_out`; not limited if zero.
+ *
+ * @param socket The socket the winning connection is moved to
+ * @param endpoints The endpoints sequence
+ * @param attempt_delay The delay between the starts of the attempts
+ * @param attempt_timeout The time an attempt is given
+ * @param token The completion token of the `void(error_code, endpoint_type)`
+ * signature, as the one of `boost::asio::async_connect`
+ */
+template <class Socket, class EndpointSequence, class CompletionToken>
+auto async_race_connect(Socket& socket, const EndpointSequence& endpoints,
+    std::chrono::steady_clock::duration attempt_delay,
+    std::chrono::steady_clock::duration attempt_timeout, CompletionToken&& token)
+{
+    using endpoint_type = typename Socket::endpoint_type;
+
+    std::vector<endpoint_type> primary;
+    std::vector<endpoint_type> secondary;
+    for (const auto& entry : endpoints) {
+        const endpoint_type endpoint = entry;
+        if (primary.empty() || endpoint.protocol() == primary.front().protocol()) {
+            primary.push_back(endpoint);
+        } else {
+            secondary.push_back(endpoint);
+        }
+    }
+
+    std::vector<endpoint_type> ordered;
+    ordered.reserve(primary.size() + secondary.size());
+    for (std::size_t idx = 0; idx < std::max(primary.size(), secondary.size()); ++idx) {
+        if (idx < primary.size()) {
+            ordered.push_back(primary[idx]);
+        }
+        if (idx < secondary.size()) {
+            ordered.push_back(secondary[idx]);
+        }
+    }
+
+    auto initiation = [](auto handler, Socket* socket, std::vector<endpoint_type> endpoints,
+                          std::chrono::steady_clock::duration attempt_delay,
+                          std::chrono::steady_clock::duration attempt_timeout) {
+        std::make_shared<race_connect_op<Socket, decltype(handler)>>(*socket, std::move(endpoints),
+            attempt_delay, attempt_timeout, std::move(handler))
+            ->start();
+    };
+
+    return boost::asio::async_initiate<CompletionToken,
+        void(boost::system::error_code, endpoint_type)>(
+        std::move(initiation), token, &socket, std::move(ordered), attempt_delay, attempt_timeout);
+}
+
+ROUTER_BASE_NAMESPACE_END()
@@ -1,10 +1,13 @@
 #pragma once
 
 #include "config.hpp"
+#include "file_transfer.hpp"
 #include <boost/asio/bind_executor.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/connect.hpp>
 #include <boost/asio/socket_base.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/beast/core/read_size.hpp>
 #include <boost/beast/http/read.hpp>
 #include <boost/beast/http/write.hpp>
 
@@ -66,6 +69,56 @@ public:
     template <class Function, class Serializer>
     void async_write(Serializer& serializer, Function&& func);
 
+    /// Asynchronous partial writer
+    /**
+     * Writes some part of the message associated with the serializer
+     *
+     * @param serializer A reference to the serializer which is associated with
+     * the connection
+     * @param func A reference to the callback
+     * @returns void
+     */
+    template <class Function, class Serializer>
+    void async_write_some(Serializer& serializer, Function&& func);
+
+    /// Asynchronous header writer
+    /**
+     * Writes only the header part of the message associated with the serializer
+     *
+     * @param serializer A reference to the serializer which is associated with
+     * the connection
+     * @param func A reference to the callback
+     * @returns void
+     */
+    template <class Function, class Serializer>
+    void async_write_header(Serializer& serializer, Function&& func);
+
+    /// Asynchronous raw buffers writer
+    /**
+     * @param buffers A sequence of buffers to be written as is
+     * @param func A reference to the callback
+     * @returns void
+     */
+    template <class Function, class ConstBufferSequence>
+    void async_write_buffers(const ConstBufferSequence& buffers, Function&& func);
+
+#if defined(ROUTER_HAS_IO_URING)
+    /// Asynchronous file writer
+    /**
+     * Transfers the file content to the connection without blocking on the
+     * file reads
+     *
+     * @param file The file to be written, owned by the operation
+     * @param offset The starting offset within the file
+     * @param size The number of bytes to be written
+     * @param func A reference to the callback
+     * @returns void
+     */
+    template <class Function>
+    void async_write_file(boost::asio::random_access_file&& file,
+        std::uint64_t offset, std::uint64_t size, Function&& func);
+#endif
+
     /// Asynchronous reader
     /**
      * @param buffer A reference to the buffer associated with the connection
@@ -76,7 +129,39 @@ public:
     template <class Function, class Buffer, class Parser>
     void async_read(Buffer& buffer, Parser& parser, Function&& func);
 
+    /// Asynchronous partial reader
+    /**
+     * Reads and parses some part of the message
+     *
+     * @param buffer A reference to the buffer associated with the connection
+     * @param parser A reference to the parser associated with the connection
+     * @param func A reference to the callback
+     * @returns void
+     */
+    template <class Function, class Buffer, class Parser>
+    void async_read_some(Buffer& buffer, Parser& parser, Function&& func);
+
+    /// Asynchronous raw reader
+    /**
+     * Reads some data into the buffer as is; the handler commits the
+     * `bytes_transferred` to the buffer
+     *
+     * @param buffer A reference to the buffer associated with the connection
+     * @param func A reference to the callback
+     * @returns void
+     */
+    template <class Function, class Buffer>
+    void async_read_some(Buffer& buffer, Function&& func);
+
 protected:
+    /// Invokes the function with the stream the writes go to
+    /**
+     * @param func The function taking the stream
+     * @returns void
+     */
+    template <class Function>
+    void with_write_stream(Function&& func);
+
     const CompletionExecutor& m_completion_executor;
 };
 
@@ -1,13 +1,24 @@
 #pragma once
 
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/executor_work_guard.hpp>
 #include <boost/beast/http/message.hpp>
+#include <exception>
+#include <functional>
+#include <memory>
 #include <regex>
 #include <string_view>
 #include <type_traits>
 
+#include "../common/admission_controller.hpp"
+#include "../common/metrics.hpp"
+#include "../common/tracing.hpp"
 #include "../common/utility.hpp"
+#include "../common/worker_pool.hpp"
 #include "config.hpp"
 #include "lockable.hpp"
+#include "strand_stream.hpp"
 
 ROUTER_BASE_NAMESPACE_BEGIN()
 
@@ -33,12 +44,24 @@ public:
 
     using storage_type = typename router_type::storage_type;
 
-    explicit dispatcher(const router_type& router)
+    using on_error_type = std::function<void(boost::system::error_code, std::string_view)>;
+
+    explicit dispatcher(const router_type& router, on_error_type on_error = nullptr)
         : m_method_map { router.get_resource_map() }
         , m_mutex { router.get_mutex_pointer() }
+        , m_on_error { std::move(on_error) }
+        , m_admission { router.admission() }
+        , m_metrics { router.metrics() }
+        , m_route { nullptr }
     {
     }
 
+    /// Returns whether the requests are counted
+    bool instrumented() const { return m_metrics != nullptr; }
+
+    /// Returns the counters of the route the last request was dispatched to
+    route_metrics* route() const { return m_route.get(); }
+
     template <bool IsMessageRequest, class MessageBody, class Fields>
     typename std::enable_if_t<IsMessageRequest> do_process_request(
         boost::beast::http::message<IsMessageRequest, MessageBody, Fields>&& request,
@@ -54,24 +77,57 @@ public:
 
         LOCKABLE_ENTER_TO_READ(m_mutex);
 
-        std::string_view target = request.target();
+        using message_type = boost::beast::http::message<IsMessageRequest, MessageBody, Fields>;
+
+        const std::string target_string { request.target() };
         method_type method = request.method();
         bool is_handled = false;
+        bool is_shed = false;
+        m_route.reset();
+
+        // the queueing delay is counted from the request being read
+        const auto received = m_admission ? admission_controller::clock_type::now()
+                                          : admission_controller::clock_type::time_point {};
+
+        // The offloaded chains share the request which outlives the call
+        std::shared_ptr<const message_type> shared_request;
+        const auto get_request = [&]() -> const message_type& {
+            return shared_request ? *shared_request : request;
+        };
 
         // Handle a method by checking if a handler was assigned in the resource map
         if (const auto method_pos = m_method_map->find(method);
             method_pos != m_method_map->cend()) {
             auto& resource_map = method_pos->second;
             std::for_each(resource_map.begin(), resource_map.end(), [&](auto& val) {
-                const std::regex re { val.first };
-                const std::string target_string { target };
                 std::smatch base_match;
-                if (std::regex_match(target_string, base_match, re)) {
-                    if (const_cast<storage_type&>(val.second)
-                            .begin_execute(request, context_type { impl },
-                                std::move(base_match))) {
-                        is_handled = true;
+                if (is_shed || !std::regex_match(target_string, base_match, val.second.regex())) {
+                    return;
+                }
+
+                do_count(val.second);
+
+                if (m_admission && !is_handled && !m_admission->admit(val.second.options().priority)) {
+                    do_shed(get_request(), impl);
+                    is_handled = is_shed = true;
+                    return;
+                }
+
+                if (val.second.options().offload) {
+                    if (!shared_request) {
+                        shared_request = std::make_shared<const message_type>(std::move(request));
                     }
+                    do_offload(*val.second.options().offload, val.second,
+                        shared_request, impl);
+                    is_handled = true;
+                    return;
+                }
+
+                if (m_admission) {
+                    m_admission->record(admission_controller::clock_type::now() - received);
+                }
+                if (do_execute(val.second, get_request(), impl, std::move(base_match))) {
+                    is_handled = true;
                 }
             });
         }
@@ -83,8 +139,8 @@ public:
             auto& resource_map = not_found->second;
             if (const auto storage = resource_map.find("");
                 storage != resource_map.cend()) {
-                const_cast<storage_type&>(storage->second)
-                    .begin_execute(request, context_type { impl }, {});
+                do_count(storage->second);
+                do_execute(storage->second, get_request(), impl, {});
             }
         }
     }
@@ -107,16 +163,126 @@ public:
         const auto not_found = m_method_map->find(method_type::unknown);
         ROUTER_ASSUME((not_found != m_method_map->cend()));
         auto& resource_map = not_found->second;
+        m_route.reset();
         if (const auto storage = resource_map.find("");
             storage != resource_map.cend()) {
-            const_cast<storage_type&>(storage->second)
-                .begin_execute(request, context_type { impl }, {});
+            do_count(storage->second);
+            do_execute(storage->second, request, impl, {});
         }
     }
 
 private:
+    /// Counts the request of the route
+    void do_count(const storage_type& storage)
+    {
+        if (m_metrics) {
+            m_route = storage.metrics();
+            if (m_route) {
+                m_route->request();
+            }
+        }
+    }
+
+    /// Runs the chain of the route inline
+    template <class Message>
+    bool do_execute(const storage_type& storage, const Message& request, impl_type& impl,
+        std::smatch&& match)
+    {
+        do_trace(impl, trace_point::route);
+
+        // the route is counted right before
+        auto* const route = m_route.get();
+        const auto started = route ? route_metrics::clock_type::now()
+                                   : route_metrics::clock_type::time_point {};
+        const auto result = const_cast<storage_type&>(storage).begin_execute(request,
+            context_type { impl }, std::move(match));
+        if (route) {
+            route->handled(route_metrics::clock_type::now() - started);
+        }
+
+        do_trace(impl, trace_point::handler);
+        return result;
+    }
+
+    /// Reports the point to the tracer of the session
+    static void do_trace([[maybe_unused]] impl_type& impl, [[maybe_unused]] trace_point point)
+    {
+        if constexpr (utility::is_traced_v<session_type>) {
+            impl.trace(point);
+        }
+    }
+
+    /// Responds the request shed by the admission controller
+    /**
+     * The connection keeps serving the next requests if it is kept alive
+     */
+    template <class Message>
+    void do_shed(const Message& request, impl_type& impl)
+    {
+        do_trace(impl, trace_point::route);
+
+        context_type ctx { impl };
+        ctx.send(m_admission->response().keep_alive(request.keep_alive()));
+        if (request.keep_alive()) {
+            ctx.recv();
+        }
+    }
+
+    /// Runs the chain of the route on the offload pool
+    /**
+     * The task owns a copy of the storage taken under the read lock of the
+     * dispatcher, so the blocking chain does not hold the router lock. The
+     * work guard keeps the io context of the session running until the chain
+     * completes; an exception thrown by the chain is reported by `on_error`
+     */
+    template <class Message>
+    void do_offload(worker_pool& pool, const storage_type& storage,
+        std::shared_ptr<const Message> request, impl_type& impl)
+    {
+        do_trace(impl, trace_point::route);
+
+        // the dispatcher is owned by the session which the task keeps alive
+        pool.post([storage = storage, request = std::move(request), impl = impl.shared_from_this(),
+                      on_error = &m_on_error, admission = m_admission,
+                      queued = admission_controller::clock_type::now(),
+                      work = boost::asio::make_work_guard(static_cast<strand_stream::asio_type&>(impl))]() mutable {
+            // the time spent in the queue of the pool
+            if (admission) {
+                admission->record(admission_controller::clock_type::now() - queued);
+            }
+
+            const std::string target_string { request->target() };
+            std::smatch base_match;
+            if (!std::regex_match(target_string, base_match, storage.regex())) {
+                return;
+            }
+
+            try {
+                const auto started = route_metrics::clock_type::now();
+                storage.begin_execute(*request, context_type { *impl }, std::move(base_match));
+                const auto finished = route_metrics::clock_type::now();
+                if (const auto& route = storage.metrics()) {
+                    route->handled(finished - started);
+                }
+                if constexpr (utility::is_traced_v<session_type>) {
+                    boost::asio::dispatch(static_cast<strand_stream::asio_type&>(*impl),
+                        [impl, finished]() { impl->trace(trace_point::handler, finished); });
+                }
+            } catch (const std::exception& ex) {
+                if (*on_error) {
+                    const std::string msg { std::string { "offload/" } + ex.what() };
+                    (*on_error)(boost::asio::error::operation_aborted, msg);
+                }
+            }
+        });
+    }
+
     method_const_map_pointer m_method_map;
     mutex_pointer_type m_mutex;
+    on_error_type m_on_error;
+    std::shared_ptr<admission_controller> m_admission;
+    std::shared_ptr<metrics_registry> m_metrics;
+    std::shared_ptr<route_metrics> m_route;
 };
 
 ROUTER_BASE_NAMESPACE_END()
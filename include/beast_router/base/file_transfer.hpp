@@ -0,0 +1,231 @@
+#pragma once
+
+#include "config.hpp"
+#include <boost/asio/detail/config.hpp>
+
+#if defined(BOOST_ASIO_HAS_IO_URING) && defined(BOOST_ASIO_HAS_FILE)
+
+/// Defined if the io_uring backend is enabled i.e. the sockets and files are
+/// served by io_uring
+#define ROUTER_HAS_IO_URING 1
+
+#include <algorithm>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/random_access_file.hpp>
+#include <boost/asio/write.hpp>
+#include <cstdint>
+#include <memory>
+
+ROUTER_BASE_NAMESPACE_BEGIN()
+
+/// The file to stream transfer operation
+/**
+ * Reads the file by chunks with positional reads and writes every chunk to
+ * the stream. With the io_uring backend both the reads and the writes are
+ * submitted to the ring, i.e. the file reading never blocks the io thread.
+ */
+template <class AsyncWriteStream>
+class transfer_file_op : public boost::asio::coroutine {
+public:
+    /// The size of the chunk read at once
+    static constexpr std::size_t chunk_size = 64 * 1024;
+
+    /// Constructor
+    transfer_file_op(AsyncWriteStream& stream, boost::asio::random_access_file&& file,
+        std::uint64_t offset, std::uint64_t size)
+        : m_stream { stream }
+        , m_file { std::make_unique<boost::asio::random_access_file>(std::move(file)) }
+        , m_buffer { std::make_unique<char[]>(chunk_size) }
+        , m_offset { offset }
+        , m_remain { size }
+        , m_total { 0 }
+    {
+    }
+
+    template <class Self>
+    void operator()(Self& self, boost::system::error_code ec = {}, std::size_t bytes = 0)
+    {
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            while (m_remain) {
+                BOOST_ASIO_CORO_YIELD m_file->async_read_some_at(m_offset,
+                    boost::asio::buffer(m_buffer.get(),
+                        static_cast<std::size_t>(std::min<std::uint64_t>(chunk_size, m_remain))),
+                    std::move(self));
+                if (ec) {
+                    break;
+                }
+
+                m_offset += bytes;
+                m_remain -= bytes;
+
+                BOOST_ASIO_CORO_YIELD boost::asio::async_write(m_stream,
+                    boost::asio::buffer(m_buffer.get(), bytes), std::move(self));
+                if (ec) {
+                    break;
+                }
+
+                m_total += bytes;
+            }
+
+            self.complete(ec, m_total);
+        }
+    }
+
+private:
+    AsyncWriteStream& m_stream;
+    std::unique_ptr<boost::asio::random_access_file> m_file;
+    std::unique_ptr<char[]> m_buffer;
+    std::uint64_t m_offset;
+    std::uint64_t m_remain;
+    std::size_t m_total;
+};
+
+/// Transfers the file content to the stream asynchronously
+/**
+ * @param stream The stream to write to
+ * @param file The file to read from, owned by the operation
+ * @param offset The starting offset within the file
+ * @param size The number of bytes to be transferred
+ * @param token The completion token of the `void(error_code, std::size_t)`
+ * signature
+ */
+template <class AsyncWriteStream, class CompletionToken>
+auto async_transfer_file(AsyncWriteStream& stream, boost::asio::random_access_file&& file,
+    std::uint64_t offset, std::uint64_t size, CompletionToken&& token)
+{
+    return boost::asio::async_compose<CompletionToken,
+        void(boost::system::error_code, std::size_t)>(
+        transfer_file_op<AsyncWriteStream> { stream, std::move(file), offset, size },
+        token, stream);
+}
+
+ROUTER_BASE_NAMESPACE_END()
+
+#endif
+
+#if defined(__linux__)
+
+/// Defined if the files may be sent by `sendfile` i.e. copied to the socket
+/// within the kernel
+#define ROUTER_HAS_SENDFILE 1
+
+#include <algorithm>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/socket_base.hpp>
+#include <cerrno>
+#include <cstdint>
+#include <sys/sendfile.h>
+
+ROUTER_BASE_NAMESPACE_BEGIN()
+
+/// The file to socket transfer operation
+/**
+ * Sends the file by `sendfile` as long as the socket accepts the data and
+ * waits for the socket to be writable otherwise.
+ */
+template <class Socket>
+class sendfile_op : public boost::asio::coroutine {
+public:
+    /// The size of the chunk sent at once
+    static constexpr std::size_t chunk_size = 1024 * 1024;
+
+    /// Constructor
+    sendfile_op(Socket& socket, int fd, std::uint64_t offset, std::uint64_t size)
+        : m_socket { socket }
+        , m_fd { fd }
+        , m_offset { static_cast<off_t>(offset) }
+        , m_remain { size }
+        , m_total { 0 }
+        , m_error {}
+        , m_yielded { false }
+    {
+    }
+
+    template <class Self>
+    void operator()(Self& self, boost::system::error_code ec = {})
+    {
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            m_socket.native_non_blocking(true, m_error);
+            while (!m_error && m_remain) {
+                if (do_send()) {
+                    continue;
+                }
+                if (m_error) {
+                    break;
+                }
+
+                BOOST_ASIO_CORO_YIELD m_socket.async_wait(
+                    boost::asio::socket_base::wait_write, std::move(self));
+                m_yielded = true;
+                m_error = ec;
+            }
+
+            // the handler is not invoked within the initiation
+            if (!m_yielded) {
+                BOOST_ASIO_CORO_YIELD boost::asio::post(
+                    m_socket.get_executor(), std::move(self));
+            }
+            self.complete(m_error, m_total);
+        }
+    }
+
+private:
+    /// Returns false if the socket is to be waited for or on error
+    bool do_send()
+    {
+        const auto count = static_cast<std::size_t>(
+            std::min<std::uint64_t>(chunk_size, m_remain));
+        const auto sent = ::sendfile(m_socket.native_handle(), m_fd, &m_offset, count);
+        if (sent > 0) {
+            m_remain -= static_cast<std::uint64_t>(sent);
+            m_total += static_cast<std::size_t>(sent);
+            return true;
+        }
+
+        if (sent == 0) {
+            // the file is shorter than expected
+            m_error = boost::asio::error::eof;
+        } else if (errno == EINTR) {
+            return true;
+        } else if (errno != EAGAIN) {
+            m_error.assign(errno, boost::system::system_category());
+        }
+        return false;
+    }
+
+    Socket& m_socket;
+    int m_fd;
+    off_t m_offset;
+    std::uint64_t m_remain;
+    std::size_t m_total;
+    boost::system::error_code m_error;
+    bool m_yielded;
+};
+
+/// Sends the file content to the socket asynchronously
+/**
+ * @param socket The socket to write to
+ * @param fd The file to read from, not owned by the operation
+ * @param offset The starting offset within the file
+ * @param size The number of bytes to be sent
+ * @param token The completion token of the `void(error_code, std::size_t)`
+ * signature
+ */
+template <class Socket, class CompletionToken>
+auto async_sendfile(Socket& socket, int fd, std::uint64_t offset, std::uint64_t size,
+    CompletionToken&& token)
+{
+    return boost::asio::async_compose<CompletionToken,
+        void(boost::system::error_code, std::size_t)>(
+        sendfile_op<Socket> { socket, fd, offset, size }, token, socket);
+}
+
+ROUTER_BASE_NAMESPACE_END()
+
+#endif
@@ -43,10 +43,93 @@ void connection<BASE_CONNECTION_TEMPLATE_ATTRIBUTES>::async_write(
         std::is_invocable_v<Function, boost::system::error_code, size_t>,
         "connection::async_write/Function requirements are not met");
 
-    boost::beast::http::async_write(
-        derived().stream(), serializer,
-        boost::asio::bind_executor(m_completion_executor,
-            std::forward<Function>(func)));
+    derived().with_write_stream([&](auto& stream) {
+        boost::beast::http::async_write(
+            stream, serializer,
+            boost::asio::bind_executor(m_completion_executor,
+                std::forward<Function>(func)));
+    });
+}
+
+BASE_CONNECTION_TEMPLATE_DECLARE
+template <class Function, class Serializer>
+void connection<BASE_CONNECTION_TEMPLATE_ATTRIBUTES>::async_write_some(
+    Serializer& serializer, Function&& func)
+{
+    static_assert(
+        std::is_invocable_v<Function, boost::system::error_code, size_t>,
+        "connection::async_write_some/Function requirements are not met");
+
+    derived().with_write_stream([&](auto& stream) {
+        boost::beast::http::async_write_some(
+            stream, serializer,
+            boost::asio::bind_executor(m_completion_executor,
+                std::forward<Function>(func)));
+    });
+}
+
+BASE_CONNECTION_TEMPLATE_DECLARE
+template <class Function, class Serializer>
+void connection<BASE_CONNECTION_TEMPLATE_ATTRIBUTES>::async_write_header(
+    Serializer& serializer, Function&& func)
+{
+    static_assert(
+        std::is_invocable_v<Function, boost::system::error_code, size_t>,
+        "connection::async_write_header/Function requirements are not met");
+
+    derived().with_write_stream([&](auto& stream) {
+        boost::beast::http::async_write_header(
+            stream, serializer,
+            boost::asio::bind_executor(m_completion_executor,
+                std::forward<Function>(func)));
+    });
+}
+
+BASE_CONNECTION_TEMPLATE_DECLARE
+template <class Function, class ConstBufferSequence>
+void connection<BASE_CONNECTION_TEMPLATE_ATTRIBUTES>::async_write_buffers(
+    const ConstBufferSequence& buffers, Function&& func)
+{
+    static_assert(
+        utility::is_all_true_v<
+            std::is_invocable_v<Function, boost::system::error_code, size_t>,
+            boost::asio::is_const_buffer_sequence<ConstBufferSequence>::value>,
+        "connection::async_write_buffers requirements are not met");
+
+    derived().with_write_stream([&](auto& stream) {
+        boost::asio::async_write(
+            stream, buffers,
+            boost::asio::bind_executor(m_completion_executor,
+                std::forward<Function>(func)));
+    });
+}
+
+#if defined(ROUTER_HAS_IO_URING)
+BASE_CONNECTION_TEMPLATE_DECLARE
+template <class Function>
+void connection<BASE_CONNECTION_TEMPLATE_ATTRIBUTES>::async_write_file(
+    boost::asio::random_access_file&& file, std::uint64_t offset,
+    std::uint64_t size, Function&& func)
+{
+    static_assert(
+        std::is_invocable_v<Function, boost::system::error_code, size_t>,
+        "connection::async_write_file/Function requirements are not met");
+
+    derived().with_write_stream([&](auto& stream) {
+        async_transfer_file(
+            stream, std::move(file), offset, size,
+            boost::asio::bind_executor(m_completion_executor,
+                std::forward<Function>(func)));
+    });
+}
+#endif
+
+BASE_CONNECTION_TEMPLATE_DECLARE
+template <class Function>
+void connection<BASE_CONNECTION_TEMPLATE_ATTRIBUTES>::with_write_stream(
+    Function&& func)
+{
+    func(derived().stream());
 }
 
 BASE_CONNECTION_TEMPLATE_DECLARE
@@ -66,4 +149,38 @@ void connection<BASE_CONNECTION_TEMPLATE_ATTRIBUTES>::async_read(
             std::forward<Function>(func)));
 }
 
+BASE_CONNECTION_TEMPLATE_DECLARE
+template <class Function, class Buffer, class Parser>
+void connection<BASE_CONNECTION_TEMPLATE_ATTRIBUTES>::async_read_some(
+    Buffer& buffer, Parser& parser, Function&& func)
+{
+    static_assert(
+        utility::is_all_true_v<
+            std::is_invocable_v<Function, boost::system::error_code, size_t>,
+            boost::asio::is_dynamic_buffer<Buffer>::value>,
+        "connection::async_read_some requirements are not met");
+
+    boost::beast::http::async_read_some(
+        derived().stream(), buffer, parser,
+        boost::asio::bind_executor(m_completion_executor,
+            std::forward<Function>(func)));
+}
+
+BASE_CONNECTION_TEMPLATE_DECLARE
+template <class Function, class Buffer>
+void connection<BASE_CONNECTION_TEMPLATE_ATTRIBUTES>::async_read_some(
+    Buffer& buffer, Function&& func)
+{
+    static_assert(
+        utility::is_all_true_v<
+            std::is_invocable_v<Function, boost::system::error_code, size_t>,
+            boost::asio::is_dynamic_buffer<Buffer>::value>,
+        "connection::async_read_some requirements are not met");
+
+    derived().stream().async_read_some(
+        buffer.prepare(boost::beast::read_size(buffer, 65536)),
+        boost::asio::bind_executor(m_completion_executor,
+            std::forward<Function>(func)));
+}
+
 ROUTER_BASE_NAMESPACE_END()
\ No newline at end of file
@@ -1,15 +1,31 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <regex>
 #include <vector>
 
+#include "../common/metrics.hpp"
+#include "../common/route_options.hpp"
 #include "../common/utility.hpp"
 #include "config.hpp"
 
+#if defined(ROUTER_HAS_CO_AWAIT)
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <exception>
+#endif
+
 ROUTER_BASE_NAMESPACE_BEGIN()
 
 /// Encapsulates and stores callbacks associated with resources
+/**
+ * The callbacks are executed one by one on the io thread. With the C++20
+ * coroutines available, a callback may return `boost::asio::awaitable<bool>`
+ * or `boost::asio::awaitable<void>`; the chain is then resumed on the session
+ * strand starting from the first awaitable callback. The coroutine owns a
+ * copy of the request along with the context which keeps the session alive.
+ */
 template <class Session>
 class storage {
     struct callback;
@@ -23,13 +39,14 @@ public:
 
     using context_type = typename session_type::context_type;
 
-    using container_type = std::vector<std::unique_ptr<callback>>;
+    using container_type = std::vector<std::shared_ptr<callback>>;
 
     storage() = default;
 
-    storage(const storage&) = delete;
+    /// The copies share the callbacks
+    storage(const storage&) = default;
 
-    self_type& operator=(const storage&) = delete;
+    self_type& operator=(const storage&) = default;
 
     storage(storage&&) = default;
 
@@ -50,6 +67,9 @@ public:
         = true>
     storage(OnRequest&&... on_request)
         : m_clbs {}
+        , m_options {}
+        , m_regex {}
+        , m_metrics {}
     {
         auto tuple = std::make_tuple(std::forward<OnRequest>(on_request)...);
         constexpr auto size = std::tuple_size<decltype(tuple)>::value;
@@ -60,8 +80,7 @@ public:
             utility::tuple_func_idx(
                 idx, tuple, std::make_index_sequence<size> {},
                 [&](auto&& entry) -> bool {
-                    m_clbs.push_back(
-                        std::make_unique<callback_impl<decltype(entry)>>(entry));
+                    m_clbs.push_back(make_callback<decltype(entry)>(entry));
                     return true;
                 });
         }
@@ -69,10 +88,32 @@ public:
 
     size_t size() const { return m_clbs.size(); }
 
+    const route_options& options() const { return m_options; }
+
+    void options(route_options options) { m_options = std::move(options); }
+
+    const std::regex& regex() const
+    {
+        BOOST_ASSERT(m_regex);
+        return *m_regex;
+    }
+
+    void regex(const std::string& path) { m_regex = std::make_shared<const std::regex>(path); }
+
+    const std::shared_ptr<route_metrics>& metrics() const { return m_metrics; }
+
+    void metrics(std::shared_ptr<route_metrics> metrics) { m_metrics = std::move(metrics); }
+
     bool begin_execute(const message_type& request, context_type&& ctx,
         std::smatch&& match)
     {
         for (size_t idx = 0; idx < m_clbs.size(); ++idx) {
+#if defined(ROUTER_HAS_CO_AWAIT)
+            if (m_clbs[idx]->is_awaitable()) {
+                do_spawn(idx, request, std::move(ctx));
+                return true;
+            }
+#endif
             if (!(*m_clbs[idx])(request, ctx, match)) {
                 return false;
             }
@@ -81,11 +122,40 @@ public:
     }
 
 private:
+    template <class Func>
+    static decltype(auto) invoke(Func& func, const message_type& request,
+        context_type& ctx, const std::smatch& match)
+    {
+        if constexpr (std::is_invocable_v<Func&, const message_type&, context_type&,
+                          const std::smatch&>) {
+            return func(request, ctx, match);
+        } else if constexpr (std::is_invocable_v<Func&, const message_type&, context_type&>) {
+            return func(request, ctx);
+        } else {
+            return func(ctx);
+        }
+    }
+
+    template <class Func>
+    using invoke_result_t = decltype(invoke(std::declval<std::decay_t<Func>&>(),
+        std::declval<const message_type&>(), std::declval<context_type&>(),
+        std::declval<const std::smatch&>()));
+
     struct callback {
         virtual ~callback() = default;
         virtual bool operator()(const message_type&, context_type&,
             const std::smatch&)
             = 0;
+
+#if defined(ROUTER_HAS_CO_AWAIT)
+        virtual bool is_awaitable() const { return false; }
+
+        virtual boost::asio::awaitable<bool> async_call(const message_type& request,
+            context_type& ctx, const std::smatch& match)
+        {
+            co_return (*this)(request, ctx, match);
+        }
+#endif
     };
 
     template <class Func>
@@ -141,7 +211,115 @@ private:
             m_func;
     };
 
+#if defined(ROUTER_HAS_CO_AWAIT)
+    template <class T>
+    struct is_awaitable : std::false_type { };
+
+    template <class T, class Executor>
+    struct is_awaitable<boost::asio::awaitable<T, Executor>> : std::true_type { };
+
+    template <class T>
+    static constexpr bool is_awaitable_v = is_awaitable<T>::value;
+
+    template <class Func>
+    struct awaitable_callback_impl : callback {
+        using func_type = std::decay_t<Func>;
+
+        using return_type = typename invoke_result_t<Func>::value_type;
+
+        static_assert(std::is_same_v<return_type, bool> || std::is_void_v<return_type>,
+            "awaitable_callback_impl requirements are not met");
+
+        static_assert(std::is_copy_constructible_v<message_type>,
+            "awaitable handlers require the copyable message_type");
+
+        awaitable_callback_impl(Func&& func)
+            : m_func { std::forward<Func>(func) }
+        {
+        }
+
+        bool operator()(const message_type&, context_type&, const std::smatch&) override
+        {
+            BOOST_ASSERT_MSG(false, "awaitable callbacks are called by async_call()");
+            return false;
+        }
+
+        bool is_awaitable() const override { return true; }
+
+        boost::asio::awaitable<bool> async_call(const message_type& request,
+            context_type& ctx, const std::smatch& match) override
+        {
+            if constexpr (std::is_same_v<return_type, bool>) {
+                co_return co_await invoke(m_func, request, ctx, match);
+            } else {
+                co_await invoke(m_func, request, ctx, match);
+                co_return true;
+            }
+        }
+
+        func_type m_func;
+    };
+
+    void do_spawn(std::size_t idx, const message_type& request, context_type&& ctx)
+    {
+        if constexpr (std::is_copy_constructible_v<message_type>) {
+            const auto executor = ctx.get_executor();
+            boost::asio::co_spawn(executor,
+                do_resume(container_type { m_clbs.begin() + static_cast<std::ptrdiff_t>(idx), m_clbs.end() },
+                    request, std::move(ctx), m_regex),
+                [](std::exception_ptr ex) {
+                    if (ex) {
+                        std::rethrow_exception(ex);
+                    }
+                });
+        }
+    }
+
+    static boost::asio::awaitable<void> do_resume(container_type clbs,
+        message_type request, context_type ctx, std::shared_ptr<const std::regex> re)
+    {
+        // the match refers to the target owned by the coroutine
+        std::string target;
+        std::smatch match;
+        if constexpr (message_type::is_request::value) {
+            target = std::string { request.target() };
+            if (re) {
+                std::regex_match(target, match, *re);
+            }
+        }
+
+        for (auto& clb : clbs) {
+            bool proceed = true;
+            if (clb->is_awaitable()) {
+                proceed = co_await clb->async_call(request, ctx, match);
+            } else {
+                proceed = (*clb)(request, ctx, match);
+            }
+
+            if (!proceed) {
+                break;
+            }
+        }
+    }
+#endif
+
+    template <class Func>
+    static std::shared_ptr<callback> make_callback(Func&& func)
+    {
+#if defined(ROUTER_HAS_CO_AWAIT)
+        if constexpr (is_awaitable_v<invoke_result_t<Func>>) {
+            return std::make_shared<awaitable_callback_impl<Func>>(std::forward<Func>(func));
+        } else
+#endif
+        {
+            return std::make_shared<callback_impl<Func>>(std::forward<Func>(func));
+        }
+    }
+
     container_type m_clbs;
+    route_options m_options;
+    std::shared_ptr<const std::regex> m_regex;
+    std::shared_ptr<route_metrics> m_metrics;
 };
 
 ROUTER_BASE_NAMESPACE_END()
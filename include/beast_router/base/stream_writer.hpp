@@ -0,0 +1,316 @@
+#pragma once
+
+#include "config.hpp"
+#include <array>
+#include <atomic>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/beast/http/empty_body.hpp>
+#include <boost/beast/http/message.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "strand_stream.hpp"
+
+ROUTER_BASE_NAMESPACE_BEGIN()
+
+/// The header of a streamed response
+struct stream_head {
+    boost::beast::http::response<boost::beast::http::empty_body> message;
+};
+
+/// The chunk of a streamed response body
+/**
+ * Holds the payload along with the chunk framing. An empty payload denotes
+ * the terminating chunk.
+ */
+class stream_chunk {
+public:
+    /// The buffers type used for writing
+    using buffers_type = std::array<boost::asio::const_buffer, 3>;
+
+    /// Constructor
+    stream_chunk(std::string&& data, bool chunked, bool need_eof = false)
+        : m_data { std::move(data) }
+        , m_size {}
+        , m_size_len { 0 }
+        , m_chunked { chunked }
+        , m_need_eof { need_eof }
+    {
+        if (!m_chunked) {
+            return;
+        }
+
+        static constexpr char digits[] = "0123456789abcdef";
+        std::array<char, sizeof(std::size_t) * 2> hex {};
+        std::size_t size = m_data.size();
+        std::size_t len = 0;
+        do {
+            hex[len++] = digits[size & 0xf];
+            size >>= 4;
+        } while (size);
+
+        while (len) {
+            m_size[m_size_len++] = hex[--len];
+        }
+        m_size[m_size_len++] = '\r';
+        m_size[m_size_len++] = '\n';
+    }
+
+    /// Returns true if the chunk terminates the body
+    bool is_last() const { return m_data.empty(); }
+
+    /// Returns true if the connection has to be closed after the chunk
+    bool need_eof() const { return m_need_eof; }
+
+    /// Returns the payload size
+    std::size_t size() const { return m_data.size(); }
+
+    /// Returns the framed buffers to be written
+    buffers_type buffers() const
+    {
+        static constexpr std::string_view crlf = "\r\n";
+
+        if (!m_chunked) {
+            return { boost::asio::buffer(m_data), boost::asio::const_buffer {},
+                boost::asio::const_buffer {} };
+        }
+
+        if (is_last()) {
+            return { boost::asio::buffer(m_size.data(), m_size_len),
+                boost::asio::buffer(crlf.data(), crlf.size()),
+                boost::asio::const_buffer {} };
+        }
+
+        return { boost::asio::buffer(m_size.data(), m_size_len),
+            boost::asio::buffer(m_data),
+            boost::asio::buffer(crlf.data(), crlf.size()) };
+    }
+
+private:
+    std::string m_data;
+    std::array<char, sizeof(std::size_t) * 2 + 2> m_size;
+    std::size_t m_size_len;
+    bool m_chunked;
+    bool m_need_eof;
+};
+
+/// Streams a response body incrementally through the session
+/**
+ * The header is sent right away; the body is sent piece by piece either as
+ * plain chunks (chunked transfer encoding) or as server-sent events. All the
+ * pieces go through the session's connection queue, hence the writer
+ * respects the pending writes: once the amount of queued bytes reaches the
+ * high watermark @ref write() returns false and the `on_drain` callback is
+ * invoked as soon as the queue is drained down to the half of the watermark.
+ *
+ * The writer is cheap to copy and may be used from any thread.
+ *
+ * @note HTTP/1.0 peers receive the raw body and the connection is closed
+ * once the writer is closed
+ */
+template <class Impl>
+class stream_writer {
+public:
+    /// The self type
+    using self_type = stream_writer<Impl>;
+
+    /// The impl type
+    using impl_type = Impl;
+
+    /// The drain callback type
+    using on_drain_type = std::function<void()>;
+
+    /// The header type
+    using header_type = boost::beast::http::response<boost::beast::http::empty_body>;
+
+    /// The default high watermark of pending bytes
+    static constexpr std::size_t default_high_watermark = 64 * 1024;
+
+    /// Constructor
+    /**
+     * Enqueues the header to be sent right away
+     *
+     * @param impl A reference to the session
+     * @param header The response header
+     * @param high_watermark The number of pending bytes which triggers the
+     * backpressure
+     */
+    stream_writer(impl_type& impl, header_type&& header,
+        std::size_t high_watermark = default_high_watermark)
+        : m_state { std::make_shared<state>(impl, high_watermark) }
+    {
+        m_state->chunked = header.version() >= 11;
+        m_state->need_eof = !m_state->chunked || !header.keep_alive();
+
+        header.chunked(m_state->chunked);
+        if (!m_state->chunked) {
+            header.keep_alive(false);
+        }
+
+        boost::asio::dispatch(static_cast<strand_stream>(*m_state->impl),
+            [st = m_state, head = stream_head { std::move(header) }]() mutable {
+                st->impl->m_queue(std::move(head),
+                    [st](boost::system::error_code ec, std::size_t) {
+                        if (ec) {
+                            st->open = false;
+                            st->on_drain = nullptr;
+                        }
+                    });
+            });
+    }
+
+    /// Writes a piece of the body
+    /**
+     * @param data The data to be sent
+     * @returns false if the writer is closed or the high watermark is reached
+     */
+    bool write(std::string_view data)
+    {
+        if (data.empty()) {
+            return is_open() && pending() < m_state->high_watermark;
+        }
+        return enqueue(std::string { data });
+    }
+
+    /// Writes a server-sent event
+    /**
+     * Frames the data according to the `text/event-stream` format; the
+     * multiline data is split onto several `data:` fields.
+     *
+     * @param data The event data
+     * @param event The optional event type
+     * @param id The optional event id
+     * @returns false if the writer is closed or the high watermark is reached
+     */
+    bool write_event(std::string_view data, std::string_view event = {},
+        std::string_view id = {})
+    {
+        std::string frame;
+        frame.reserve(data.size() + event.size() + id.size() + 32);
+
+        if (!event.empty()) {
+            frame.append("event: ").append(event).append("\n");
+        }
+        if (!id.empty()) {
+            frame.append("id: ").append(id).append("\n");
+        }
+
+        std::size_t pos = 0;
+        do {
+            const auto end = data.find('\n', pos);
+            frame.append("data: ").append(data.substr(pos, end - pos)).append("\n");
+            pos = end == std::string_view::npos ? end : end + 1;
+        } while (pos != std::string_view::npos);
+        frame.append("\n");
+
+        return enqueue(std::move(frame));
+    }
+
+    /// Terminates the body
+    /**
+     * Sends the terminating chunk and closes the connection if the response
+     * requires so. Subsequent calls have no effect.
+     *
+     * @returns void
+     */
+    void close()
+    {
+        if (!m_state->open.exchange(false)) {
+            return;
+        }
+        post(std::string {}, m_state->need_eof);
+    }
+
+    /// Sets the callback invoked once the pending writes are drained
+    /**
+     * The callback is released as soon as the body is terminated, so it is
+     * safe to capture the writer itself.
+     *
+     * @param on_drain The callback invoked within the session's strand
+     * @returns void
+     */
+    void on_drain(on_drain_type on_drain)
+    {
+        boost::asio::dispatch(static_cast<strand_stream>(*m_state->impl),
+            [st = m_state, func = std::move(on_drain)]() mutable {
+                st->on_drain = std::move(func);
+            });
+    }
+
+    /// Returns the number of bytes waiting to be written
+    std::size_t pending() const { return m_state->pending; }
+
+    /// Returns the writer state
+    bool is_open() const { return m_state->open; }
+
+private:
+    struct state {
+        state(impl_type& impl, std::size_t watermark)
+            : impl { impl.shared_from_this() }
+            , pending { 0 }
+            , open { true }
+            , paused { false }
+            , chunked { true }
+            , need_eof { false }
+            , high_watermark { watermark }
+            , on_drain {}
+        {
+        }
+
+        std::shared_ptr<impl_type> impl;
+        std::atomic<std::size_t> pending;
+        std::atomic<bool> open;
+        std::atomic<bool> paused;
+        bool chunked;
+        bool need_eof;
+        const std::size_t high_watermark;
+        on_drain_type on_drain;
+    };
+
+    bool enqueue(std::string&& data)
+    {
+        if (!is_open()) {
+            return false;
+        }
+
+        const auto pending = m_state->pending += data.size();
+        post(std::move(data), false);
+
+        if (pending >= m_state->high_watermark) {
+            m_state->paused = true;
+            return false;
+        }
+        return true;
+    }
+
+    void post(std::string&& data, bool need_eof)
+    {
+        boost::asio::dispatch(static_cast<strand_stream>(*m_state->impl),
+            [st = m_state, chunk = stream_chunk { std::move(data), m_state->chunked, need_eof }]() mutable {
+                const auto size = chunk.size();
+                const auto last = chunk.is_last();
+                st->impl->m_queue(std::move(chunk),
+                    [st, size, last](boost::system::error_code ec, std::size_t) {
+                        const auto pending = st->pending -= size;
+                        if (ec || last) {
+                            // the callback may hold a copy of the writer
+                            st->open = false;
+                            st->on_drain = nullptr;
+                            return;
+                        }
+                        if (pending <= st->high_watermark / 2 && st->paused.exchange(false)
+                            && st->on_drain) {
+                            auto on_drain = st->on_drain;
+                            on_drain();
+                        }
+                    });
+            });
+    }
+
+    std::shared_ptr<state> m_state;
+};
+
+ROUTER_BASE_NAMESPACE_END()
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "../base/config.hpp"
+#include "http_utility.hpp"
+#include "prepared_response.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
+ROUTER_NAMESPACE_BEGIN()
+
+/// The priority of a route under the overload
+enum class route_priority {
+    /// Shed first
+    low,
+    /// Shed once shedding the low priority routes does not suffice
+    normal,
+    /// Never shed
+    high
+};
+
+/// Sheds the requests which can not be served in time
+/**
+ * The controller follows the CoDel idea: the requests are not rejected by a
+ * momentary spike but once the queueing delay stays above the target for a
+ * whole interval. The delay is the time a request waits for its handler to
+ * start, e.g. in the queue of the offload pool, and the backlog of the io
+ * context given by the @ref settings::backlog probe.
+ *
+ * Every interval over the target raises the shedding level by one, every
+ * interval below the target lowers it: the first level sheds the
+ * @ref route_priority::low routes and the second one the
+ * @ref route_priority::normal ones as well. The shed requests are responded
+ * with a prepared `503 Service Unavailable` carrying `Retry-After`.
+ *
+ * The recording and the admission are lock free.
+ *
+ * @par Example
+ *
+ * @code
+ * beast_router::admission_controller::settings config;
+ * config.target = std::chrono::milliseconds { 20 };
+ * config.backlog = [event_loop]() { return event_loop->get_lag(); };
+ *
+ * router.admission(std::make_shared<beast_router::admission_controller>(config));
+ * router.get(R"(^/report$)", beast_router::route_options { nullptr, beast_router::route_priority::low },
+ *     [](const auto& rq, auto& ctx) { ... });
+ * @endcode
+ */
+class admission_controller {
+public:
+    /// The clock type
+    using clock_type = std::chrono::steady_clock;
+
+    /// The duration type
+    using duration_type = clock_type::duration;
+
+    /// The backlog probe type
+    using backlog_type = std::function<duration_type()>;
+
+    /// The controller settings
+    struct settings {
+        /// The acceptable standing queueing delay
+        duration_type target = std::chrono::milliseconds { 5 };
+
+        /// The period the delay has to stay above the target to raise the
+        /// shedding level
+        duration_type interval = std::chrono::milliseconds { 100 };
+
+        /// The probe of the io context backlog e.g. the event loop lag; sampled
+        /// once per interval
+        backlog_type backlog = nullptr;
+
+        /// The value of the `Retry-After` field
+        std::chrono::seconds retry_after { 1 };
+    };
+
+    /// The highest shedding level
+    static constexpr std::size_t max_level = 2;
+
+    /// Constructor
+    ROUTER_DECL admission_controller();
+
+    /// Constructor
+    /**
+     * @param config The settings
+     */
+    ROUTER_DECL explicit admission_controller(settings config);
+
+    /// Constructor (disallowed)
+    admission_controller(const admission_controller&) = delete;
+
+    /// Assignment (disallowed)
+    admission_controller& operator=(const admission_controller&) = delete;
+
+    /// Records the queueing delay of a request
+    /**
+     * @param delay The time from the request being read to its handler start
+     * @returns void
+     */
+    ROUTER_DECL void record(duration_type delay);
+
+    /// Decides whether a request of the route is served
+    /**
+     * @param priority The priority of the route
+     * @returns false if the request has to be shed
+     */
+    ROUTER_DECL bool admit(route_priority priority);
+
+    /// Returns the shedding level
+    /**
+     * @returns 0 if nothing is shed, up to @ref max_level
+     */
+    ROUTER_DECL std::size_t level() const;
+
+    /// Returns the number of the shed requests
+    /**
+     * @returns std::size_t
+     */
+    ROUTER_DECL std::size_t rejected() const;
+
+    /// Returns the response of the shed requests
+    /**
+     * @returns @ref prepared_response
+     */
+    ROUTER_DECL const prepared_response& response() const;
+
+private:
+    ROUTER_DECL void update(clock_type::time_point now);
+
+    const settings m_settings;
+    const prepared_response m_response;
+    std::atomic<duration_type::rep> m_min_delay;
+    std::atomic<clock_type::rep> m_interval_end;
+    std::atomic<std::size_t> m_level;
+    std::atomic<std::size_t> m_rejected;
+};
+
+ROUTER_NAMESPACE_END()
+
+#include "impl/admission_controller.ipp"
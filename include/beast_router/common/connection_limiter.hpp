@@ -0,0 +1,162 @@
+#pragma once
+
+#include "../base/config.hpp"
+#include <boost/asio/ip/address.hpp>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+ROUTER_NAMESPACE_BEGIN()
+
+/// The way the connections over the limits are treated
+enum class overload_policy {
+    /// The accepting pauses until a connection is closed; the connections
+    /// over the per address limit are closed
+    pause,
+    /// The connections over the limits are accepted, responded with
+    /// `503 Service Unavailable` and closed
+    reject,
+    /// The connections over the limits are accepted and closed right away
+    close
+};
+
+/// The limits of the concurrent connections
+struct connection_limits {
+    /// The number of the connections; unlimited if zero
+    std::size_t max_connections = 0;
+
+    /// The number of the connections per remote address; unlimited if zero
+    std::size_t max_per_address = 0;
+
+    /// The treatment of the connections over the limits
+    overload_policy policy = overload_policy::pause;
+};
+
+/// Counts the live connections within the limits
+/**
+ * Every admitted connection is represented by a @ref slot which is released
+ * once the connection is closed. The global limit is reserved before a
+ * connection is accepted so that the acceptor can wait for a slot instead of
+ * accepting the sockets it can not serve.
+ *
+ * The class is thread safe.
+ */
+class connection_limiter : public std::enable_shared_from_this<connection_limiter> {
+public:
+    /// The address type
+    using address_type = boost::asio::ip::address;
+
+    /// The waiter type
+    using waiter_type = std::function<void()>;
+
+    /// The admitted connection; releases its place once destroyed
+    class slot {
+        friend class connection_limiter;
+
+    public:
+        /// Constructor
+        slot() = default;
+
+        /// Constructor (disallowed)
+        slot(const slot&) = delete;
+
+        /// Assignment (disallowed)
+        slot& operator=(const slot&) = delete;
+
+        /// Constructor
+        ROUTER_DECL slot(slot&& other) noexcept;
+
+        /// Assignment
+        ROUTER_DECL slot& operator=(slot&& other) noexcept;
+
+        /// Destructor; releases the slot
+        ROUTER_DECL ~slot();
+
+        /// Releases the slot ahead of the destruction
+        /**
+         * @returns void
+         */
+        ROUTER_DECL void release();
+
+    private:
+        ROUTER_DECL slot(std::shared_ptr<connection_limiter> limiter,
+            std::optional<address_type> address);
+
+        std::shared_ptr<connection_limiter> m_limiter;
+        std::optional<address_type> m_address;
+    };
+
+    /// Constructor
+    /**
+     * @param limits The limits
+     */
+    ROUTER_DECL explicit connection_limiter(const connection_limits& limits);
+
+    /// Constructor (disallowed)
+    connection_limiter(const connection_limiter&) = delete;
+
+    /// Assignment (disallowed)
+    connection_limiter& operator=(const connection_limiter&) = delete;
+
+    /// Reserves a connection within the global limit
+    /**
+     * @param waiter The callable invoked once a connection is released if
+     * there is no place; it is invoked once and has to reserve again
+     * @returns Whether the connection is reserved
+     */
+    ROUTER_DECL bool reserve(waiter_type waiter = nullptr);
+
+    /// Cancels a reservation which is not admitted
+    /**
+     * @returns void
+     */
+    ROUTER_DECL void cancel();
+
+    /// Admits the reserved connection of the address
+    /**
+     * The reservation is cancelled once the per address limit is reached
+     *
+     * @param address The remote address
+     * @returns The slot of the connection if admitted
+     */
+    ROUTER_DECL std::optional<slot> admit(const address_type& address);
+
+    /// Returns the number of the live connections
+    /**
+     * The connections reserved by the acceptors waiting for a peer are
+     * included
+     *
+     * @returns std::size_t
+     */
+    ROUTER_DECL std::size_t connections() const;
+
+    /// Returns the number of the live connections of the address
+    /**
+     * @param address The remote address
+     * @returns std::size_t
+     */
+    ROUTER_DECL std::size_t connections(const address_type& address) const;
+
+    /// Returns the limits
+    /**
+     * @returns @ref connection_limits
+     */
+    ROUTER_DECL const connection_limits& limits() const;
+
+private:
+    ROUTER_DECL void release(const std::optional<address_type>& address);
+
+    const connection_limits m_limits;
+    mutable std::mutex m_mutex;
+    std::size_t m_connections;
+    std::map<address_type, std::size_t> m_addresses;
+    std::deque<waiter_type> m_waiters;
+};
+
+ROUTER_NAMESPACE_END()
+
+#include "impl/connection_limiter.ipp"
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "../base/config.hpp"
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/basic_resolver_results.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/system/error_code.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+ROUTER_NAMESPACE_BEGIN()
+
+/// The settings of the resolution cache
+struct dns_cache_settings {
+    /// The time the resolved endpoints are kept for
+    std::chrono::steady_clock::duration ttl = std::chrono::seconds { 30 };
+
+    /// The time a failed resolution is kept for; not kept if zero
+    std::chrono::steady_clock::duration negative_ttl = std::chrono::seconds { 5 };
+
+    /// The time ahead of the expiration a lookup refreshes the entry in the
+    /// background at; not refreshed if zero
+    std::chrono::steady_clock::duration refresh_ahead = std::chrono::seconds { 5 };
+
+    /// The number of the entries the expired ones are dropped over
+    std::size_t max_entries = 1024;
+};
+
+/// Caches the resolved endpoints of the hosts
+/**
+ * The cache stands in front of a resolver, by default the asio one, i.e.
+ * `getaddrinfo` on the resolver thread: the concurrent lookups of a host
+ * share a single resolution, the results are kept for
+ * @ref dns_cache_settings::ttl and the failures for
+ * @ref dns_cache_settings::negative_ttl. A lookup hitting an entry which is
+ * about to expire completes with the cached endpoints and refreshes the
+ * entry in the background, so the hot hosts are never resolved inline.
+ *
+ * The resolver is pluggable, e.g. the tests resolve the hosts locally. The
+ * class is thread safe.
+ *
+ * @par Example
+ *
+ * @code
+ * beast_router::http_connector_type::set_dns_cache(beast_router::dns_cache::create(ioc));
+ * @endcode
+ */
+template <class Protocol>
+class basic_dns_cache : public std::enable_shared_from_this<basic_dns_cache<Protocol>> {
+public:
+    /// The self type
+    using self_type = basic_dns_cache<Protocol>;
+
+    /// The protocol type
+    using protocol_type = Protocol;
+
+    /// The results type
+    using results_type = boost::asio::ip::basic_resolver_results<protocol_type>;
+
+    /// The completion handler type
+    using handler_type = std::function<void(boost::system::error_code, results_type)>;
+
+    /// The resolver type
+    /**
+     * Resolves the host and the port and invokes the handler once, on any
+     * thread
+     */
+    using resolver_type = std::function<void(const std::string&, const std::string&, handler_type)>;
+
+    /// The clock type
+    using clock_type = std::chrono::steady_clock;
+
+    /// The cache ptr type
+    using cache_ptr_type = std::shared_ptr<self_type>;
+
+    /// The counters of the lookups
+    struct stats_type {
+        /// The lookups completed by the cached endpoints
+        std::uint64_t hits = 0;
+
+        /// The lookups completed by the cached failures
+        std::uint64_t negative_hits = 0;
+
+        /// The lookups waiting for a resolution
+        std::uint64_t misses = 0;
+
+        /// The background refreshes
+        std::uint64_t refreshes = 0;
+    };
+
+    /// Constructor (disallowed)
+    basic_dns_cache(const basic_dns_cache&) = delete;
+
+    /// Assignment (disallowed)
+    self_type& operator=(const basic_dns_cache&) = delete;
+
+    /// The cache factory method
+    /**
+     * @param resolver The resolver
+     * @param settings The settings
+     * @returns `self_type::cache_ptr_type`
+     */
+    static cache_ptr_type create(resolver_type resolver, const dns_cache_settings& settings = {});
+
+    /// The cache factory method using the asio resolver
+    /**
+     * @param ioc The io context the resolutions complete on
+     * @param settings The settings
+     * @returns `self_type::cache_ptr_type`
+     */
+    static cache_ptr_type create(boost::asio::io_context& ioc, const dns_cache_settings& settings = {});
+
+    /// Looks up the host
+    /**
+     * The handler is posted to the executor even if the lookup completes
+     * right away
+     *
+     * @param host The host
+     * @param port The port
+     * @param executor The executor the handler is invoked on
+     * @param handler The completion handler
+     * @returns void
+     */
+    template <class Executor>
+    void resolve(std::string_view host, std::string_view port, const Executor& executor,
+        handler_type handler);
+
+    /// Drops the entries; the resolutions in progress complete as usual
+    /**
+     * @returns void
+     */
+    void clear();
+
+    /// Returns the number of the entries
+    /**
+     * @returns std::size_t
+     */
+    std::size_t size() const;
+
+    /// Returns the counters of the lookups
+    /**
+     * @returns @ref stats_type
+     */
+    stats_type stats() const;
+
+    /// Returns the settings
+    /**
+     * @returns @ref dns_cache_settings
+     */
+    const dns_cache_settings& settings() const;
+
+protected:
+    /// Constructor
+    basic_dns_cache(resolver_type resolver, const dns_cache_settings& settings);
+
+private:
+    using key_type = std::pair<std::string, std::string>;
+
+    struct entry {
+        results_type results;
+        boost::system::error_code error;
+        clock_type::time_point expires;
+        bool resolved = false;
+        bool resolving = false;
+        std::vector<handler_type> waiters;
+    };
+
+    void do_resolve(const key_type& key);
+
+    void on_resolve(const key_type& key, boost::system::error_code ec, results_type results);
+
+    void do_trim(clock_type::time_point now);
+
+    resolver_type m_resolver;
+    const dns_cache_settings m_settings;
+    mutable std::mutex m_mutex;
+    std::map<key_type, entry> m_entries;
+    stats_type m_stats;
+};
+
+/// Default resolution cache type
+using dns_cache = basic_dns_cache<boost::asio::ip::tcp>;
+
+ROUTER_NAMESPACE_END()
+
+#include "impl/dns_cache.ipp"
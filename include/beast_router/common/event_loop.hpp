@@ -1,10 +1,19 @@
 #pragma once
 
 #include "../base/config.hpp"
+#include "http_date.hpp"
+#include <atomic>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/signal_set.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/system_timer.hpp>
 #include <boost/thread.hpp>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string_view>
 #include <thread>
+#include <vector>
 
 ROUTER_NAMESPACE_BEGIN()
 
@@ -14,6 +23,27 @@ ROUTER_NAMESPACE_BEGIN()
  * By the giveb number of threads, create a thread pool and executes 
  * handlers by leveraging their executors. This class is acceptable
  * by the @ref session and @connector.
+ *
+ * While running, the loop refreshes the cached @ref http_date once per second.
+ *
+ * Two topologies are available:
+ * - @ref topology::shared (default) runs a single io_context by all the
+ *   threads, the handlers are serialized by strands;
+ * - @ref topology::per_core runs one io_context per thread so that the
+ *   threads do not contend on a shared scheduler. The @ref listener and the
+ *   @ref connector spread the new connections among the contexts by the
+ *   given @ref assignment policy, a connection then stays on its context.
+ *
+ * Every context is watched by a probe which measures the scheduling lag i.e.
+ * how late a timer fires; the @ref assignment::least_loaded policy picks the
+ * context with the lowest lag.
+ *
+ * ### Example
+ * ```cpp
+ * auto event_loop = beast_router::event_loop::create(4u,
+ *     beast_router::event_loop::settings { beast_router::event_loop::topology::per_core,
+ *         beast_router::event_loop::assignment::round_robin, true });
+ * ```
  */
 class event_loop : public std::enable_shared_from_this<event_loop> {
     template <class, class, class, template <typename> class>
@@ -29,6 +59,44 @@ public:
     /// This `pointer` type
     using event_loop_ptr_type = std::shared_ptr<event_loop>;
 
+    /// The lag duration type
+    using duration_type = std::chrono::steady_clock::duration;
+
+    /// The io contexts topology
+    enum class topology {
+        /// A single io_context run by all the threads
+        shared,
+        /// One io_context per thread
+        per_core
+    };
+
+    /// The policy of assigning the new connections to the io contexts
+    enum class assignment {
+        /// The contexts are taken in turn
+        round_robin,
+        /// The context with the lowest scheduling lag is taken
+        least_loaded
+    };
+
+    /// The event loop settings
+    struct settings {
+        /// The io contexts topology
+        topology layout = topology::shared;
+
+        /// The connections assignment policy
+        assignment policy = assignment::round_robin;
+
+        /// Pins the i-th thread to the i-th CPU of the process affinity mask
+        bool pin_threads = false;
+
+        /// Reports the failures of the loop threads e.g. a thread could not be
+        /// pinned
+        std::function<void(boost::system::error_code, std::string_view)> on_error = nullptr;
+    };
+
+    /// The lag probe period
+    static constexpr std::chrono::milliseconds probe_interval { 50 };
+
     /// Constructor (disallowed)
     event_loop(const event_loop&) = delete;
 
@@ -68,6 +136,44 @@ public:
     */
     ROUTER_DECL bool is_running() const;
 
+    /// Returns the settings
+    /**
+     * @returns @ref settings
+    */
+    ROUTER_DECL const settings& get_settings() const;
+
+    /// Returns the number of io contexts
+    /**
+     * @returns std::size_t
+    */
+    ROUTER_DECL std::size_t get_contexts() const;
+
+    /// Returns the io context by the index
+    /**
+     * @param idx The index, less than @ref get_contexts()
+     * @returns boost::asio::io_context&
+    */
+    ROUTER_DECL boost::asio::io_context& get_context(std::size_t idx);
+
+    /// Returns the io context for a new connection by the assignment policy
+    /**
+     * @returns boost::asio::io_context&
+    */
+    ROUTER_DECL boost::asio::io_context& get_context();
+
+    /// Returns the smoothed scheduling lag of the io context
+    /**
+     * @param idx The index, less than @ref get_contexts()
+     * @returns @ref duration_type
+    */
+    ROUTER_DECL duration_type get_lag(std::size_t idx) const;
+
+    /// Returns the highest smoothed scheduling lag among the io contexts
+    /**
+     * @returns @ref duration_type
+    */
+    ROUTER_DECL duration_type get_lag() const;
+
     /// The method creates an event loop by the given parameters
     /**
      * The mthod accepts a pack and forwards to the available 
@@ -83,16 +189,44 @@ public:
     /**
      * @returns boost::asio::io_context&
     */
-    ROUTER_DECL operator boost::asio::io_context&() { return m_ioc; }
+    ROUTER_DECL operator boost::asio::io_context&() { return m_workers.front()->ctx; }
 
 protected:
     ROUTER_DECL event_loop(threads_num_type threads = 0u);
 
+    ROUTER_DECL event_loop(threads_num_type threads, settings config);
+
 private:
+    struct worker {
+        explicit worker(int concurrency_hint);
+
+        boost::asio::io_context ctx;
+        boost::asio::steady_timer probe;
+        std::atomic<duration_type::rep> lag;
+    };
+
+    using worker_ptr_type = std::unique_ptr<worker>;
+
+    ROUTER_DECL static std::vector<worker_ptr_type> make_workers(
+        threads_num_type threads, const settings& config);
+
+    ROUTER_DECL static std::vector<int> allowed_cpus();
+
+    ROUTER_DECL static boost::system::error_code pin_thread(int cpu);
+
+    ROUTER_DECL void do_date_update();
+
+    ROUTER_DECL void do_probe(worker& wrk);
+
+    ROUTER_DECL void stop_contexts();
+
     threads_num_type m_threads_num;
+    settings m_settings;
     boost::thread_group m_threads;
-    boost::asio::io_context m_ioc;
+    std::vector<worker_ptr_type> m_workers;
+    std::atomic<std::size_t> m_next;
     boost::asio::signal_set m_sig_int_term;
+    boost::asio::system_timer m_date_timer;
 };
 
 ROUTER_NAMESPACE_END()
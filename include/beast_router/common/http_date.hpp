@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../base/config.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+ROUTER_NAMESPACE_BEGIN()
+
+/// Provides the HTTP date formatting
+/**
+ * Formats a time point by following the IMF-fixdate format (RFC 7231) e.g.
+ * `Sun, 06 Nov 1994 08:49:37 GMT`. The formatting neither allocates nor
+ * relies on the libc time and locale functions.
+ *
+ * The current date is cached: the @ref event_loop refreshes the shared clock
+ * once per second by calling @ref update() whereas every thread formats the
+ * date at most once per second on reading by @ref now(). The reading is lock
+ * free; with no running event loop it falls back to the system clock.
+ */
+class http_date {
+public:
+    /// The length of the formatted date
+    static constexpr std::size_t length = 29;
+
+    /// The formatted date buffer type
+    using buffer_type = std::array<char, length>;
+
+    /// The clock type
+    using clock_type = std::chrono::system_clock;
+
+    /// Formats the given number of seconds since the epoch
+    /**
+     * @param seconds The number of seconds since the epoch
+     * @param out The output buffer
+     * @returns void
+     */
+    ROUTER_DECL static void format(std::int64_t seconds, buffer_type& out);
+
+    /// Formats the given time point
+    /**
+     * @param time_point The time point to be formatted
+     * @returns @ref buffer_type
+     */
+    ROUTER_DECL static buffer_type format(clock_type::time_point time_point);
+
+    /// Returns the cached current date
+    /**
+     * @returns A view onto the thread local buffer which is valid until the
+     * next call within the same thread
+     */
+    ROUTER_DECL static std::string_view now();
+
+    /// Refreshes the shared clock
+    /**
+     * @param time_point The current time point
+     * @returns void
+     */
+    ROUTER_DECL static void update(clock_type::time_point time_point = clock_type::now());
+
+    /// Resets the shared clock; @ref now() falls back to the system clock
+    /**
+     * @returns void
+     */
+    ROUTER_DECL static void reset();
+
+private:
+    static inline std::atomic<std::int64_t> s_seconds { 0 };
+};
+
+ROUTER_NAMESPACE_END()
+
+#include "impl/http_date.ipp"
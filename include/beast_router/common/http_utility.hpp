@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../base/config.hpp"
+#include "http_date.hpp"
 #include <boost/beast/http/empty_body.hpp>
 #include <boost/beast/http/file_body.hpp>
 #include <boost/beast/http/message.hpp>
@@ -100,6 +101,9 @@ static std::string_view get_mime_type(std::string_view ext);
 
 /// Creates a response associated with the Body type
 /**
+ * The response is stamped with the `Date` field by using the cached
+ * @ref http_date; all the response builders below rely on this method.
+ *
  * @param code HTTP code
  * @param version Version of HTTP to be sent
  * @param args A tuple forwarded as a parameter pack to the `Fields` constructor
@@ -146,6 +150,16 @@ template <class Version>
 static http_empty_response make_moved_response(Version version,
     std::string_view location);
 
+/// Creates the header of a server-sent events response
+/**
+ * The response is meant to be streamed by the `context::stream()`
+ *
+ * @param version HTTP version
+ * @returns http_empty_response with the `text/event-stream` content type
+ */
+template <class Version>
+static http_empty_response make_event_stream_response(Version version);
+
 /// Creates string response by the given HTTP code and string data
 /**
  * @param code HTTP status code
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+
+ROUTER_NAMESPACE_BEGIN()
+
+ROUTER_DECL admission_controller::admission_controller()
+    : admission_controller { settings {} }
+{
+}
+
+ROUTER_DECL admission_controller::admission_controller(settings config)
+    : m_settings { std::move(config) }
+    , m_response { [this]() {
+        auto rp = make_empty_response(http::status::service_unavailable, 11);
+        rp.set(http::field::retry_after, std::to_string(m_settings.retry_after.count()));
+        rp.prepare_payload();
+        return rp;
+    }() }
+    , m_min_delay { (duration_type::max)().count() }
+    , m_interval_end { (clock_type::now() + m_settings.interval).time_since_epoch().count() }
+    , m_level { 0 }
+    , m_rejected { 0 }
+{
+}
+
+ROUTER_DECL void admission_controller::record(duration_type delay)
+{
+    auto current = m_min_delay.load(std::memory_order_relaxed);
+    while (delay.count() < current
+        && !m_min_delay.compare_exchange_weak(current, delay.count(), std::memory_order_relaxed)) {
+    }
+
+    update(clock_type::now());
+}
+
+ROUTER_DECL bool admission_controller::admit(route_priority priority)
+{
+    update(clock_type::now());
+
+    const auto level = m_level.load(std::memory_order_relaxed);
+    const auto admitted = priority == route_priority::high
+        || (priority == route_priority::normal && level < max_level)
+        || (priority == route_priority::low && level == 0);
+    if (!admitted) {
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+    }
+    return admitted;
+}
+
+ROUTER_DECL std::size_t admission_controller::level() const
+{
+    return m_level.load(std::memory_order_relaxed);
+}
+
+ROUTER_DECL std::size_t admission_controller::rejected() const
+{
+    return m_rejected.load(std::memory_order_relaxed);
+}
+
+ROUTER_DECL const prepared_response& admission_controller::response() const
+{
+    return m_response;
+}
+
+ROUTER_DECL void admission_controller::update(clock_type::time_point now)
+{
+    auto end = m_interval_end.load(std::memory_order_relaxed);
+    if (now.time_since_epoch().count() < end) {
+        return;
+    }
+
+    // a single caller closes the interval
+    const auto next = (now + m_settings.interval).time_since_epoch().count();
+    if (!m_interval_end.compare_exchange_strong(end, next, std::memory_order_relaxed)) {
+        return;
+    }
+
+    // no requests within the interval means no standing queue
+    auto delay = duration_type { m_min_delay.exchange((duration_type::max)().count(), std::memory_order_relaxed) };
+    if (delay == (duration_type::max)()) {
+        delay = duration_type::zero();
+    }
+    if (m_settings.backlog) {
+        delay = std::max(delay, m_settings.backlog());
+    }
+
+    const auto level = m_level.load(std::memory_order_relaxed);
+    if (delay > m_settings.target) {
+        m_level.store(std::min(level + 1, max_level), std::memory_order_relaxed);
+    } else if (level > 0) {
+        m_level.store(level - 1, std::memory_order_relaxed);
+    }
+}
+
+ROUTER_NAMESPACE_END()
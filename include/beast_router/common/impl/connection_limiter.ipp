@@ -0,0 +1,134 @@
+#pragma once
+
+#include <utility>
+
+ROUTER_NAMESPACE_BEGIN()
+
+ROUTER_DECL connection_limiter::slot::slot(std::shared_ptr<connection_limiter> limiter,
+    std::optional<address_type> address)
+    : m_limiter { std::move(limiter) }
+    , m_address { std::move(address) }
+{
+}
+
+ROUTER_DECL connection_limiter::slot::slot(slot&& other) noexcept
+    : m_limiter { std::move(other.m_limiter) }
+    , m_address { std::move(other.m_address) }
+{
+    other.m_limiter.reset();
+}
+
+ROUTER_DECL connection_limiter::slot& connection_limiter::slot::operator=(slot&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        m_limiter = std::move(other.m_limiter);
+        m_address = std::move(other.m_address);
+        other.m_limiter.reset();
+    }
+    return *this;
+}
+
+ROUTER_DECL connection_limiter::slot::~slot()
+{
+    release();
+}
+
+ROUTER_DECL void connection_limiter::slot::release()
+{
+    if (auto limiter = std::move(m_limiter)) {
+        limiter->release(m_address);
+    }
+}
+
+ROUTER_DECL connection_limiter::connection_limiter(const connection_limits& limits)
+    : m_limits { limits }
+    , m_mutex {}
+    , m_connections { 0 }
+    , m_addresses {}
+    , m_waiters {}
+{
+}
+
+ROUTER_DECL bool connection_limiter::reserve(waiter_type waiter)
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    if (m_limits.max_connections && m_connections >= m_limits.max_connections) {
+        if (waiter) {
+            m_waiters.push_back(std::move(waiter));
+        }
+        return false;
+    }
+
+    ++m_connections;
+    return true;
+}
+
+ROUTER_DECL void connection_limiter::cancel()
+{
+    release(std::nullopt);
+}
+
+ROUTER_DECL std::optional<connection_limiter::slot> connection_limiter::admit(
+    const address_type& address)
+{
+    if (!m_limits.max_per_address) {
+        return slot { shared_from_this(), std::nullopt };
+    }
+
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        auto& count = m_addresses[address];
+        if (count < m_limits.max_per_address) {
+            ++count;
+            return slot { shared_from_this(), address };
+        }
+    }
+
+    cancel();
+    return std::nullopt;
+}
+
+ROUTER_DECL std::size_t connection_limiter::connections() const
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    return m_connections;
+}
+
+ROUTER_DECL std::size_t connection_limiter::connections(const address_type& address) const
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    const auto it = m_addresses.find(address);
+    return it != m_addresses.end() ? it->second : 0;
+}
+
+ROUTER_DECL const connection_limits& connection_limiter::limits() const
+{
+    return m_limits;
+}
+
+ROUTER_DECL void connection_limiter::release(const std::optional<address_type>& address)
+{
+    waiter_type waiter;
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        --m_connections;
+        if (address) {
+            const auto it = m_addresses.find(*address);
+            if (it != m_addresses.end() && --it->second == 0) {
+                m_addresses.erase(it);
+            }
+        }
+        if (!m_waiters.empty()) {
+            waiter = std::move(m_waiters.front());
+            m_waiters.pop_front();
+        }
+    }
+
+    // the waiter reserves by itself
+    if (waiter) {
+        waiter();
+    }
+}
+
+ROUTER_NAMESPACE_END()
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <boost/asio/error.hpp>
+
+ROUTER_NAMESPACE_BEGIN()
+
+template <class Protocol>
+basic_dns_cache<Protocol>::basic_dns_cache(resolver_type resolver,
+    const dns_cache_settings& settings)
+    : m_resolver { std::move(resolver) }
+    , m_settings { settings }
+    , m_mutex {}
+    , m_entries {}
+    , m_stats {}
+{
+}
+
+template <class Protocol>
+typename basic_dns_cache<Protocol>::cache_ptr_type
+basic_dns_cache<Protocol>::create(resolver_type resolver, const dns_cache_settings& settings)
+{
+    struct enable_make_shared : public self_type {
+        enable_make_shared(resolver_type resolver, const dns_cache_settings& settings)
+            : self_type { std::move(resolver), settings }
+        {
+        }
+    };
+
+    return std::make_shared<enable_make_shared>(std::move(resolver), settings);
+}
+
+template <class Protocol>
+typename basic_dns_cache<Protocol>::cache_ptr_type
+basic_dns_cache<Protocol>::create(boost::asio::io_context& ioc, const dns_cache_settings& settings)
+{
+    return create(
+        [&ioc](const std::string& host, const std::string& port, handler_type handler) {
+            auto resolver = std::make_shared<typename protocol_type::resolver>(ioc);
+            resolver->async_resolve(host, port,
+                [resolver, handler = std::move(handler)](boost::system::error_code ec,
+                    results_type results) {
+                    handler(ec, std::move(results));
+                });
+        },
+        settings);
+}
+
+template <class Protocol>
+template <class Executor>
+void basic_dns_cache<Protocol>::resolve(std::string_view host, std::string_view port,
+    const Executor& executor, handler_type handler)
+{
+    handler_type done = [executor, handler = std::move(handler)](boost::system::error_code ec,
+                            results_type results) {
+        boost::asio::post(executor, [handler, ec, results = std::move(results)]() mutable {
+            handler(ec, std::move(results));
+        });
+    };
+
+    key_type key { std::string { host }, std::string { port } };
+    std::unique_lock<std::mutex> lock { m_mutex };
+    const auto now = clock_type::now();
+    if (m_entries.size() >= m_settings.max_entries && m_entries.find(key) == m_entries.end()) {
+        do_trim(now);
+    }
+
+    auto& e = m_entries[key];
+    if (e.resolved && now < e.expires) {
+        bool refresh = false;
+        if (e.error) {
+            ++m_stats.negative_hits;
+        } else {
+            ++m_stats.hits;
+            if (m_settings.refresh_ahead != clock_type::duration::zero() && !e.resolving
+                && e.expires - now <= m_settings.refresh_ahead) {
+                e.resolving = true;
+                refresh = true;
+                ++m_stats.refreshes;
+            }
+        }
+
+        const auto ec = e.error;
+        auto results = e.results;
+        lock.unlock();
+        done(ec, std::move(results));
+        if (refresh) {
+            do_resolve(key);
+        }
+        return;
+    }
+
+    /// the lookups of the host share the resolution in progress
+    ++m_stats.misses;
+    e.waiters.push_back(std::move(done));
+    if (e.resolving) {
+        return;
+    }
+
+    e.resolving = true;
+    lock.unlock();
+    do_resolve(key);
+}
+
+template <class Protocol>
+void basic_dns_cache<Protocol>::clear()
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->second.resolving) {
+            it->second.resolved = false;
+            ++it;
+        } else {
+            it = m_entries.erase(it);
+        }
+    }
+}
+
+template <class Protocol>
+std::size_t basic_dns_cache<Protocol>::size() const
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    return m_entries.size();
+}
+
+template <class Protocol>
+typename basic_dns_cache<Protocol>::stats_type basic_dns_cache<Protocol>::stats() const
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    return m_stats;
+}
+
+template <class Protocol>
+const dns_cache_settings& basic_dns_cache<Protocol>::settings() const
+{
+    return m_settings;
+}
+
+template <class Protocol>
+void basic_dns_cache<Protocol>::do_resolve(const key_type& key)
+{
+    m_resolver(key.first, key.second,
+        [self = this->shared_from_this(), key](boost::system::error_code ec, results_type results) {
+            self->on_resolve(key, ec, std::move(results));
+        });
+}
+
+template <class Protocol>
+void basic_dns_cache<Protocol>::on_resolve(const key_type& key, boost::system::error_code ec,
+    results_type results)
+{
+    std::vector<handler_type> waiters;
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        auto& e = m_entries[key];
+        e.resolving = false;
+        waiters.swap(e.waiters);
+
+        const auto now = clock_type::now();
+        if (!ec) {
+            e.results = results;
+            e.error = {};
+            e.resolved = true;
+            e.expires = now + m_settings.ttl;
+        } else if (e.resolved && !e.error && now < e.expires) {
+            /// the refresh failed, the endpoints are kept until they expire
+        } else if (m_settings.negative_ttl != clock_type::duration::zero()
+            && ec != boost::asio::error::operation_aborted) {
+            e.results = {};
+            e.error = ec;
+            e.resolved = true;
+            e.expires = now + m_settings.negative_ttl;
+        } else {
+            m_entries.erase(key);
+        }
+    }
+
+    for (auto& waiter : waiters) {
+        waiter(ec, results);
+    }
+}
+
+template <class Protocol>
+void basic_dns_cache<Protocol>::do_trim(clock_type::time_point now)
+{
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (!it->second.resolving && it->second.expires <= now) {
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (m_entries.size() < m_settings.max_entries) {
+        return;
+    }
+
+    /// the entry expiring first makes the room
+    auto oldest = m_entries.end();
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (!it->second.resolving && (oldest == m_entries.end() || it->second.expires < oldest->second.expires)) {
+            oldest = it;
+        }
+    }
+    if (oldest != m_entries.end()) {
+        m_entries.erase(oldest);
+    }
+}
+
+ROUTER_NAMESPACE_END()
@@ -1,14 +1,35 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 ROUTER_NAMESPACE_BEGIN()
 
+ROUTER_DECL event_loop::worker::worker(int concurrency_hint)
+    : ctx { concurrency_hint }
+    , probe { ctx }
+    , lag { 0 }
+{
+}
+
 ROUTER_DECL event_loop::event_loop(threads_num_type threads)
+    : event_loop { threads, settings {} }
+{
+}
+
+ROUTER_DECL event_loop::event_loop(threads_num_type threads, settings config)
     : m_threads_num { threads }
+    , m_settings { config }
     , m_threads {}
-    , m_ioc {}
-    , m_sig_int_term { m_ioc, SIGINT, SIGTERM }
+    , m_workers { make_workers(threads, config) }
+    , m_next { 0 }
+    , m_sig_int_term { m_workers.front()->ctx, SIGINT, SIGTERM }
+    , m_date_timer { m_workers.front()->ctx }
 {
 }
 
@@ -25,13 +46,70 @@ event_loop::get_threads() const
 
 ROUTER_DECL void event_loop::stop()
 {
-    m_ioc.stop();
+    stop_contexts();
     m_threads.join_all();
 }
 
 ROUTER_DECL bool event_loop::is_running() const
 {
-    return not m_ioc.stopped();
+    return not m_workers.front()->ctx.stopped();
+}
+
+ROUTER_DECL const event_loop::settings& event_loop::get_settings() const
+{
+    return m_settings;
+}
+
+ROUTER_DECL std::size_t event_loop::get_contexts() const
+{
+    return m_workers.size();
+}
+
+ROUTER_DECL boost::asio::io_context& event_loop::get_context(std::size_t idx)
+{
+    BOOST_ASSERT(idx < m_workers.size());
+    return m_workers[idx]->ctx;
+}
+
+ROUTER_DECL boost::asio::io_context& event_loop::get_context()
+{
+    const auto size = m_workers.size();
+    if (size == 1) {
+        return m_workers.front()->ctx;
+    }
+
+    const auto start = m_next.fetch_add(1, std::memory_order_relaxed) % size;
+    if (m_settings.policy == assignment::round_robin) {
+        return m_workers[start]->ctx;
+    }
+
+    // starts from the round robin position to spread the equally loaded ones
+    auto best = start;
+    auto best_lag = m_workers[start]->lag.load(std::memory_order_relaxed);
+    for (std::size_t i = 1; i < size; ++i) {
+        const auto idx = (start + i) % size;
+        const auto lag = m_workers[idx]->lag.load(std::memory_order_relaxed);
+        if (lag < best_lag) {
+            best = idx;
+            best_lag = lag;
+        }
+    }
+    return m_workers[best]->ctx;
+}
+
+ROUTER_DECL event_loop::duration_type event_loop::get_lag(std::size_t idx) const
+{
+    BOOST_ASSERT(idx < m_workers.size());
+    return duration_type { m_workers[idx]->lag.load(std::memory_order_relaxed) };
+}
+
+ROUTER_DECL event_loop::duration_type event_loop::get_lag() const
+{
+    auto ret = duration_type::zero();
+    for (std::size_t idx = 0; idx < m_workers.size(); ++idx) {
+        ret = std::max(ret, get_lag(idx));
+    }
+    return ret;
 }
 
 ROUTER_DECL int event_loop::exec()
@@ -40,18 +118,142 @@ ROUTER_DECL int event_loop::exec()
 
     m_sig_int_term.async_wait([this, &ret_code](const boost::system::error_code& ec, int) {
         ret_code = ec.value();
-        m_ioc.stop();
+        stop_contexts();
     });
 
-    for (threads_num_type i = 1; i < m_threads_num; ++i) {
-        m_threads.create_thread([this]() { m_ioc.run(); });
+    do_date_update();
+    for (auto& wrk : m_workers) {
+        do_probe(*wrk);
+    }
+
+    // the CPUs are taken from the affinity mask the process was started with
+    const auto pin = m_settings.pin_threads;
+    const auto cpus = pin ? allowed_cpus() : std::vector<int> {};
+    const auto do_pin = [on_error = m_settings.on_error, cpus](threads_num_type idx) {
+        auto ec = cpus.empty()
+            ? boost::system::errc::make_error_code(boost::system::errc::not_supported)
+            : pin_thread(cpus[idx % cpus.size()]);
+        if (ec && on_error) {
+            on_error(ec, "pin_thread");
+        }
+    };
+
+    for (threads_num_type i = 1; i < std::max(m_threads_num, 1u); ++i) {
+        auto& ctx = m_workers[i % m_workers.size()]->ctx;
+        m_threads.create_thread([&ctx, pin, i, do_pin]() {
+            if (pin) {
+                do_pin(i);
+            }
+            ctx.run();
+        });
+    }
+
+    if (pin) {
+        do_pin(0);
     }
 
-    m_ioc.run();
+    m_workers.front()->ctx.run();
+
+    m_date_timer.cancel();
+    for (auto& wrk : m_workers) {
+        wrk->probe.cancel();
+    }
+    http_date::reset();
 
     return ret_code;
 }
 
+ROUTER_DECL std::vector<event_loop::worker_ptr_type> event_loop::make_workers(
+    threads_num_type threads, const settings& config)
+{
+    std::vector<worker_ptr_type> ret;
+    if (config.layout == topology::per_core) {
+        const auto size = std::max(threads, 1u);
+        ret.reserve(size);
+        for (threads_num_type i = 0; i < size; ++i) {
+            // a single thread runs the context
+            ret.push_back(std::make_unique<worker>(1));
+        }
+    } else {
+        ret.push_back(std::make_unique<worker>(BOOST_ASIO_CONCURRENCY_HINT_DEFAULT));
+    }
+    return ret;
+}
+
+ROUTER_DECL std::vector<int> event_loop::allowed_cpus()
+{
+    std::vector<int> ret;
+#if defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    if (::sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &cpu_set)) {
+                ret.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return ret;
+}
+
+ROUTER_DECL boost::system::error_code event_loop::pin_thread(int cpu)
+{
+#if defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    if (const auto ret = ::pthread_setaffinity_np(::pthread_self(), sizeof(cpu_set), &cpu_set); ret != 0) {
+        return { ret, boost::system::system_category() };
+    }
+    return {};
+#else
+    boost::ignore_unused(cpu);
+    return boost::system::errc::make_error_code(boost::system::errc::not_supported);
+#endif
+}
+
+ROUTER_DECL void event_loop::do_date_update()
+{
+    const auto now = http_date::clock_type::now();
+    http_date::update(now);
+
+    // wake up right after the next second begins
+    m_date_timer.expires_at(
+        std::chrono::floor<std::chrono::seconds>(now) + std::chrono::seconds { 1 });
+    m_date_timer.async_wait([this](const boost::system::error_code& ec) {
+        if (!ec) {
+            do_date_update();
+        }
+    });
+}
+
+ROUTER_DECL void event_loop::do_probe(worker& wrk)
+{
+    const auto expected = std::chrono::steady_clock::now() + probe_interval;
+    wrk.probe.expires_at(expected);
+    wrk.probe.async_wait([this, &wrk, expected](const boost::system::error_code& ec) {
+        if (ec) {
+            return;
+        }
+
+        // exponentially weighted moving average, alpha = 1/8
+        const auto sample = (std::chrono::steady_clock::now() - expected).count();
+        const auto lag = wrk.lag.load(std::memory_order_relaxed);
+        wrk.lag.store(lag + (std::max<duration_type::rep>(sample, 0) - lag) / 8,
+            std::memory_order_relaxed);
+
+        do_probe(wrk);
+    });
+}
+
+ROUTER_DECL void event_loop::stop_contexts()
+{
+    for (auto& wrk : m_workers) {
+        wrk->ctx.stop();
+    }
+}
+
 template <class... Args>
 ROUTER_DECL auto event_loop::create(Args&&... args)
     -> decltype(event_loop { std::declval<Args>()... }, event_loop_ptr_type())
@@ -66,4 +268,4 @@ ROUTER_DECL auto event_loop::create(Args&&... args)
     return std::make_shared<enable_make_shared>(std::forward<Args>(args)...);
 }
 
-ROUTER_NAMESPACE_END()
\ No newline at end of file
+ROUTER_NAMESPACE_END()
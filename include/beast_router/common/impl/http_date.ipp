@@ -0,0 +1,101 @@
+#pragma once
+
+ROUTER_NAMESPACE_BEGIN()
+
+ROUTER_DECL void http_date::format(std::int64_t seconds, buffer_type& out)
+{
+    static constexpr std::string_view week_days = "SunMonTueWedThuFriSat";
+    static constexpr std::string_view months = "JanFebMarAprMayJunJulAugSepOctNovDec";
+
+    auto days = seconds / 86400;
+    auto secs = seconds % 86400;
+    if (secs < 0) {
+        secs += 86400;
+        --days;
+    }
+
+    // the epoch day is Thursday
+    const auto week_day = static_cast<std::size_t>((days % 7 + 11) % 7);
+
+    // converts the days to the civil date
+    const auto z = days + 719468;
+    const auto era = (z >= 0 ? z : z - 146096) / 146097;
+    const auto doe = z - era * 146097;
+    const auto yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const auto doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const auto mp = (5 * doy + 2) / 153;
+    const auto day = doy - (153 * mp + 2) / 5 + 1;
+    const auto month = static_cast<std::size_t>(mp < 10 ? mp + 2 : mp - 10);
+    const auto year = yoe + era * 400 + (month <= 1);
+
+    const auto put2 = [](char* dst, std::int64_t val) {
+        dst[0] = static_cast<char>('0' + val / 10);
+        dst[1] = static_cast<char>('0' + val % 10);
+    };
+
+    char* dst = out.data();
+    week_days.copy(dst, 3, week_day * 3);
+    dst[3] = ',';
+    dst[4] = ' ';
+    put2(dst + 5, day);
+    dst[7] = ' ';
+    months.copy(dst + 8, 3, month * 3);
+    dst[11] = ' ';
+    put2(dst + 12, (year / 100) % 100);
+    put2(dst + 14, year % 100);
+    dst[16] = ' ';
+    put2(dst + 17, secs / 3600);
+    dst[19] = ':';
+    put2(dst + 20, secs / 60 % 60);
+    dst[22] = ':';
+    put2(dst + 23, secs % 60);
+    std::string_view { " GMT" }.copy(dst + 25, 4);
+}
+
+ROUTER_DECL http_date::buffer_type http_date::format(clock_type::time_point time_point)
+{
+    buffer_type out;
+    format(std::chrono::duration_cast<std::chrono::seconds>(
+               time_point.time_since_epoch())
+               .count(),
+        out);
+    return out;
+}
+
+ROUTER_DECL std::string_view http_date::now()
+{
+    struct cache {
+        std::int64_t seconds = -1;
+        buffer_type buffer {};
+    };
+    static thread_local cache t_cache;
+
+    auto seconds = s_seconds.load(std::memory_order_relaxed);
+    if (!seconds) {
+        seconds = std::chrono::duration_cast<std::chrono::seconds>(
+            clock_type::now().time_since_epoch())
+                      .count();
+    }
+
+    if (t_cache.seconds != seconds) {
+        format(seconds, t_cache.buffer);
+        t_cache.seconds = seconds;
+    }
+
+    return { t_cache.buffer.data(), t_cache.buffer.size() };
+}
+
+ROUTER_DECL void http_date::update(clock_type::time_point time_point)
+{
+    s_seconds.store(std::chrono::duration_cast<std::chrono::seconds>(
+                        time_point.time_since_epoch())
+                        .count(),
+        std::memory_order_relaxed);
+}
+
+ROUTER_DECL void http_date::reset()
+{
+    s_seconds.store(0, std::memory_order_relaxed);
+}
+
+ROUTER_NAMESPACE_END()
@@ -19,8 +19,10 @@ template <class Body, class Version, class... Args,
 static typename details::message_creator<false, Body>::return_type
 create_response(http::status code, Version version, Args&&... args)
 {
-    return details::message_creator<false, Body>::create(
+    auto rp = details::message_creator<false, Body>::create(
         code, version, std::forward<Args>(args)...);
+    rp.set(http::field::date, http_date::now());
+    return rp;
 }
 
 template <class Body, class Version, class... Args,
@@ -49,6 +51,15 @@ static http_empty_response make_moved_response(Version version,
     return rp;
 }
 
+template <class Version>
+static http_empty_response make_event_stream_response(Version version)
+{
+    auto rp = make_empty_response(http::status::ok, version);
+    rp.set(http::field::content_type, "text/event-stream");
+    rp.set(http::field::cache_control, "no-cache");
+    return rp;
+}
+
 template <class Version>
 static http_string_response make_string_response(http::status code,
     Version version,
@@ -0,0 +1,272 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+ROUTER_NAMESPACE_BEGIN()
+
+ROUTER_DECL std::size_t latency_histogram::index(std::uint64_t value)
+{
+    value = std::min(value, max_value);
+
+    // the two low bits after the leading one select the linear bucket
+    std::size_t shift = 0;
+    while ((value >> shift) >= 2 * sub_buckets) {
+        ++shift;
+    }
+    return shift * sub_buckets + static_cast<std::size_t>(value >> shift);
+}
+
+ROUTER_DECL std::uint64_t latency_histogram::upper_bound(std::size_t idx)
+{
+    const std::size_t shift = idx < 2 * sub_buckets ? 0 : idx / sub_buckets - 1;
+    return (std::uint64_t { idx - shift * sub_buckets } + 1) << shift;
+}
+
+ROUTER_DECL void latency_histogram::record(std::uint64_t value)
+{
+    ++counts[index(value)];
+    ++count;
+    sum += value;
+}
+
+ROUTER_DECL std::uint64_t latency_histogram::value_at(double quantile) const
+{
+    if (count == 0) {
+        return 0;
+    }
+
+    const auto rank = std::max<std::uint64_t>(1,
+        static_cast<std::uint64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(count))));
+    std::uint64_t seen = 0;
+    for (std::size_t idx = 0; idx < buckets; ++idx) {
+        seen += counts[idx];
+        if (seen >= rank) {
+            return upper_bound(idx);
+        }
+    }
+    return upper_bound(buckets - 1);
+}
+
+ROUTER_DECL route_metrics::route_metrics(std::string method, std::string path, std::size_t shards)
+    : m_method { std::move(method) }
+    , m_path { std::move(path) }
+    , m_size { std::max<std::size_t>(shards, 1) }
+    , m_shards { std::make_unique<shard[]>(m_size) }
+{
+}
+
+ROUTER_DECL void route_metrics::request()
+{
+    this_shard().requests.fetch_add(1, std::memory_order_relaxed);
+}
+
+ROUTER_DECL void route_metrics::received(std::size_t bytes, duration_type parse)
+{
+    auto& counters = this_shard();
+    counters.bytes_in.fetch_add(bytes, std::memory_order_relaxed);
+    record(counters.parse, parse);
+}
+
+ROUTER_DECL void route_metrics::handled(duration_type handler)
+{
+    record(this_shard().handler, handler);
+}
+
+ROUTER_DECL void route_metrics::sent(unsigned status, std::size_t bytes, duration_type write)
+{
+    auto& counters = this_shard();
+    counters.bytes_out.fetch_add(bytes, std::memory_order_relaxed);
+    if (status >= 100 && status < 600) {
+        counters.responses[status / 100 - 1].fetch_add(1, std::memory_order_relaxed);
+        record(counters.write, write);
+    }
+}
+
+ROUTER_DECL route_metrics::snapshot_type route_metrics::snapshot() const
+{
+    snapshot_type result;
+    for (std::size_t idx = 0; idx < m_size; ++idx) {
+        const auto& counters = m_shards[idx];
+        result.requests += counters.requests.load(std::memory_order_relaxed);
+        for (std::size_t code = 0; code < result.responses.size(); ++code) {
+            result.responses[code] += counters.responses[code].load(std::memory_order_relaxed);
+        }
+        result.bytes_in += counters.bytes_in.load(std::memory_order_relaxed);
+        result.bytes_out += counters.bytes_out.load(std::memory_order_relaxed);
+        collect(counters.parse, result.parse);
+        collect(counters.handler, result.handler);
+        collect(counters.write, result.write);
+    }
+    return result;
+}
+
+ROUTER_DECL const std::string& route_metrics::method() const
+{
+    return m_method;
+}
+
+ROUTER_DECL const std::string& route_metrics::path() const
+{
+    return m_path;
+}
+
+ROUTER_DECL route_metrics::shard& route_metrics::this_shard()
+{
+    // a thread keeps its shard for the lifetime
+    static std::atomic<std::size_t> next { 0 };
+    thread_local const std::size_t idx = next.fetch_add(1, std::memory_order_relaxed);
+    return m_shards[idx % m_size];
+}
+
+ROUTER_DECL void route_metrics::record(histogram_counters& counters, duration_type value)
+{
+    const auto us = static_cast<std::uint64_t>(std::max<std::int64_t>(
+        static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(value).count()), 0));
+    counters.counts[latency_histogram::index(us)].fetch_add(1, std::memory_order_relaxed);
+    counters.sum.fetch_add(us, std::memory_order_relaxed);
+}
+
+ROUTER_DECL void route_metrics::collect(const histogram_counters& counters, latency_histogram& histogram)
+{
+    for (std::size_t idx = 0; idx < latency_histogram::buckets; ++idx) {
+        const auto value = counters.counts[idx].load(std::memory_order_relaxed);
+        histogram.counts[idx] += value;
+        histogram.count += value;
+    }
+    histogram.sum += counters.sum.load(std::memory_order_relaxed);
+}
+
+ROUTER_DECL metrics_registry::metrics_registry()
+    : metrics_registry { std::thread::hardware_concurrency() }
+{
+}
+
+ROUTER_DECL metrics_registry::metrics_registry(std::size_t shards)
+    : m_shards { std::max<std::size_t>(shards, 1) }
+    , m_mutex {}
+    , m_routes {}
+{
+}
+
+ROUTER_DECL std::shared_ptr<route_metrics> metrics_registry::route(const std::string& method,
+    const std::string& path)
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    auto& entry = m_routes[{ method, path }];
+    if (!entry) {
+        entry = std::make_shared<route_metrics>(method, path, m_shards);
+    }
+    return entry;
+}
+
+ROUTER_DECL std::vector<std::shared_ptr<route_metrics>> metrics_registry::routes() const
+{
+    std::vector<std::shared_ptr<route_metrics>> result;
+    std::lock_guard<std::mutex> lock { m_mutex };
+    result.reserve(m_routes.size());
+    for (const auto& entry : m_routes) {
+        result.push_back(entry.second);
+    }
+    return result;
+}
+
+ROUTER_DECL std::string metrics_registry::render() const
+{
+    const auto routes = this->routes();
+    std::vector<route_metrics::snapshot_type> snapshots;
+    snapshots.reserve(routes.size());
+    for (const auto& route : routes) {
+        snapshots.push_back(route->snapshot());
+    }
+
+    const auto escape = [](const std::string& value) {
+        std::string result;
+        result.reserve(value.size());
+        for (const auto ch : value) {
+            switch (ch) {
+            case '\\':
+                result += "\\\\";
+                break;
+            case '"':
+                result += "\\\"";
+                break;
+            case '\n':
+                result += "\\n";
+                break;
+            default:
+                result += ch;
+                break;
+            }
+        }
+        return result;
+    };
+
+    std::vector<std::string> labels;
+    labels.reserve(routes.size());
+    for (const auto& route : routes) {
+        labels.push_back("method=\"" + escape(route->method()) + "\",route=\"" + escape(route->path()) + "\"");
+    }
+
+    const auto seconds = [](std::uint64_t us) {
+        return std::to_string(us / 1000000) + "." + std::to_string(1000000 + us % 1000000).substr(1);
+    };
+
+    std::string result;
+    const auto counter = [&](const char* name, const char* help, auto&& value) {
+        result += std::string { "# HELP " } + name + " " + help + "\n";
+        result += std::string { "# TYPE " } + name + " counter\n";
+        for (std::size_t idx = 0; idx < routes.size(); ++idx) {
+            result += std::string { name } + "{" + labels[idx] + "} " + std::to_string(value(snapshots[idx])) + "\n";
+        }
+    };
+
+    const auto histogram = [&](const char* name, const char* help, auto&& value) {
+        result += std::string { "# HELP " } + name + " " + help + "\n";
+        result += std::string { "# TYPE " } + name + " histogram\n";
+        for (std::size_t idx = 0; idx < routes.size(); ++idx) {
+            const latency_histogram& hist = value(snapshots[idx]);
+            std::uint64_t cumulative = 0;
+            for (std::size_t bucket = 0; bucket < latency_histogram::buckets; ++bucket) {
+                cumulative += hist.counts[bucket];
+                // the last bucket of every power of two
+                if (bucket % latency_histogram::sub_buckets == latency_histogram::sub_buckets - 1) {
+                    result += std::string { name } + "_bucket{" + labels[idx] + ",le=\""
+                        + seconds(latency_histogram::upper_bound(bucket)) + "\"} " + std::to_string(cumulative) + "\n";
+                }
+            }
+            result += std::string { name } + "_bucket{" + labels[idx] + ",le=\"+Inf\"} " + std::to_string(hist.count) + "\n";
+            result += std::string { name } + "_sum{" + labels[idx] + "} " + seconds(hist.sum) + "\n";
+            result += std::string { name } + "_count{" + labels[idx] + "} " + std::to_string(hist.count) + "\n";
+        }
+    };
+
+    counter("beast_router_requests_total", "The number of the requests",
+        [](const auto& snapshot) { return snapshot.requests; });
+
+    result += "# HELP beast_router_responses_total The number of the responses per status class\n";
+    result += "# TYPE beast_router_responses_total counter\n";
+    for (std::size_t idx = 0; idx < routes.size(); ++idx) {
+        for (std::size_t code = 0; code < snapshots[idx].responses.size(); ++code) {
+            result += "beast_router_responses_total{" + labels[idx] + ",code=\"" + std::to_string(code + 1) + "xx\"} "
+                + std::to_string(snapshots[idx].responses[code]) + "\n";
+        }
+    }
+
+    counter("beast_router_received_bytes_total", "The number of the bytes read",
+        [](const auto& snapshot) { return snapshot.bytes_in; });
+    counter("beast_router_sent_bytes_total", "The number of the bytes written",
+        [](const auto& snapshot) { return snapshot.bytes_out; });
+
+    histogram("beast_router_parse_seconds", "The time from the first byte to the complete request",
+        [](const auto& snapshot) -> const latency_histogram& { return snapshot.parse; });
+    histogram("beast_router_handler_seconds", "The time the chain of handlers runs",
+        [](const auto& snapshot) -> const latency_histogram& { return snapshot.handler; });
+    histogram("beast_router_write_seconds", "The time a response is being written",
+        [](const auto& snapshot) -> const latency_histogram& { return snapshot.write; });
+
+    return result;
+}
+
+ROUTER_NAMESPACE_END()
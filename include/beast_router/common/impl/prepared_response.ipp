@@ -0,0 +1,83 @@
+#pragma once
+
+#include <boost/beast/http/write.hpp>
+#include <sstream>
+
+ROUTER_NAMESPACE_BEGIN()
+
+template <class Body, class Fields>
+prepared_response::prepared_response(boost::beast::http::response<Body, Fields> message)
+    : m_data {}
+    , m_keep_alive { message.keep_alive() }
+    , m_date {}
+{
+    message.erase(boost::beast::http::field::date);
+    message.erase(boost::beast::http::field::connection);
+
+    std::ostringstream o_str;
+    o_str << message;
+
+    auto bytes = o_str.str();
+    const auto pos = bytes.find("\r\n\r\n");
+    BOOST_ASSERT(pos != std::string::npos);
+
+    m_data = std::make_shared<const data>(data {
+        std::move(bytes), pos + 2, message.result(), message.version() });
+
+    date_prefix.copy(m_date.data(), date_prefix.size());
+    m_date[m_date.size() - 2] = '\r';
+    m_date[m_date.size() - 1] = '\n';
+}
+
+ROUTER_DECL prepared_response prepared_response::keep_alive(bool value) const
+{
+    auto ret = *this;
+    ret.m_keep_alive = value;
+    return ret;
+}
+
+ROUTER_DECL bool prepared_response::keep_alive() const
+{
+    return m_keep_alive;
+}
+
+ROUTER_DECL bool prepared_response::need_eof() const
+{
+    return !m_keep_alive;
+}
+
+ROUTER_DECL boost::beast::http::status prepared_response::result() const
+{
+    return m_data->result;
+}
+
+ROUTER_DECL unsigned prepared_response::version() const
+{
+    return m_data->version;
+}
+
+ROUTER_DECL std::string_view prepared_response::bytes() const
+{
+    return m_data->bytes;
+}
+
+ROUTER_DECL prepared_response::buffers_type prepared_response::buffers()
+{
+    static constexpr std::string_view keep_alive_field = "Connection: keep-alive\r\n";
+    static constexpr std::string_view close_field = "Connection: close\r\n";
+
+    http_date::now().copy(m_date.data() + date_prefix.size(), http_date::length);
+
+    const auto connection = m_keep_alive ? keep_alive_field : close_field;
+    const auto& bytes = m_data->bytes;
+
+    return {
+        boost::asio::buffer(bytes.data(), m_data->header_size),
+        boost::asio::buffer(m_date),
+        boost::asio::buffer(connection.data(), connection.size()),
+        boost::asio::buffer(bytes.data() + m_data->header_size,
+            bytes.size() - m_data->header_size)
+    };
+}
+
+ROUTER_NAMESPACE_END()
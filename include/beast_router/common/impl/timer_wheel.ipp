@@ -0,0 +1,229 @@
+#pragma once
+
+#include <algorithm>
+
+ROUTER_NAMESPACE_BEGIN()
+
+ROUTER_DECL timer_wheel::entry::~entry()
+{
+    if (auto* wheel = m_wheel.load(std::memory_order_acquire)) {
+        wheel->cancel(*this);
+    }
+}
+
+ROUTER_DECL timer_wheel::timer_wheel(boost::asio::execution_context& ctx)
+    : boost::asio::execution_context::service { ctx }
+    , m_mutex {}
+    , m_timer {}
+    , m_waiting { false }
+    , m_origin { clock_type::now() }
+    , m_current { 0 }
+    , m_size { 0 }
+    , m_levels {}
+    , m_batch {}
+{
+    for (auto& level : m_levels) {
+        for (auto& head : level) {
+            head.prev = head.next = &head;
+        }
+    }
+}
+
+template <class Executor>
+timer_wheel& timer_wheel::get(const Executor& executor)
+{
+    auto& wheel = boost::asio::use_service<timer_wheel>(executor.context());
+
+    std::lock_guard<std::mutex> lock { wheel.m_mutex };
+    if (!wheel.m_timer) {
+        wheel.m_timer.emplace(executor);
+    }
+    return wheel;
+}
+
+ROUTER_DECL void timer_wheel::arm(entry& ent, duration_type timeout, std::weak_ptr<void> owner)
+{
+    if (auto* wheel = ent.m_wheel.load(std::memory_order_acquire); wheel && wheel != this) {
+        wheel->cancel(ent);
+    }
+
+    const auto expiry = clock_type::now() + timeout;
+
+    std::lock_guard<std::mutex> lock { m_mutex };
+    if (ent.next) {
+        unlink(ent);
+    }
+
+    // an idle wheel skips the ticks gone by
+    if (!m_size && !m_waiting) {
+        m_current = std::max(m_current, to_tick(clock_type::now(), false));
+    }
+
+    ent.m_expiry = expiry;
+    ent.m_target = to_tick(expiry, true);
+    ent.m_owner = std::move(owner);
+    link(ent);
+    do_wait();
+}
+
+ROUTER_DECL bool timer_wheel::cancel(entry& ent)
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    // the expiration being delivered is recognized as the stale one
+    ent.m_expiry = (time_point_type::max)();
+    if (ent.m_wheel.load(std::memory_order_relaxed) != this || !ent.next) {
+        return false;
+    }
+
+    unlink(ent);
+    return true;
+}
+
+ROUTER_DECL std::size_t timer_wheel::size() const
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    return m_size;
+}
+
+ROUTER_DECL void timer_wheel::shutdown()
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    for (auto& level : m_levels) {
+        for (auto& head : level) {
+            while (head.next != &head) {
+                unlink(static_cast<entry&>(*head.next));
+            }
+        }
+    }
+    m_batch.clear();
+    m_timer.reset();
+}
+
+ROUTER_DECL std::uint64_t timer_wheel::to_tick(time_point_type time_point, bool round_up) const
+{
+    if (time_point <= m_origin) {
+        return 0;
+    }
+
+    const auto elapsed = time_point - m_origin;
+    const auto ticks = static_cast<std::uint64_t>(elapsed / tick);
+    return round_up && ticks * tick < elapsed ? ticks + 1 : ticks;
+}
+
+ROUTER_DECL void timer_wheel::link(entry& ent)
+{
+    // the expired entries go to the slot being processed next
+    auto target = std::max(ent.m_target, m_current);
+    auto delta = target - m_current;
+
+    std::size_t level = 0;
+    while (level + 1 < levels && delta >= (std::uint64_t { 1 } << (level_bits * (level + 1)))) {
+        ++level;
+    }
+
+    // the farthest deadlines wait in the last slot and are linked again
+    const auto range = std::uint64_t { 1 } << (level_bits * levels);
+    if (delta >= range) {
+        target = m_current + range - 1;
+    }
+
+    auto& head = m_levels[level][(target >> (level_bits * level)) & (slots - 1)];
+    ent.prev = head.prev;
+    ent.next = &head;
+    head.prev->next = &ent;
+    head.prev = &ent;
+
+    ent.m_wheel.store(this, std::memory_order_release);
+    ++m_size;
+}
+
+ROUTER_DECL void timer_wheel::unlink(entry& ent)
+{
+    ent.prev->next = ent.next;
+    ent.next->prev = ent.prev;
+    ent.prev = ent.next = nullptr;
+
+    ent.m_wheel.store(nullptr, std::memory_order_release);
+    --m_size;
+}
+
+ROUTER_DECL std::size_t timer_wheel::cascade(std::size_t level)
+{
+    const auto idx = (m_current >> (level_bits * level)) & (slots - 1);
+    auto& head = m_levels[level][idx];
+    while (head.next != &head) {
+        auto& ent = static_cast<entry&>(*head.next);
+        unlink(ent);
+        link(ent);
+    }
+    return idx;
+}
+
+ROUTER_DECL void timer_wheel::do_wait()
+{
+    if (m_waiting || !m_size || !m_timer) {
+        return;
+    }
+
+    m_waiting = true;
+    m_timer->expires_at(m_origin + tick * m_current);
+    m_timer->async_wait([this](boost::system::error_code ec) { on_tick(ec); });
+}
+
+ROUTER_DECL void timer_wheel::on_tick(boost::system::error_code ec)
+{
+    if (ec) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+
+        const auto now = to_tick(clock_type::now(), false);
+        while (m_current <= now) {
+            const auto idx = m_current & (slots - 1);
+            if (idx == 0) {
+                for (std::size_t level = 1; level < levels && cascade(level) == 0; ++level) {
+                }
+            }
+            ++m_current;
+
+            // the slot is detached so that the entries linked again do not
+            // return to it
+            node expired;
+            auto& head = m_levels[0][idx];
+            if (head.next == &head) {
+                continue;
+            }
+            expired.next = head.next;
+            expired.prev = head.prev;
+            expired.next->prev = expired.prev->next = &expired;
+            head.prev = head.next = &head;
+
+            while (expired.next != &expired) {
+                auto& ent = static_cast<entry&>(*expired.next);
+                unlink(ent);
+                if (ent.m_target >= m_current) {
+                    // the farthest deadline gets closer
+                    link(ent);
+                    continue;
+                }
+                if (auto owner = ent.m_owner.lock()) {
+                    m_batch.emplace_back(std::move(owner), &ent);
+                }
+            }
+        }
+    }
+
+    // the tick chain stays single while the batch is delivered
+    for (auto& [owner, ent] : m_batch) {
+        ent->on_expire();
+    }
+    m_batch.clear();
+
+    std::lock_guard<std::mutex> lock { m_mutex };
+    m_waiting = false;
+    do_wait();
+}
+
+ROUTER_NAMESPACE_END()
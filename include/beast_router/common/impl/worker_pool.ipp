@@ -0,0 +1,143 @@
+#pragma once
+
+ROUTER_NAMESPACE_BEGIN()
+
+ROUTER_DECL worker_pool::worker_pool(threads_num_type threads, on_error_type on_error)
+    : m_on_error { std::move(on_error) }
+    , m_queues {}
+    , m_threads {}
+    , m_pending { 0 }
+    , m_next { 0 }
+    , m_mutex {}
+    , m_cond {}
+    , m_stopped { false }
+{
+    BOOST_ASSERT(threads > 0);
+
+    m_queues.reserve(threads);
+    for (threads_num_type i = 0; i < threads; ++i) {
+        m_queues.push_back(std::make_unique<queue>());
+    }
+
+    m_threads.reserve(threads);
+    for (threads_num_type i = 0; i < threads; ++i) {
+        m_threads.emplace_back([this, i]() { run(i); });
+    }
+}
+
+ROUTER_DECL worker_pool::~worker_pool()
+{
+    stop();
+}
+
+template <class Func>
+void worker_pool::post(Func&& func)
+{
+    static_assert(std::is_invocable_v<Func>, "worker_pool::post requirements are not met");
+
+    push(task { std::forward<Func>(func) });
+}
+
+ROUTER_DECL void worker_pool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        m_stopped = true;
+    }
+    m_cond.notify_all();
+
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+ROUTER_DECL worker_pool::threads_num_type worker_pool::get_threads() const
+{
+    return static_cast<threads_num_type>(m_threads.size());
+}
+
+ROUTER_DECL std::size_t worker_pool::pending() const
+{
+    return m_pending.load(std::memory_order_relaxed);
+}
+
+ROUTER_DECL void worker_pool::push(task&& tsk)
+{
+    // the workers keep their own tasks local
+    const auto idx = t_pool == this
+        ? t_index
+        : m_next.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+    // counted before the task becomes visible to the thieves
+    m_pending.fetch_add(1, std::memory_order_release);
+    {
+        auto& que = *m_queues[idx];
+        std::lock_guard<std::mutex> lock { que.mutex };
+        que.tasks.push_back(std::move(tsk));
+    }
+
+    {
+        // pairs with the predicate check of the sleeping workers
+        std::lock_guard<std::mutex> lock { m_mutex };
+    }
+    m_cond.notify_one();
+}
+
+ROUTER_DECL bool worker_pool::try_pop(std::size_t idx, task& tsk)
+{
+    const auto size = m_queues.size();
+    for (std::size_t i = 0; i < size; ++i) {
+        auto& que = *m_queues[(idx + i) % size];
+        std::lock_guard<std::mutex> lock { que.mutex };
+        if (que.tasks.empty()) {
+            continue;
+        }
+
+        // the own queue is served from the front, the others are stolen
+        // from the back
+        if (i == 0) {
+            tsk = std::move(que.tasks.front());
+            que.tasks.pop_front();
+        } else {
+            tsk = std::move(que.tasks.back());
+            que.tasks.pop_back();
+        }
+        m_pending.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+ROUTER_DECL void worker_pool::run(std::size_t idx)
+{
+    t_pool = this;
+    t_index = idx;
+
+    for (;;) {
+        task tsk;
+        if (try_pop(idx, tsk)) {
+            try {
+                tsk();
+            } catch (...) {
+                if (m_on_error) {
+                    m_on_error(std::current_exception());
+                }
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock { m_mutex };
+        m_cond.wait(lock, [this]() {
+            return m_stopped || m_pending.load(std::memory_order_acquire) > 0;
+        });
+        if (m_stopped && m_pending.load(std::memory_order_acquire) == 0) {
+            break;
+        }
+    }
+
+    t_pool = nullptr;
+}
+
+ROUTER_NAMESPACE_END()
@@ -0,0 +1,266 @@
+#pragma once
+
+#include "../base/config.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+ROUTER_NAMESPACE_BEGIN()
+
+/// The log-linear histogram of latencies in microseconds
+/**
+ * The layout follows HdrHistogram: every power of two is split into
+ * @ref sub_buckets linear buckets, so the relative error stays within 25%
+ * from a microsecond up to @ref max_value whereas the histogram remains a
+ * fixed array of counters.
+ */
+class latency_histogram {
+public:
+    /// The number of the linear buckets per power of two
+    static constexpr std::size_t sub_buckets = 4;
+
+    /// The number of the buckets
+    static constexpr std::size_t buckets = 124;
+
+    /// The greatest value recorded as is; the greater ones are clamped
+    static constexpr std::uint64_t max_value = (std::uint64_t { 1 } << 32) - 1;
+
+    /// The counters type
+    using counts_type = std::array<std::uint64_t, buckets>;
+
+    /// Returns the bucket of the value
+    /**
+     * @param value The latency in microseconds
+     * @returns std::size_t
+     */
+    ROUTER_DECL static std::size_t index(std::uint64_t value);
+
+    /// Returns the exclusive upper bound of the bucket
+    /**
+     * @param idx The bucket
+     * @returns The latency in microseconds
+     */
+    ROUTER_DECL static std::uint64_t upper_bound(std::size_t idx);
+
+    /// Records the latency
+    /**
+     * @param value The latency in microseconds
+     * @returns void
+     */
+    ROUTER_DECL void record(std::uint64_t value);
+
+    /// Returns the latency the given part of the recorded ones do not exceed
+    /**
+     * @param quantile The part within [0, 1]
+     * @returns The upper bound of the bucket in microseconds; zero if empty
+     */
+    ROUTER_DECL std::uint64_t value_at(double quantile) const;
+
+    /// The number of the values per bucket
+    counts_type counts {};
+
+    /// The number of the values
+    std::uint64_t count = 0;
+
+    /// The sum of the values in microseconds
+    std::uint64_t sum = 0;
+};
+
+/// The counters of a route
+/**
+ * The counters are sharded per thread: a thread increments its own cache
+ * line by relaxed atomics and the readers sum up the shards, so the recording
+ * neither locks nor contends.
+ */
+class route_metrics {
+public:
+    /// The clock type
+    using clock_type = std::chrono::steady_clock;
+
+    /// The duration type
+    using duration_type = clock_type::duration;
+
+    /// The summed up counters
+    struct snapshot_type {
+        /// The number of the requests
+        std::uint64_t requests = 0;
+
+        /// The number of the responses per status class, `1xx` to `5xx`
+        std::array<std::uint64_t, 5> responses {};
+
+        /// The number of the bytes read
+        std::uint64_t bytes_in = 0;
+
+        /// The number of the bytes written
+        std::uint64_t bytes_out = 0;
+
+        /// The time from the first byte to the complete request
+        latency_histogram parse;
+
+        /// The time the chain of handlers runs
+        latency_histogram handler;
+
+        /// The time a response is being written
+        latency_histogram write;
+    };
+
+    /// Constructor
+    /**
+     * @param method The method label
+     * @param path The route label
+     * @param shards The number of the shards
+     */
+    ROUTER_DECL route_metrics(std::string method, std::string path, std::size_t shards);
+
+    /// Constructor (disallowed)
+    route_metrics(const route_metrics&) = delete;
+
+    /// Assignment (disallowed)
+    route_metrics& operator=(const route_metrics&) = delete;
+
+    /// Counts a request
+    /**
+     * @returns void
+     */
+    ROUTER_DECL void request();
+
+    /// Records a request being read
+    /**
+     * @param bytes The number of the bytes read
+     * @param parse The time from the first byte to the complete request
+     * @returns void
+     */
+    ROUTER_DECL void received(std::size_t bytes, duration_type parse);
+
+    /// Records the chain of handlers being run
+    /**
+     * @param handler The time the chain runs
+     * @returns void
+     */
+    ROUTER_DECL void handled(duration_type handler);
+
+    /// Records a write
+    /**
+     * @param status The status of the response; zero for a part of a response
+     * e.g. a chunk which only counts the bytes
+     * @param bytes The number of the bytes written
+     * @param write The time the write takes
+     * @returns void
+     */
+    ROUTER_DECL void sent(unsigned status, std::size_t bytes, duration_type write);
+
+    /// Sums up the shards
+    /**
+     * @returns @ref snapshot_type
+     */
+    ROUTER_DECL snapshot_type snapshot() const;
+
+    /// Returns the method label
+    ROUTER_DECL const std::string& method() const;
+
+    /// Returns the route label
+    ROUTER_DECL const std::string& path() const;
+
+private:
+    struct histogram_counters {
+        std::array<std::atomic<std::uint64_t>, latency_histogram::buckets> counts;
+        std::atomic<std::uint64_t> sum;
+    };
+
+    struct alignas(64) shard {
+        std::atomic<std::uint64_t> requests;
+        std::array<std::atomic<std::uint64_t>, 5> responses;
+        std::atomic<std::uint64_t> bytes_in;
+        std::atomic<std::uint64_t> bytes_out;
+        histogram_counters parse;
+        histogram_counters handler;
+        histogram_counters write;
+    };
+
+    ROUTER_DECL shard& this_shard();
+
+    ROUTER_DECL static void record(histogram_counters& counters, duration_type value);
+
+    ROUTER_DECL static void collect(const histogram_counters& counters, latency_histogram& histogram);
+
+    const std::string m_method;
+    const std::string m_path;
+    const std::size_t m_size;
+    std::unique_ptr<shard[]> m_shards;
+};
+
+/// Keeps the counters of the routes and renders them
+/**
+ * The router binds the @ref route_metrics of every route once the registry
+ * is set, see `router::metrics()`; the sessions record the counters then.
+ *
+ * @par Example
+ *
+ * @code
+ * auto registry = std::make_shared<beast_router::metrics_registry>();
+ * router.metrics(registry); // serves GET /metrics
+ * @endcode
+ */
+class metrics_registry {
+public:
+    /// The content type of the rendered metrics
+    static constexpr const char* content_type = "text/plain; version=0.0.4";
+
+    /// Constructor
+    /**
+     * The number of the shards is the number of the hardware threads
+     */
+    ROUTER_DECL metrics_registry();
+
+    /// Constructor
+    /**
+     * @param shards The number of the shards per route
+     */
+    ROUTER_DECL explicit metrics_registry(std::size_t shards);
+
+    /// Constructor (disallowed)
+    metrics_registry(const metrics_registry&) = delete;
+
+    /// Assignment (disallowed)
+    metrics_registry& operator=(const metrics_registry&) = delete;
+
+    /// Obtains the counters of the route, creates them once
+    /**
+     * @param method The method label
+     * @param path The route label
+     * @returns std::shared_ptr<route_metrics>
+     */
+    ROUTER_DECL std::shared_ptr<route_metrics> route(const std::string& method,
+        const std::string& path);
+
+    /// Returns the counters of all the routes
+    /**
+     * @returns std::vector<std::shared_ptr<route_metrics>>
+     */
+    ROUTER_DECL std::vector<std::shared_ptr<route_metrics>> routes() const;
+
+    /// Renders the counters in the Prometheus text format
+    /**
+     * The histograms are exported by the powers of two of the microseconds
+     *
+     * @returns std::string
+     */
+    ROUTER_DECL std::string render() const;
+
+private:
+    const std::size_t m_shards;
+    mutable std::mutex m_mutex;
+    std::map<std::pair<std::string, std::string>, std::shared_ptr<route_metrics>> m_routes;
+};
+
+ROUTER_NAMESPACE_END()
+
+#include "impl/metrics.ipp"
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../base/config.hpp"
+#include "http_date.hpp"
+#include <array>
+#include <boost/asio/buffer.hpp>
+#include <boost/beast/http/message.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+
+ROUTER_NAMESPACE_BEGIN()
+
+/// Immutable pre-serialized response
+/**
+ * The class serializes a response once on construction and shares the bytes
+ * among all the copies, hence it is suitable for hot constant responses such
+ * as health checks, redirects or errors. The `Date` and `Connection` fields
+ * are excluded from the serialized bytes and patched in on sending.
+ *
+ * @par Example
+ *
+ * @code
+ * static const beast_router::prepared_response moved {
+ *     beast_router::make_moved_response(11, "/index.html")
+ * };
+ * ...
+ * ctx.send(moved.keep_alive(rq.keep_alive()));
+ * @endcode
+ *
+ * @note The status line carries the version of the given message
+ */
+class prepared_response {
+public:
+    /// The buffers type used for writing
+    using buffers_type = std::array<boost::asio::const_buffer, 4>;
+
+    /// Constructor
+    /**
+     * @param message The response to be serialized
+     */
+    template <class Body, class Fields>
+    explicit prepared_response(boost::beast::http::response<Body, Fields> message);
+
+    /// Returns a copy sharing the serialized bytes within the given keep alive
+    /// semantic
+    /**
+     * @param value Whether the connection is kept alive
+     * @returns @ref prepared_response
+     */
+    [[nodiscard]] ROUTER_DECL prepared_response keep_alive(bool value) const;
+
+    /// Returns the keep alive semantic
+    [[nodiscard]] ROUTER_DECL bool keep_alive() const;
+
+    /// Returns true if the connection has to be closed after sending
+    [[nodiscard]] ROUTER_DECL bool need_eof() const;
+
+    /// Returns the response status code
+    [[nodiscard]] ROUTER_DECL boost::beast::http::status result() const;
+
+    /// Returns the HTTP version
+    [[nodiscard]] ROUTER_DECL unsigned version() const;
+
+    /// Returns the serialized bytes excluding the patched fields
+    [[nodiscard]] ROUTER_DECL std::string_view bytes() const;
+
+    /// Stamps the `Date` field and returns the buffers to be written
+    /**
+     * @returns @ref buffers_type referring to the internal data
+     */
+    ROUTER_DECL buffers_type buffers();
+
+private:
+    struct data {
+        std::string bytes;
+        std::size_t header_size;
+        boost::beast::http::status result;
+        unsigned version;
+    };
+
+    static constexpr std::string_view date_prefix = "Date: ";
+
+    std::shared_ptr<const data> m_data;
+    bool m_keep_alive;
+    std::array<char, date_prefix.size() + http_date::length + 2> m_date;
+};
+
+ROUTER_NAMESPACE_END()
+
+#include "impl/prepared_response.ipp"
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "../base/config.hpp"
+#include "admission_controller.hpp"
+#include "worker_pool.hpp"
+#include <memory>
+
+ROUTER_NAMESPACE_BEGIN()
+
+/// The options of a route
+/**
+ * @par Example
+ *
+ * @code
+ * auto pool = std::make_shared<beast_router::worker_pool>(8);
+ * router.get(R"(^/report$)", beast_router::route_options { pool },
+ *     [](const auto& rq, auto& ctx) {
+ *         // runs on the pool, the io threads stay free
+ *         ctx.send(make_report(rq));
+ *     });
+ * @endcode
+ */
+struct route_options {
+    /// The pool running the chain of handlers; the handlers run inline on the
+    /// io thread if not set
+    std::shared_ptr<worker_pool> offload = nullptr;
+
+    /// The priority of the route under the overload, see
+    /// @ref admission_controller
+    route_priority priority = route_priority::normal;
+};
+
+ROUTER_NAMESPACE_END()
@@ -2,6 +2,8 @@
 
 #include "../../base/config.hpp"
 #include "../../base/connection.hpp"
+#include "handshake_pool.hpp"
+#include "ktls.hpp"
 #include <boost/asio/ssl.hpp>
 
 #define SSL_CONNECTION_TEMPLATE_ATTRIBUTES Stream, CompletionExecutor
@@ -40,6 +42,9 @@ public:
      * This function is used to asynchronously perform an SSL handshake on the
      * stream and returns immediately
      *
+     * The handshake is made by the @ref handshake_pool attached to the
+     * context if any
+     *
      * @param type The type of handshaking to be performed
      * @param func The handler to be called when the handshake operation
      * completes. The equivalent function signature of the handler must be as the
@@ -52,6 +57,46 @@ public:
     template <class Function>
     void async_handshake(handshake_type type, Function&& func);
 
+    /// Offloads the writes to the kernel after the handshake
+    /**
+     * Made if @ref ktls is enabled for the context; the writes stay with
+     * OpenSSL otherwise or if the connection can not be offloaded
+     *
+     * @returns bool; true if offloaded
+     */
+    bool enable_ktls();
+
+    /// Obtains whether the writes are offloaded to the kernel
+    /**
+     * @returns bool
+     */
+    bool is_ktls() const;
+
+    /// Invokes the function with the stream the writes go to
+    /**
+     * The socket once the writes are offloaded, the ssl stream otherwise
+     *
+     * @param func The function taking the stream
+     * @returns void
+     */
+    template <class Function>
+    void with_write_stream(Function&& func);
+
+#if defined(ROUTER_HAS_SENDFILE)
+    /// Asynchronous file sender
+    /**
+     * Sends the file within the kernel; the writes are to be offloaded
+     *
+     * @param fd The file to be sent, not owned by the operation
+     * @param offset The starting offset within the file
+     * @param size The number of bytes to be sent
+     * @param func A reference to the callback
+     * @returns void
+     */
+    template <class Function>
+    void async_sendfile(int fd, std::uint64_t offset, std::uint64_t size, Function&& func);
+#endif
+
     /// Shutes down the connection
     /**
      * @param type The shutdown parameter
@@ -91,6 +136,8 @@ public:
 
 private:
     stream_type m_stream;
+    bool m_ktls;
+    bool m_pooled;
 };
 
 ROUTER_SSL_NAMESPACE_END()
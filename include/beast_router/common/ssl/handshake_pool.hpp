@@ -0,0 +1,151 @@
+#pragma once
+
+#include "../../base/config.hpp"
+#include <boost/asio/ssl/context.hpp>
+#include <boost/asio/ssl/stream_base.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <openssl/ssl.h>
+
+ROUTER_SSL_NAMESPACE_BEGIN()
+
+/// The settings of the handshake pool
+struct handshake_settings {
+    /// The number of threads making the handshakes
+    unsigned int threads = 2;
+
+    /// The number of handshakes in progress at once; the rest are queued
+    std::size_t max_concurrent = 64;
+};
+
+/// Makes the TLS handshakes on its own threads
+/**
+ * Once attached to the context, the handshakes of its connections are made
+ * by the pool: every step of the handshake, i.e. the key exchange and the
+ * signature, is computed on a pool thread, so a storm of the new connections
+ * does not delay the requests of the established ones on the io threads.
+ * Up to @ref handshake_settings::max_concurrent handshakes are in progress
+ * at once, the rest are started in turn as they complete.
+ *
+ * The handler of the handshake is invoked by its associated executor. The
+ * context keeps the pool alive. The class is thread safe.
+ *
+ * @par Example
+ *
+ * @code
+ * beast_router::ssl::handshake_pool::create({ 4, 256 })->attach(ssl_ctx);
+ * @endcode
+ */
+class handshake_pool : public std::enable_shared_from_this<handshake_pool> {
+public:
+    /// The self type
+    using self_type = handshake_pool;
+
+    /// The pool ptr type
+    using pool_ptr_type = std::shared_ptr<self_type>;
+
+    /// The handshake type
+    using handshake_type = boost::asio::ssl::stream_base::handshake_type;
+
+    /// The counters of the handshakes
+    struct stats_type {
+        /// The completed handshakes, either succeeded or failed
+        std::uint64_t handshakes = 0;
+
+        /// The handshakes which waited for a free slot
+        std::uint64_t queued = 0;
+
+        /// The handshakes in progress
+        std::size_t active = 0;
+
+        /// The handshakes waiting for a free slot
+        std::size_t waiting = 0;
+
+        /// The most handshakes in progress at once
+        std::size_t max_active = 0;
+    };
+
+    /// Constructor (disallowed)
+    handshake_pool(const handshake_pool&) = delete;
+
+    /// Assignment (disallowed)
+    self_type& operator=(const handshake_pool&) = delete;
+
+    /// Destructor; drops the queued handshakes and joins the threads
+    ~handshake_pool();
+
+    /// The pool factory method
+    /**
+     * @param settings The settings
+     * @returns `self_type::pool_ptr_type`
+     */
+    static pool_ptr_type create(const handshake_settings& settings = {});
+
+    /// Obtains the pool attached to the context
+    /**
+     * @param ctx The native handle of the context
+     * @returns `self_type::pool_ptr_type`; null if none
+     */
+    static pool_ptr_type get(SSL_CTX* ctx);
+
+    /// Attaches the pool to the context
+    /**
+     * @param ctx The context
+     * @returns void
+     */
+    void attach(boost::asio::ssl::context& ctx);
+
+    /// Asynchronous handshake
+    /**
+     * @param stream The ssl stream, to be kept alive by the handler
+     * @param type The type of handshaking to be performed
+     * @param handler The handler of the `void(error_code)` signature
+     * @returns void
+     */
+    template <class Stream, class Handler>
+    void async_handshake(Stream& stream, handshake_type type, Handler&& handler);
+
+    /// Returns the counters of the handshakes
+    /**
+     * @returns @ref stats_type
+     */
+    stats_type stats() const;
+
+    /// Returns the settings
+    /**
+     * @returns @ref handshake_settings
+     */
+    const handshake_settings& settings() const;
+
+protected:
+    /// Constructor
+    explicit handshake_pool(const handshake_settings& settings);
+
+private:
+    using start_type = std::function<void()>;
+
+    static int context_index();
+
+    template <class Stream, class Work, class Handler>
+    void do_handshake(Stream& stream, handshake_type type, Work work, std::shared_ptr<Handler> handler);
+
+    void do_start(start_type&& start);
+
+    void on_complete();
+
+    const handshake_settings m_settings;
+    boost::asio::thread_pool m_threads;
+    mutable std::mutex m_mutex;
+    std::deque<start_type> m_waiting;
+    stats_type m_stats;
+};
+
+ROUTER_SSL_NAMESPACE_END()
+
+#include "impl/handshake_pool.ipp"
@@ -11,6 +11,8 @@ connection<SSL_CONNECTION_TEMPLATE_ATTRIBUTES>::connection(
     : base::connection<connection<Stream, CompletionExecutor>,
         CompletionExecutor> { executor }
     , m_stream { std::move(stream), ctx }
+    , m_ktls { false }
+    , m_pooled { false }
 {
 }
 
@@ -33,14 +35,83 @@ void connection<SSL_CONNECTION_TEMPLATE_ATTRIBUTES>::async_handshake(
             std::is_invocable_v<Function, boost::system::error_code>>::value,
         "connection::async_handshake requirements are not met");
 
-    m_stream.async_handshake(
-        type, boost::asio::bind_executor(this->m_completion_executor, std::forward<Function>(func)));
+    auto* native = m_stream.native_handle();
+    auto pool = handshake_pool::get(SSL_get_SSL_CTX(native));
+    if (!pool) {
+        m_stream.async_handshake(
+            type, boost::asio::bind_executor(this->m_completion_executor, std::forward<Function>(func)));
+        return;
+    }
+
+    // the connection is not touched by the io threads meanwhile
+    m_pooled = true;
+    pool->async_handshake(m_stream, type,
+        boost::asio::bind_executor(this->m_completion_executor,
+            [this, func = std::forward<Function>(func)](boost::system::error_code ec) mutable {
+                m_pooled = false;
+                func(ec);
+            }));
+}
+
+SSL_CONNECTION_TEMPLATE_DECLARE
+bool connection<SSL_CONNECTION_TEMPLATE_ATTRIBUTES>::enable_ktls()
+{
+    auto* native = m_stream.native_handle();
+    if (!m_ktls && ktls::enabled(SSL_get_SSL_CTX(native))) {
+        m_ktls = ktls::offload(native, m_stream.next_layer().native_handle());
+    }
+    return m_ktls;
 }
 
+SSL_CONNECTION_TEMPLATE_DECLARE
+bool connection<SSL_CONNECTION_TEMPLATE_ATTRIBUTES>::is_ktls() const
+{
+    return m_ktls;
+}
+
+SSL_CONNECTION_TEMPLATE_DECLARE
+template <class Function>
+void connection<SSL_CONNECTION_TEMPLATE_ATTRIBUTES>::with_write_stream(
+    Function&& func)
+{
+    // the kernel encrypts the records written to the socket
+    if (m_ktls) {
+        func(m_stream.next_layer());
+    } else {
+        func(m_stream);
+    }
+}
+
+#if defined(ROUTER_HAS_SENDFILE)
+SSL_CONNECTION_TEMPLATE_DECLARE
+template <class Function>
+void connection<SSL_CONNECTION_TEMPLATE_ATTRIBUTES>::async_sendfile(
+    int fd, std::uint64_t offset, std::uint64_t size, Function&& func)
+{
+    static_assert(
+        std::is_invocable_v<Function, boost::system::error_code, size_t>,
+        "connection::async_sendfile/Function requirements are not met");
+    BOOST_ASSERT(m_ktls);
+
+    base::async_sendfile(
+        m_stream.next_layer(), fd, offset, size,
+        boost::asio::bind_executor(this->m_completion_executor,
+            std::forward<Function>(func)));
+}
+#endif
+
 SSL_CONNECTION_TEMPLATE_DECLARE
 boost::beast::error_code
 connection<SSL_CONNECTION_TEMPLATE_ATTRIBUTES>::shutdown(shutdown_type type)
 {
+    // no close notify is sent, the quiet shutdown keeps the session
+    // resumable instead of dropping it from the cache
+    auto* native = m_stream.native_handle();
+    if (!m_pooled && SSL_is_init_finished(native)) {
+        SSL_set_quiet_shutdown(native, 1);
+        SSL_shutdown(native);
+    }
+
     auto ec = boost::system::error_code {};
     m_stream.next_layer().shutdown(type, ec);
 
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/execution/outstanding_work.hpp>
+#include <boost/asio/prefer.hpp>
+#include <boost/beast/core/bind_handler.hpp>
+#include <type_traits>
+#include <utility>
+
+ROUTER_SSL_NAMESPACE_BEGIN()
+
+ROUTER_DECL handshake_pool::handshake_pool(const handshake_settings& settings)
+    : m_settings { settings }
+    , m_threads { std::max(settings.threads, 1u) }
+    , m_mutex {}
+    , m_waiting {}
+    , m_stats {}
+{
+}
+
+ROUTER_DECL handshake_pool::~handshake_pool()
+{
+    m_threads.stop();
+    m_threads.join();
+}
+
+ROUTER_DECL handshake_pool::pool_ptr_type handshake_pool::create(const handshake_settings& settings)
+{
+    struct enable_make_shared : public self_type {
+        explicit enable_make_shared(const handshake_settings& settings)
+            : self_type { settings }
+        {
+        }
+    };
+
+    return std::make_shared<enable_make_shared>(settings);
+}
+
+ROUTER_DECL handshake_pool::pool_ptr_type handshake_pool::get(SSL_CTX* ctx)
+{
+    const auto* pool = static_cast<pool_ptr_type*>(SSL_CTX_get_ex_data(ctx, context_index()));
+    return pool == nullptr ? nullptr : *pool;
+}
+
+ROUTER_DECL void handshake_pool::attach(boost::asio::ssl::context& ctx)
+{
+    auto* native = ctx.native_handle();
+    delete static_cast<pool_ptr_type*>(SSL_CTX_get_ex_data(native, context_index()));
+    SSL_CTX_set_ex_data(native, context_index(), new pool_ptr_type { shared_from_this() });
+}
+
+template <class Stream, class Handler>
+void handshake_pool::async_handshake(Stream& stream, handshake_type type, Handler&& handler)
+{
+    // the io context of the stream has no pending operation in between the
+    // steps made by the pool, it is kept running until the handler completes
+    auto work = boost::asio::prefer(stream.get_executor(),
+        boost::asio::execution::outstanding_work.tracked);
+
+    // the starts wait in the queue, the handler may be move only
+    auto state = std::make_shared<std::decay_t<Handler>>(std::forward<Handler>(handler));
+    do_start([this, &stream, type, work, state]() {
+        do_handshake(stream, type, work, state);
+    });
+}
+
+template <class Stream, class Work, class Handler>
+void handshake_pool::do_handshake(Stream& stream, handshake_type type, Work work,
+    std::shared_ptr<Handler> handler)
+{
+    // every step of the handshake is completed on the strand, the pool is
+    // kept alive by the context for as long as its connections
+    auto strand = boost::asio::make_strand(m_threads.get_executor());
+    boost::asio::dispatch(strand, [this, &stream, type, work, handler, strand]() {
+        stream.async_handshake(type,
+            boost::asio::bind_executor(strand, [this, work, handler](boost::system::error_code ec) {
+                on_complete();
+
+                const auto executor = boost::asio::get_associated_executor(*handler);
+                boost::asio::dispatch(executor,
+                    boost::beast::bind_front_handler(std::move(*handler), ec));
+            }));
+    });
+}
+
+ROUTER_DECL handshake_pool::stats_type handshake_pool::stats() const
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    auto stats = m_stats;
+    stats.waiting = m_waiting.size();
+    return stats;
+}
+
+ROUTER_DECL const handshake_settings& handshake_pool::settings() const
+{
+    return m_settings;
+}
+
+ROUTER_DECL int handshake_pool::context_index()
+{
+    static const int index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr,
+        [](void*, void* ptr, CRYPTO_EX_DATA*, int, long, void*) {
+            delete static_cast<pool_ptr_type*>(ptr);
+        });
+    return index;
+}
+
+ROUTER_DECL void handshake_pool::do_start(start_type&& start)
+{
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        if (m_settings.max_concurrent != 0 && m_stats.active >= m_settings.max_concurrent) {
+            m_waiting.push_back(std::move(start));
+            ++m_stats.queued;
+            return;
+        }
+        m_stats.max_active = std::max(m_stats.max_active, ++m_stats.active);
+    }
+    start();
+}
+
+ROUTER_DECL void handshake_pool::on_complete()
+{
+    start_type next;
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        ++m_stats.handshakes;
+        if (m_waiting.empty()) {
+            --m_stats.active;
+            return;
+        }
+
+        // the slot is handed over to the first waiting handshake
+        next = std::move(m_waiting.front());
+        m_waiting.pop_front();
+    }
+    next();
+}
+
+ROUTER_SSL_NAMESPACE_END()
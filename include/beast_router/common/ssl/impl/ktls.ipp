@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <openssl/crypto.h>
+#include <openssl/kdf.h>
+#include <vector>
+#if defined(ROUTER_HAS_KTLS)
+#include <linux/tls.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+ROUTER_SSL_NAMESPACE_BEGIN()
+
+ROUTER_DECL void ktls::enable(boost::asio::ssl::context& ctx, bool enabled)
+{
+    static bool tag = true;
+    SSL_CTX_set_ex_data(ctx.native_handle(), context_index(), enabled ? &tag : nullptr);
+}
+
+ROUTER_DECL bool ktls::enabled(SSL_CTX* ctx)
+{
+    return SSL_CTX_get_ex_data(ctx, context_index()) != nullptr;
+}
+
+ROUTER_DECL bool ktls::offload(SSL* ssl, int fd)
+{
+    if (do_offload(ssl, fd)) {
+        ++offloaded();
+        return true;
+    }
+    ++fallbacks();
+    return false;
+}
+
+ROUTER_DECL ktls::stats_type ktls::stats()
+{
+    return stats_type { offloaded().load(), fallbacks().load() };
+}
+
+ROUTER_DECL int ktls::context_index()
+{
+    static const int index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return index;
+}
+
+ROUTER_DECL bool ktls::do_offload(SSL* ssl, int fd)
+{
+#if defined(ROUTER_HAS_KTLS)
+    const auto* cipher = SSL_get_current_cipher(ssl);
+    if (unsupported() || SSL_version(ssl) != TLS1_2_VERSION || cipher == nullptr) {
+        return false;
+    }
+
+    std::size_t key_size = 0;
+    switch (SSL_CIPHER_get_cipher_nid(cipher)) {
+    case NID_aes_128_gcm:
+        key_size = TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+        break;
+    case NID_aes_256_gcm:
+        key_size = TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+        break;
+    default:
+        return false;
+    }
+
+    /// the records written by OpenSSL are to be sent before
+    if (BIO_ctrl_pending(SSL_get_wbio(ssl)) != 0) {
+        return false;
+    }
+
+    /// the key block of the AEAD ciphers (RFC 5246 6.3): the write keys
+    /// followed by the implicit nonces of the client and the server
+    constexpr std::size_t salt_size = TLS_CIPHER_AES_GCM_128_SALT_SIZE;
+    unsigned char master_key[SSL_MAX_MASTER_KEY_LENGTH];
+    const auto master_key_size = SSL_SESSION_get_master_key(SSL_get_session(ssl), master_key, sizeof(master_key));
+
+    unsigned char client_random[SSL3_RANDOM_SIZE];
+    unsigned char server_random[SSL3_RANDOM_SIZE];
+    SSL_get_client_random(ssl, client_random, sizeof(client_random));
+    SSL_get_server_random(ssl, server_random, sizeof(server_random));
+
+    std::vector<unsigned char> key_block(2 * (key_size + salt_size));
+    auto block_size = key_block.size();
+    auto* pctx = EVP_PKEY_CTX_new_id(EVP_PKEY_TLS1_PRF, nullptr);
+    static constexpr unsigned char label[] = "key expansion";
+    const auto derived = pctx != nullptr
+        && EVP_PKEY_derive_init(pctx) == 1
+        && EVP_PKEY_CTX_set_tls1_prf_md(pctx, SSL_CIPHER_get_handshake_digest(cipher)) == 1
+        && EVP_PKEY_CTX_set1_tls1_prf_secret(pctx, master_key, static_cast<int>(master_key_size)) == 1
+        && EVP_PKEY_CTX_add1_tls1_prf_seed(pctx, label, static_cast<int>(sizeof(label) - 1)) == 1
+        && EVP_PKEY_CTX_add1_tls1_prf_seed(pctx, server_random, sizeof(server_random)) == 1
+        && EVP_PKEY_CTX_add1_tls1_prf_seed(pctx, client_random, sizeof(client_random)) == 1
+        && EVP_PKEY_derive(pctx, key_block.data(), &block_size) == 1;
+    EVP_PKEY_CTX_free(pctx);
+    OPENSSL_cleanse(master_key, sizeof(master_key));
+    if (!derived) {
+        OPENSSL_cleanse(key_block.data(), key_block.size());
+        return false;
+    }
+
+    const auto server = SSL_is_server(ssl) == 1;
+    const auto* key = key_block.data() + (server ? key_size : 0);
+    const auto* salt = key_block.data() + 2 * key_size + (server ? salt_size : 0);
+
+    /// the Finished message is the only record written by the new keys, the
+    /// explicit nonces follow the sequence numbers (RFC 5288 3)
+    unsigned char sequence[TLS_CIPHER_AES_GCM_128_REC_SEQ_SIZE] = {};
+    sequence[sizeof(sequence) - 1] = 1;
+
+    union {
+        tls12_crypto_info_aes_gcm_128 aes_128;
+        tls12_crypto_info_aes_gcm_256 aes_256;
+    } info;
+    std::memset(&info, 0, sizeof(info));
+    socklen_t info_size = 0;
+    if (key_size == TLS_CIPHER_AES_GCM_128_KEY_SIZE) {
+        info.aes_128.info.version = TLS_1_2_VERSION;
+        info.aes_128.info.cipher_type = TLS_CIPHER_AES_GCM_128;
+        std::copy_n(key, key_size, info.aes_128.key);
+        std::copy_n(salt, salt_size, info.aes_128.salt);
+        std::copy_n(sequence, sizeof(sequence), info.aes_128.iv);
+        std::copy_n(sequence, sizeof(sequence), info.aes_128.rec_seq);
+        info_size = sizeof(info.aes_128);
+    } else {
+        info.aes_256.info.version = TLS_1_2_VERSION;
+        info.aes_256.info.cipher_type = TLS_CIPHER_AES_GCM_256;
+        std::copy_n(key, key_size, info.aes_256.key);
+        std::copy_n(salt, salt_size, info.aes_256.salt);
+        std::copy_n(sequence, sizeof(sequence), info.aes_256.iv);
+        std::copy_n(sequence, sizeof(sequence), info.aes_256.rec_seq);
+        info_size = sizeof(info.aes_256);
+    }
+    OPENSSL_cleanse(key_block.data(), key_block.size());
+
+    /// the kernel without the module fails every connection the same way
+    static constexpr char ulp[] = "tls";
+    if (::setsockopt(fd, SOL_TCP, TCP_ULP, ulp, sizeof(ulp)) != 0) {
+        if (errno == ENOENT || errno == EOPNOTSUPP) {
+            unsupported() = true;
+        }
+        OPENSSL_cleanse(&info, sizeof(info));
+        return false;
+    }
+
+    /// the upper layer without the keys passes the writes through
+    const auto configured = ::setsockopt(fd, SOL_TLS, TLS_TX, &info, info_size) == 0;
+    OPENSSL_cleanse(&info, sizeof(info));
+    if (!configured) {
+        return false;
+    }
+
+    SSL_set_options(ssl, SSL_OP_NO_RENEGOTIATION);
+    return true;
+#else
+    boost::ignore_unused(ssl, fd);
+    return false;
+#endif
+}
+
+ROUTER_DECL std::atomic<std::uint64_t>& ktls::offloaded()
+{
+    static std::atomic<std::uint64_t> counter { 0 };
+    return counter;
+}
+
+ROUTER_DECL std::atomic<std::uint64_t>& ktls::fallbacks()
+{
+    static std::atomic<std::uint64_t> counter { 0 };
+    return counter;
+}
+
+ROUTER_DECL std::atomic<bool>& ktls::unsupported()
+{
+    static std::atomic<bool> flag { false };
+    return flag;
+}
+
+ROUTER_SSL_NAMESPACE_END()
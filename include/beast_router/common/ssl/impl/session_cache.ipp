@@ -0,0 +1,266 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <openssl/rand.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#endif
+
+ROUTER_SSL_NAMESPACE_BEGIN()
+
+ROUTER_DECL session_cache::session_cache(const resumption_settings& settings)
+    : m_settings { settings }
+    , m_mutex {}
+    , m_sessions {}
+    , m_current_key {}
+    , m_previous_key {}
+    , m_rotated {}
+    , m_stats {}
+{
+}
+
+ROUTER_DECL session_cache::cache_ptr_type session_cache::create(const resumption_settings& settings)
+{
+    struct enable_make_shared : public self_type {
+        explicit enable_make_shared(const resumption_settings& settings)
+            : self_type { settings }
+        {
+        }
+    };
+
+    return std::make_shared<enable_make_shared>(settings);
+}
+
+ROUTER_DECL session_cache::cache_ptr_type session_cache::get(SSL_CTX* ctx)
+{
+    const auto* cache = static_cast<cache_ptr_type*>(SSL_CTX_get_ex_data(ctx, context_index()));
+    return cache == nullptr ? nullptr : *cache;
+}
+
+ROUTER_DECL void session_cache::attach(boost::asio::ssl::context& ctx)
+{
+    auto* native = ctx.native_handle();
+    delete static_cast<cache_ptr_type*>(SSL_CTX_get_ex_data(native, context_index()));
+    SSL_CTX_set_ex_data(native, context_index(), new cache_ptr_type { shared_from_this() });
+
+    static constexpr unsigned char id_context[] = "beast_router";
+    SSL_CTX_set_session_id_context(native, id_context, sizeof(id_context) - 1);
+    SSL_CTX_set_timeout(native, static_cast<long>(m_settings.session_timeout.count()));
+
+    if (m_settings.cache_size == 0) {
+        SSL_CTX_set_session_cache_mode(native, SSL_SESS_CACHE_OFF);
+    } else {
+        /// the client sessions are kept by the upstream, not by the context
+        SSL_CTX_set_session_cache_mode(native, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_CLIENT);
+        SSL_CTX_sess_set_cache_size(native, static_cast<long>(m_settings.cache_size));
+        SSL_CTX_sess_set_new_cb(native, &self_type::on_new_session);
+    }
+
+    if (!m_settings.tickets) {
+        SSL_CTX_set_options(native, SSL_OP_NO_TICKET);
+        return;
+    }
+
+    SSL_CTX_clear_options(native, SSL_OP_NO_TICKET);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    SSL_CTX_set_tlsext_ticket_key_evp_cb(native, &self_type::on_ticket_key);
+#else
+    SSL_CTX_set_tlsext_ticket_key_cb(native, &self_type::on_ticket_key);
+#endif
+}
+
+ROUTER_DECL void session_cache::resume(SSL* ssl, const std::string& upstream)
+{
+    const char* server_name = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
+    auto key = std::make_unique<std::string>(server_name == nullptr ? upstream : server_name);
+
+    std::lock_guard<std::mutex> lock { m_mutex };
+    const auto it = m_sessions.find(*key);
+    if (it != m_sessions.end()) {
+        const auto expires = SSL_SESSION_get_time(it->second.get()) + SSL_SESSION_get_timeout(it->second.get());
+        /// the connection is given a copy, the kept one is not invalidated with it
+        session_ptr offered { SSL_SESSION_dup(it->second.get()) };
+        if (offered && SSL_SESSION_is_resumable(it->second.get()) && std::time(nullptr) < expires
+            && SSL_set_session(ssl, offered.get()) == 1) {
+            ++m_stats.offered;
+        } else {
+            m_sessions.erase(it);
+        }
+    }
+
+    /// the upstream is known to the new session callback
+    delete static_cast<std::string*>(SSL_get_ex_data(ssl, upstream_index()));
+    SSL_set_ex_data(ssl, upstream_index(), key.release());
+}
+
+ROUTER_DECL void session_cache::on_handshake(SSL* ssl)
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    ++m_stats.handshakes;
+    if (SSL_session_reused(ssl)) {
+        ++m_stats.resumed;
+    }
+}
+
+ROUTER_DECL void session_cache::rotate_ticket_keys()
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    do_rotate(clock_type::now());
+}
+
+ROUTER_DECL void session_cache::clear()
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    m_sessions.clear();
+}
+
+ROUTER_DECL std::size_t session_cache::size() const
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    return m_sessions.size();
+}
+
+ROUTER_DECL session_cache::stats_type session_cache::stats() const
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    return m_stats;
+}
+
+ROUTER_DECL const resumption_settings& session_cache::settings() const
+{
+    return m_settings;
+}
+
+ROUTER_DECL int session_cache::context_index()
+{
+    static const int index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr,
+        [](void*, void* ptr, CRYPTO_EX_DATA*, int, long, void*) {
+            delete static_cast<cache_ptr_type*>(ptr);
+        });
+    return index;
+}
+
+ROUTER_DECL int session_cache::upstream_index()
+{
+    static const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr,
+        [](void*, void* ptr, CRYPTO_EX_DATA*, int, long, void*) {
+            delete static_cast<std::string*>(ptr);
+        });
+    return index;
+}
+
+ROUTER_DECL int session_cache::on_new_session(SSL* ssl, SSL_SESSION* session)
+{
+    /// the server sessions are kept by the context
+    const auto* upstream = static_cast<const std::string*>(SSL_get_ex_data(ssl, upstream_index()));
+    auto self = get(SSL_get_SSL_CTX(ssl));
+    if (SSL_is_server(ssl) || upstream == nullptr || self == nullptr || !SSL_SESSION_is_resumable(session)) {
+        return 0;
+    }
+
+    /// a copy is kept as the session of a connection closed without the
+    /// close notify is made not resumable
+    session_ptr copy { SSL_SESSION_dup(session) };
+    if (!copy) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock { self->m_mutex };
+    if (self->m_sessions.size() >= self->m_settings.cache_size
+        && self->m_sessions.find(*upstream) == self->m_sessions.end()) {
+        self->m_sessions.erase(self->m_sessions.begin());
+    }
+
+    self->m_sessions[*upstream] = std::move(copy);
+    return 0;
+}
+
+ROUTER_DECL int session_cache::on_ticket_key(SSL* ssl, unsigned char* name, unsigned char* iv,
+    EVP_CIPHER_CTX* cipher_ctx, mac_context_type* mac_ctx, int enc)
+{
+    auto self = get(SSL_get_SSL_CTX(ssl));
+    if (self == nullptr) {
+        return -1;
+    }
+    return self->do_ticket_key(name, iv, cipher_ctx, mac_ctx, enc);
+}
+
+ROUTER_DECL int session_cache::do_ticket_key(unsigned char* name, unsigned char* iv,
+    EVP_CIPHER_CTX* cipher_ctx, mac_context_type* mac_ctx, int enc)
+{
+    ticket_key key;
+    bool renew = false;
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        const auto now = clock_type::now();
+        if (!m_current_key || now - m_rotated >= m_settings.ticket_key_lifetime) {
+            do_rotate(now);
+        }
+        if (!m_current_key) {
+            return -1;
+        }
+
+        if (enc == 1) {
+            key = *m_current_key;
+            std::memcpy(name, key.name.data(), key.name.size());
+        } else if (std::memcmp(name, m_current_key->name.data(), m_current_key->name.size()) == 0) {
+            key = *m_current_key;
+        } else if (m_previous_key
+            && std::memcmp(name, m_previous_key->name.data(), m_previous_key->name.size()) == 0) {
+            /// the ticket is accepted and renewed by the current key
+            key = *m_previous_key;
+            renew = true;
+        } else {
+            /// unknown key, the full handshake is made
+            return 0;
+        }
+    }
+
+    if (enc == 1 && RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc())) != 1) {
+        return -1;
+    }
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    char digest[] = "SHA256";
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, key.hmac_key.data(), key.hmac_key.size()),
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digest, 0),
+        OSSL_PARAM_construct_end()
+    };
+    if (EVP_MAC_CTX_set_params(mac_ctx, params) != 1) {
+        return -1;
+    }
+#else
+    if (HMAC_Init_ex(mac_ctx, key.hmac_key.data(), static_cast<int>(key.hmac_key.size()), EVP_sha256(), nullptr) != 1) {
+        return -1;
+    }
+#endif
+
+    const int ret = enc == 1
+        ? EVP_EncryptInit_ex(cipher_ctx, EVP_aes_256_cbc(), nullptr, key.aes_key.data(), iv)
+        : EVP_DecryptInit_ex(cipher_ctx, EVP_aes_256_cbc(), nullptr, key.aes_key.data(), iv);
+    if (ret != 1) {
+        return -1;
+    }
+    return renew ? 2 : 1;
+}
+
+ROUTER_DECL void session_cache::do_rotate(clock_type::time_point now)
+{
+    ticket_key key;
+    if (RAND_bytes(key.name.data(), static_cast<int>(key.name.size())) != 1
+        || RAND_bytes(key.aes_key.data(), static_cast<int>(key.aes_key.size())) != 1
+        || RAND_bytes(key.hmac_key.data(), static_cast<int>(key.hmac_key.size())) != 1) {
+        return;
+    }
+
+    m_previous_key = std::move(m_current_key);
+    m_current_key = key;
+    m_rotated = now;
+    ++m_stats.key_rotations;
+}
+
+ROUTER_SSL_NAMESPACE_END()
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "../../base/config.hpp"
+#include <atomic>
+#include <boost/asio/ssl/context.hpp>
+#include <cstdint>
+#include <openssl/ssl.h>
+
+#if defined(__linux__) && __has_include(<linux/tls.h>)
+/// Defined if the kernel TLS offload may be requested i.e. the kernel headers
+/// declare the TLS upper layer protocol
+#define ROUTER_HAS_KTLS 1
+#endif
+
+ROUTER_SSL_NAMESPACE_BEGIN()
+
+/// Offloads the record encryption of the writes to the kernel (kTLS)
+/**
+ * The handshake and the reads are made by OpenSSL as before. Once the
+ * handshake of a connection of the enabled context completes, the traffic
+ * keys of the writing direction are handed over to the kernel, the writes go
+ * to the socket as is and the file bodies are sent by `sendfile`.
+ *
+ * The engine of `boost::asio::ssl::stream` works over the memory BIOs, the
+ * kTLS of OpenSSL itself needs the socket BIO, so the kernel is set up here.
+ * TLS 1.2 with the AES-GCM ciphers is offloaded only, as the state of its
+ * writing direction is known right after the handshake; the connections of
+ * the rest, of the kernel without the `tls` module or of a failed set up are
+ * served by OpenSSL.
+ *
+ * The offloaded connections do not renegotiate.
+ *
+ * @par Example
+ *
+ * @code
+ * beast_router::ssl::ktls::enable(ssl_ctx);
+ * @endcode
+ */
+class ktls {
+public:
+    /// The counters of the handshakes of the enabled contexts
+    struct stats_type {
+        /// The connections offloaded to the kernel
+        std::uint64_t offloaded = 0;
+
+        /// The connections served by OpenSSL
+        std::uint64_t fallbacks = 0;
+    };
+
+    /// Enables the offload of the connections of the context
+    /**
+     * @param ctx The context
+     * @param enabled Whether enabled
+     * @returns void
+     */
+    static void enable(boost::asio::ssl::context& ctx, bool enabled = true);
+
+    /// Obtains whether the offload of the connections of the context is enabled
+    /**
+     * @param ctx The native handle of the context
+     * @returns bool
+     */
+    static bool enabled(SSL_CTX* ctx);
+
+    /// Hands the writing direction of the connection over to the kernel
+    /**
+     * @param ssl The connection after the handshake
+     * @param fd The socket of the connection
+     * @returns bool; false if the connection stays with OpenSSL
+     */
+    static bool offload(SSL* ssl, int fd);
+
+    /// Returns the counters of the handshakes
+    /**
+     * @returns @ref stats_type
+     */
+    static stats_type stats();
+
+private:
+    static int context_index();
+
+    static bool do_offload(SSL* ssl, int fd);
+
+    static std::atomic<std::uint64_t>& offloaded();
+
+    static std::atomic<std::uint64_t>& fallbacks();
+
+    static std::atomic<bool>& unsupported();
+};
+
+ROUTER_SSL_NAMESPACE_END()
+
+#include "impl/ktls.ipp"
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "../../base/config.hpp"
+#include <array>
+#include <boost/asio/ssl/context.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#if OPENSSL_VERSION_NUMBER < 0x30000000L
+#include <openssl/hmac.h>
+#endif
+
+ROUTER_SSL_NAMESPACE_BEGIN()
+
+/// The settings of the TLS session resumption
+struct resumption_settings {
+    /// The number of the sessions cached by the server and of the upstream
+    /// sessions kept by the client; not cached if zero
+    std::size_t cache_size = 20480;
+
+    /// The time a session may be resumed within
+    std::chrono::seconds session_timeout { 300 };
+
+    /// Whether the server issues the session tickets
+    bool tickets = true;
+
+    /// The time a ticket key encrypts the new tickets for; the tickets of
+    /// the previous key are accepted and renewed for as long
+    std::chrono::seconds ticket_key_lifetime { 3600 };
+};
+
+/// Resumes the TLS sessions instead of the full handshakes
+/**
+ * Once attached to the context, the server caches the sessions and issues
+ * the session tickets encrypted by the keys rotated every
+ * @ref resumption_settings::ticket_key_lifetime. The client keeps the last
+ * session of every upstream, keyed by the SNI host name if set otherwise by
+ * the peer address and port, and offers it on the next handshake with the
+ * upstream. The sessions of the context count the handshakes either way.
+ *
+ * The context keeps the cache alive. The class is thread safe.
+ *
+ * @par Example
+ *
+ * @code
+ * beast_router::ssl::session_cache::create()->attach(ssl_ctx);
+ * ...
+ * const auto hit_rate = beast_router::ssl::session_cache::get(ssl_ctx.native_handle())->stats().hit_rate();
+ * @endcode
+ */
+class session_cache : public std::enable_shared_from_this<session_cache> {
+public:
+    /// The self type
+    using self_type = session_cache;
+
+    /// The cache ptr type
+    using cache_ptr_type = std::shared_ptr<self_type>;
+
+    /// The clock type
+    using clock_type = std::chrono::steady_clock;
+
+    /// The counters of the handshakes
+    struct stats_type {
+        /// The completed handshakes
+        std::uint64_t handshakes = 0;
+
+        /// The completed handshakes which resumed a session
+        std::uint64_t resumed = 0;
+
+        /// The client handshakes which offered a cached session
+        std::uint64_t offered = 0;
+
+        /// The rotations of the ticket keys
+        std::uint64_t key_rotations = 0;
+
+        /// Returns the share of the resumed handshakes
+        double hit_rate() const
+        {
+            return handshakes == 0 ? 0.0 : static_cast<double>(resumed) / static_cast<double>(handshakes);
+        }
+    };
+
+    /// Constructor (disallowed)
+    session_cache(const session_cache&) = delete;
+
+    /// Assignment (disallowed)
+    self_type& operator=(const session_cache&) = delete;
+
+    /// The cache factory method
+    /**
+     * @param settings The settings
+     * @returns `self_type::cache_ptr_type`
+     */
+    static cache_ptr_type create(const resumption_settings& settings = {});
+
+    /// Obtains the cache attached to the context
+    /**
+     * @param ctx The native handle of the context
+     * @returns `self_type::cache_ptr_type`; null if none
+     */
+    static cache_ptr_type get(SSL_CTX* ctx);
+
+    /// Attaches the cache to the context
+    /**
+     * The session caching, the tickets and the timeout of the context are
+     * set up by the settings, replacing the cache attached before if any
+     *
+     * @param ctx The context
+     * @returns void
+     */
+    void attach(boost::asio::ssl::context& ctx);
+
+    /// Offers the cached session of the upstream to the client handshake
+    /**
+     * @param ssl The connection to handshake
+     * @param upstream The key of the upstream unless the SNI host name is set
+     * @returns void
+     */
+    void resume(SSL* ssl, const std::string& upstream);
+
+    /// Counts the completed handshake
+    /**
+     * @param ssl The connection
+     * @returns void
+     */
+    void on_handshake(SSL* ssl);
+
+    /// Starts encrypting the new tickets by a new key
+    /**
+     * @returns void
+     */
+    void rotate_ticket_keys();
+
+    /// Drops the upstream sessions
+    /**
+     * @returns void
+     */
+    void clear();
+
+    /// Returns the number of the upstream sessions
+    /**
+     * @returns std::size_t
+     */
+    std::size_t size() const;
+
+    /// Returns the counters of the handshakes
+    /**
+     * @returns @ref stats_type
+     */
+    stats_type stats() const;
+
+    /// Returns the settings
+    /**
+     * @returns @ref resumption_settings
+     */
+    const resumption_settings& settings() const;
+
+protected:
+    /// Constructor
+    explicit session_cache(const resumption_settings& settings);
+
+private:
+    struct ticket_key {
+        std::array<unsigned char, 16> name;
+        std::array<unsigned char, 32> aes_key;
+        std::array<unsigned char, 32> hmac_key;
+    };
+
+    struct session_deleter {
+        void operator()(SSL_SESSION* session) const { SSL_SESSION_free(session); }
+    };
+
+    using session_ptr = std::unique_ptr<SSL_SESSION, session_deleter>;
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    using mac_context_type = EVP_MAC_CTX;
+#else
+    using mac_context_type = HMAC_CTX;
+#endif
+
+    static int context_index();
+
+    static int upstream_index();
+
+    static int on_new_session(SSL* ssl, SSL_SESSION* session);
+
+    static int on_ticket_key(SSL* ssl, unsigned char* name, unsigned char* iv,
+        EVP_CIPHER_CTX* cipher_ctx, mac_context_type* mac_ctx, int enc);
+
+    int do_ticket_key(unsigned char* name, unsigned char* iv, EVP_CIPHER_CTX* cipher_ctx,
+        mac_context_type* mac_ctx, int enc);
+
+    void do_rotate(clock_type::time_point now);
+
+    const resumption_settings m_settings;
+    mutable std::mutex m_mutex;
+    std::map<std::string, session_ptr> m_sessions;
+    std::optional<ticket_key> m_current_key;
+    std::optional<ticket_key> m_previous_key;
+    clock_type::time_point m_rotated;
+    stats_type m_stats;
+};
+
+ROUTER_SSL_NAMESPACE_END()
+
+#include "impl/session_cache.ipp"
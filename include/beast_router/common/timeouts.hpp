@@ -0,0 +1,53 @@
+#pragma once
+
+#include "../base/config.hpp"
+#include <chrono>
+#include <cstddef>
+
+ROUTER_NAMESPACE_BEGIN()
+
+/// The deadlines of the phases of a session
+/**
+ * Each phase is bounded separately, so that a slow but progressing upload is
+ * not killed whereas a connection trickling its header is. A zero value
+ * disables the corresponding deadline.
+ *
+ * @par Example
+ *
+ * @code
+ * beast_router::timeouts timeouts;
+ * timeouts.first_byte = 10s;
+ * timeouts.header = 5s;
+ * timeouts.idle = 30s;
+ * timeouts.min_body_rate = 1024;
+ * timeouts.body_grace = 5s;
+ * timeouts.write_stall = 10s;
+ *
+ * http_server_type::recv(std::piecewise_construct, std::move(socket), router,
+ *     timeouts, on_error);
+ * @endcode
+ */
+struct timeouts {
+    /// The duration type
+    using duration_type = std::chrono::steady_clock::duration;
+
+    /// The time to the first byte of the first request of a connection
+    duration_type first_byte = duration_type::zero();
+
+    /// The time to complete the header of a request, counted from its first byte
+    duration_type header = duration_type::zero();
+
+    /// The time to the first byte of the next request of a kept alive connection
+    duration_type idle = duration_type::zero();
+
+    /// The minimal transfer rate of a request body, in bytes per second
+    std::size_t min_body_rate = 0;
+
+    /// The time given to a request body before its rate is enforced
+    duration_type body_grace = duration_type::zero();
+
+    /// The time a response may be written without progress
+    duration_type write_stall = duration_type::zero();
+};
+
+ROUTER_NAMESPACE_END()
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "../base/config.hpp"
+#include <array>
+#include <atomic>
+#include <boost/asio/execution_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+ROUTER_NAMESPACE_BEGIN()
+
+/// The hierarchical timing wheel keeping the deadlines of the sessions
+/**
+ * The wheel is a service of the io context, i.e. a single wheel serves all
+ * the sessions of an io context; with the @ref event_loop::topology::per_core
+ * topology this is a wheel per thread.
+ *
+ * The deadlines are rounded up to the @ref tick and kept in the intrusive
+ * lists of the @ref levels wheels having @ref slots slots each; the farther
+ * deadlines are cascaded down to the lower levels as the time goes. Arming and
+ * cancelling an @ref entry is O(1) and does not allocate.
+ *
+ * A single asio timer ticks the wheel while there are armed entries. All the
+ * entries expired by a tick are collected first and then delivered as a batch
+ * by calling @ref entry::on_expire() out of the lock of the wheel.
+ *
+ * @par Example
+ *
+ * @code
+ * struct deadline : beast_router::timer_wheel::entry {
+ *     void on_expire() override { ... }
+ * };
+ *
+ * auto& wheel = beast_router::timer_wheel::get(ioc.get_executor());
+ * wheel.arm(dl, std::chrono::seconds { 5 }, owner);
+ * @endcode
+ */
+class timer_wheel : public boost::asio::execution_context::service {
+    struct node {
+        node* prev = nullptr;
+        node* next = nullptr;
+    };
+
+public:
+    /// The clock type
+    using clock_type = std::chrono::steady_clock;
+
+    /// The time point type
+    using time_point_type = clock_type::time_point;
+
+    /// The duration type
+    using duration_type = clock_type::duration;
+
+    /// The resolution of the wheel
+    static constexpr std::chrono::milliseconds tick { 10 };
+
+    /// The number of bits addressing the slots of a level
+    static constexpr std::size_t level_bits = 6;
+
+    /// The number of slots per level
+    static constexpr std::size_t slots = std::size_t { 1 } << level_bits;
+
+    /// The number of levels
+    static constexpr std::size_t levels = 4;
+
+    /// The service id
+    static inline boost::asio::execution_context::id id {};
+
+    /// The deadline registered in the wheel
+    /**
+     * The entry is meant to be a member of the object it belongs to; the
+     * owner passed to @ref timer_wheel::arm() keeps it alive while the
+     * expiration is being delivered.
+     */
+    class entry : node {
+        friend class timer_wheel;
+
+    public:
+        /// Constructor
+        entry() = default;
+
+        /// Constructor (disallowed)
+        entry(const entry&) = delete;
+
+        /// Assignment (disallowed)
+        entry& operator=(const entry&) = delete;
+
+        /// Destructor; cancels the entry
+        ROUTER_DECL virtual ~entry();
+
+        /// Returns the deadline
+        /**
+         * @returns @ref time_point_type
+         */
+        time_point_type expiry() const { return m_expiry; }
+
+    protected:
+        /// Called once the deadline is reached
+        /**
+         * The call is made on the thread ticking the wheel
+         *
+         * @returns void
+         */
+        virtual void on_expire() = 0;
+
+    private:
+        std::atomic<timer_wheel*> m_wheel { nullptr };
+        std::uint64_t m_target { 0 };
+        time_point_type m_expiry { (time_point_type::max)() };
+        std::weak_ptr<void> m_owner {};
+    };
+
+    /// Constructor
+    /**
+     * @param ctx The execution context which owns the service
+     */
+    ROUTER_DECL explicit timer_wheel(boost::asio::execution_context& ctx);
+
+    /// Returns the wheel of the executor's context
+    /**
+     * @param executor The executor of the io context
+     * @returns timer_wheel&
+     */
+    template <class Executor>
+    static timer_wheel& get(const Executor& executor);
+
+    /// Arms the entry; re-arms the already armed one
+    /**
+     * @param ent The entry
+     * @param timeout The duration until the deadline
+     * @param owner The object owning the entry
+     * @returns void
+     */
+    ROUTER_DECL void arm(entry& ent, duration_type timeout, std::weak_ptr<void> owner);
+
+    /// Cancels the entry
+    /**
+     * @param ent The entry
+     * @returns Whether the entry was armed
+     */
+    ROUTER_DECL bool cancel(entry& ent);
+
+    /// Returns the number of armed entries
+    /**
+     * @returns std::size_t
+     */
+    ROUTER_DECL std::size_t size() const;
+
+private:
+    using list_type = std::array<node, slots>;
+
+    ROUTER_DECL void shutdown() override;
+
+    ROUTER_DECL std::uint64_t to_tick(time_point_type time_point, bool round_up) const;
+
+    ROUTER_DECL void link(entry& ent);
+
+    ROUTER_DECL void unlink(entry& ent);
+
+    ROUTER_DECL std::size_t cascade(std::size_t level);
+
+    ROUTER_DECL void do_wait();
+
+    ROUTER_DECL void on_tick(boost::system::error_code ec);
+
+    mutable std::mutex m_mutex;
+    std::optional<boost::asio::steady_timer> m_timer;
+    bool m_waiting;
+    time_point_type m_origin;
+    std::uint64_t m_current;
+    std::size_t m_size;
+    std::array<list_type, levels> m_levels;
+    std::vector<std::pair<std::shared_ptr<void>, entry*>> m_batch;
+};
+
+ROUTER_NAMESPACE_END()
+
+#include "impl/timer_wheel.ipp"
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../base/config.hpp"
+#include <chrono>
+
+ROUTER_NAMESPACE_BEGIN()
+
+/// The points of the request processing reported to a tracer
+enum class trace_point {
+    /// The session is created on the accepted or connected socket
+    accept,
+    /// The TLS handshake is done
+    handshake,
+    /// The header of a message is parsed
+    header,
+    /// The message is read completely
+    body,
+    /// The message is matched to a route
+    route,
+    /// The chain of handlers returned; for an offloaded route the point is
+    /// delivered on the strand of the session but stamped on the pool
+    handler,
+    /// A write is started; a streamed response is written piecewise
+    write_start,
+    /// A write is finished
+    write_end
+};
+
+/// The tracer of the sessions which compiles to nothing
+/**
+ * A tracer is a default constructible type providing
+ *
+ * @code
+ * void trace(beast_router::trace_point point, std::chrono::steady_clock::time_point at);
+ * @endcode
+ *
+ * and passed as the last template parameter of the session. Every session
+ * owns its tracer which is called on the strand of the session only; the
+ * handlers reach it by `context::tracer()`.
+ *
+ * @par Example
+ *
+ * @code
+ * struct timeline {
+ *     void trace(beast_router::trace_point point, std::chrono::steady_clock::time_point at)
+ *     {
+ *         samples.emplace_back(point, at);
+ *         if (point == beast_router::trace_point::write_end) {
+ *             collector().ship(std::exchange(samples, {}));
+ *         }
+ *     }
+ *
+ *     std::vector<std::pair<beast_router::trace_point, std::chrono::steady_clock::time_point>> samples;
+ * };
+ *
+ * using traced_server_type = beast_router::session<true, beast_router::http::string_body,
+ *     boost::beast::flat_buffer, boost::asio::ip::tcp,
+ *     boost::asio::basic_stream_socket<boost::asio::ip::tcp>,
+ *     beast_router::connection<boost::asio::basic_stream_socket<boost::asio::ip::tcp>,
+ *         beast_router::base::strand_stream::asio_type>,
+ *     timeline>;
+ * @endcode
+ */
+struct null_tracer {
+    /// The clock type
+    using clock_type = std::chrono::steady_clock;
+
+    /// Ignores the point
+    void trace(trace_point, clock_type::time_point) noexcept { }
+};
+
+ROUTER_NAMESPACE_END()
@@ -56,6 +56,23 @@ struct is_class_creatable {
     enum { value = sizeof(test<Class, Args...>(0) == sizeof(one)) };
 };
 
+template <class T, class = void>
+struct has_context_selector : std::false_type { };
+
+template <class T>
+struct has_context_selector<T,
+    std::void_t<decltype(std::declval<T&>().get_context()),
+        decltype(std::declval<T&>().get_context(std::size_t {})),
+        decltype(std::declval<T&>().get_contexts())>> : std::true_type {
+};
+
+template <class T, class = void>
+struct is_traced : std::false_type { };
+
+template <class T>
+struct is_traced<T, std::void_t<typename T::is_traced>> : T::is_traced {
+};
+
 } // namespace details
 
 /// Type Trait for testing chrono duration
@@ -70,6 +87,15 @@ constexpr bool is_all_true_v = details::is_all_true<V...>::value;
 template <class Class, class... Args>
 constexpr bool is_class_creatable_v = details::is_class_creatable<Class, Args...>::value;
 
+/// Type Trait for testing whether an event loop distributes the work among
+/// several io contexts
+template <class T>
+constexpr bool has_context_selector_v = details::has_context_selector<T>::value;
+
+/// Type Trait for testing whether a session reports to a tracer
+template <class T>
+constexpr bool is_traced_v = details::is_traced<T>::value;
+
 /// Type Trait for unpack a function return value
 template <class T>
 using func_traits_result_t =
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "../base/config.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+ROUTER_NAMESPACE_BEGIN()
+
+/// The pool of threads executing the blocking tasks
+/**
+ * Every worker owns a queue and takes the tasks from it; once the queue is
+ * empty, the worker steals the tasks from the queues of the others. The tasks
+ * posted by a worker are queued locally whereas the rest are spread among the
+ * queues in turn.
+ *
+ * The pool is sized independently of the @ref event_loop and keeps the io
+ * threads free from the handlers which block e.g. on a database call, see
+ * @ref route_options.
+ *
+ * @par Example
+ *
+ * @code
+ * auto pool = std::make_shared<beast_router::worker_pool>(8);
+ * pool->post([]() { ... });
+ * @endcode
+ */
+class worker_pool {
+public:
+    /// The `threads number` type
+    using threads_num_type = unsigned int;
+
+    /// The exception handler type
+    using on_error_type = std::function<void(std::exception_ptr)>;
+
+    /// Constructor
+    /**
+     * @param threads The number of workers
+     * @param on_error The handler of the exceptions thrown by the tasks;
+     * the exceptions are dropped when it is not set
+     */
+    ROUTER_DECL explicit worker_pool(
+        threads_num_type threads = std::max(std::thread::hardware_concurrency(), 1u),
+        on_error_type on_error = nullptr);
+
+    /// Constructor (disallowed)
+    worker_pool(const worker_pool&) = delete;
+
+    /// Assignment (disallowed)
+    worker_pool& operator=(const worker_pool&) = delete;
+
+    /// Destructor; executes the queued tasks and joins the workers
+    ROUTER_DECL ~worker_pool();
+
+    /// Queues the task
+    /**
+     * @param func The callable of the `void()` signature
+     * @returns void
+     */
+    template <class Func>
+    void post(Func&& func);
+
+    /// Executes the queued tasks and joins the workers
+    /**
+     * @returns void
+     */
+    ROUTER_DECL void stop();
+
+    /// Returns the number of workers
+    /**
+     * @returns @ref threads_num_type
+     */
+    ROUTER_DECL threads_num_type get_threads() const;
+
+    /// Returns the number of queued tasks
+    /**
+     * @returns std::size_t
+     */
+    ROUTER_DECL std::size_t pending() const;
+
+private:
+    class task {
+        struct base {
+            virtual ~base() = default;
+            virtual void operator()() = 0;
+        };
+
+        template <class Func>
+        struct impl : base {
+            explicit impl(Func&& func)
+                : m_func { std::move(func) }
+            {
+            }
+
+            void operator()() override { m_func(); }
+
+            Func m_func;
+        };
+
+    public:
+        task() = default;
+
+        template <class Func>
+        explicit task(Func&& func)
+            : m_impl { std::make_unique<impl<std::decay_t<Func>>>(std::forward<Func>(func)) }
+        {
+        }
+
+        void operator()() { (*m_impl)(); }
+
+    private:
+        std::unique_ptr<base> m_impl;
+    };
+
+    struct queue {
+        std::mutex mutex;
+        std::deque<task> tasks;
+    };
+
+    ROUTER_DECL void push(task&& tsk);
+
+    ROUTER_DECL bool try_pop(std::size_t idx, task& tsk);
+
+    ROUTER_DECL void run(std::size_t idx);
+
+    static inline thread_local const worker_pool* t_pool = nullptr;
+    static inline thread_local std::size_t t_index = 0;
+
+    on_error_type m_on_error;
+    std::vector<std::unique_ptr<queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<std::size_t> m_pending;
+    std::atomic<std::size_t> m_next;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    bool m_stopped;
+};
+
+ROUTER_NAMESPACE_END()
+
+#include "impl/worker_pool.ipp"
@@ -0,0 +1,306 @@
+#pragma once
+
+#include "base/config.hpp"
+#include "common/utility.hpp"
+#include "connector.hpp"
+#include "session.hpp"
+#include <atomic>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/system/error_code.hpp>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+ROUTER_NAMESPACE_BEGIN()
+
+/// The limits of the pooled connections
+struct pool_limits {
+    /// The number of the connections per host; unlimited if zero
+    std::size_t max_per_host = 8;
+
+    /// The time an idle connection is kept for
+    std::chrono::steady_clock::duration idle_timeout = std::chrono::seconds { 30 };
+
+    /// The period of the eviction of the idle connections; disabled if zero
+    std::chrono::steady_clock::duration eviction_interval = std::chrono::seconds { 1 };
+
+    /// The number of the requests in flight per connection; pipelined if
+    /// greater than one
+    std::size_t max_pipeline = 1;
+};
+
+/// Keeps the keep alive client sessions per host
+/**
+ * The connections are keyed by `host:port[:tls]`. A request is sent over an
+ * idle connection of the host if there is one, otherwise a new connection is
+ * made unless the host has @ref pool_limits::max_per_host connections, in
+ * which case the request waits for a connection to become idle. Once the
+ * response is received the connection returns to the pool unless either of
+ * the peers asked to close it.
+ *
+ * An idle connection is checked before the reuse: the one the peer has
+ * closed (or sent unsolicited data over) is dropped along with the ones idle
+ * for longer than @ref pool_limits::idle_timeout; the latter are evicted by
+ * a timer as well.
+ *
+ * If @ref pool_limits::max_pipeline is greater than one, the request finding
+ * neither an idle connection nor the room for a new one is pipelined over the
+ * least busy connection of the host: it is written right behind the ones in
+ * flight and its response is matched in the FIFO order. Only the idempotent
+ * keep alive requests are pipelined and a connection carrying any other
+ * request takes no more until it is idle. Once the peer closes the
+ * connection, the requests still in flight complete with
+ * `boost::asio::error::connection_aborted`, or the error of the connection.
+ *
+ * The class is thread safe; the response callbacks run on the strand of the
+ * session. Destroying the pool drops the exchanges in flight without
+ * completing them.
+ *
+ * @par Example
+ *
+ * @code
+ * auto pool = beast_router::http_connection_pool_type::create(*event_loop);
+ * pool->send("backend", "8080", beast_router::make_empty_request(http::verb::get, 11, "/"),
+ *     [](boost::system::error_code ec, const auto& rp) {
+ *         ...
+ *     });
+ * @endcode
+ */
+template <class Session, class Connector>
+class connection_pool : public std::enable_shared_from_this<connection_pool<Session, Connector>> {
+    class connection;
+
+public:
+    /// The self type
+    using self_type = connection_pool<Session, Connector>;
+
+    /// The session type
+    using session_type = Session;
+
+    /// The connector type
+    using connector_type = Connector;
+
+    /// The socket type
+    using socket_type = typename connector_type::socket_type;
+
+    /// The context type of the session
+    using context_type = typename session_type::context_type;
+
+    /// The router type of the session
+    using router_type = typename session_type::router_type;
+
+    /// The response type
+    using response_type = typename session_type::message_type;
+
+    /// The on_response callback type; the response is empty on error
+    using on_response_type = std::function<void(boost::system::error_code, const response_type&)>;
+
+    /// The clock type
+    using clock_type = std::chrono::steady_clock;
+
+    /// The pool ptr type
+    using pool_ptr_type = std::shared_ptr<self_type>;
+
+    /// Indicates whether the connections are secured
+    static constexpr bool is_tls = session_type::connection_type::is_ssl_context::value;
+
+    /// The key of the connections i.e. `host:port[:tls]`
+    struct key_type {
+        /// The host
+        std::string host;
+
+        /// The port
+        std::string port;
+
+        /// Whether the connections are secured
+        bool tls;
+
+        bool operator<(const key_type& other) const
+        {
+            return std::tie(host, port, tls) < std::tie(other.host, other.port, other.tls);
+        }
+    };
+
+    /// Constructor (disallowed)
+    connection_pool(const connection_pool&) = delete;
+
+    /// Assignment (disallowed)
+    self_type& operator=(const connection_pool&) = delete;
+
+    /// Destructor
+    ~connection_pool() = default;
+
+    /// The pool factory method
+    /**
+     * The new connections run on the io contexts given by the event loop
+     * policy
+     *
+     * @param event_loop A reference to the `event_loop` or `io_context`
+     * @param limits The limits of the connections
+     * @returns `self_type::pool_ptr_type`
+     */
+    template <class EventLoop>
+    static pool_ptr_type create(EventLoop& event_loop, const pool_limits& limits = {});
+
+#if defined(LINK_SSL)
+    /// The pool factory method
+    /**
+     * @param event_loop A reference to the `event_loop` or `io_context`
+     * @param ssl_ctx The TLS context of the connections
+     * @param limits The limits of the connections
+     * @returns `self_type::pool_ptr_type`
+     */
+    template <class EventLoop>
+    static pool_ptr_type create(EventLoop& event_loop, boost::asio::ssl::context& ssl_ctx,
+        const pool_limits& limits = {});
+#endif
+
+    /// Sends the request to the host
+    /**
+     * @param host The host
+     * @param port The port
+     * @param request The request; copy constructible
+     * @param on_response The callback invoked once either the response is
+     * received or the exchange fails
+     * @returns void
+     */
+    template <class Request>
+    void send(std::string_view host, std::string_view port, Request&& request,
+        on_response_type on_response);
+
+    /// Sends the request to the host and completes once the response is received
+    /**
+     * The equivalent function signature of the handler must be as the following:
+     * @code
+     * void handler(boost::system::error_code ec, response_type response);
+     * @endcode
+     *
+     * @par Example
+     *
+     * @code
+     * auto rp = co_await pool->async_send("backend", "8080", std::move(rq), boost::asio::use_awaitable);
+     * @endcode
+     *
+     * @param host The host
+     * @param port The port
+     * @param request The request; copy constructible
+     * @param token The completion token e.g. `boost::asio::use_awaitable`
+     * @returns Depends on the completion token
+     */
+    template <class Request, class CompletionToken>
+    auto async_send(std::string_view host, std::string_view port, Request&& request,
+        CompletionToken&& token);
+
+    /// Closes the idle connections and stops the eviction
+    /**
+     * The waiting requests complete with
+     * `boost::asio::error::operation_aborted`, the ones in flight complete
+     * as usual and their connections are closed afterwards
+     *
+     * @returns void
+     */
+    void close();
+
+    /// Returns the number of the connections of the host
+    /**
+     * The connections being made, in use and idle are included
+     *
+     * @param host The host
+     * @param port The port
+     * @returns std::size_t
+     */
+    std::size_t connections(std::string_view host, std::string_view port) const;
+
+    /// Returns the number of the idle connections of the host
+    /**
+     * @param host The host
+     * @param port The port
+     * @returns std::size_t
+     */
+    std::size_t idle(std::string_view host, std::string_view port) const;
+
+    /// Returns the limits
+    /**
+     * @returns @ref pool_limits
+     */
+    const pool_limits& limits() const;
+
+protected:
+    /// Constructor
+    connection_pool(std::function<boost::asio::io_context&()> select_context,
+        const pool_limits& limits);
+
+private:
+    struct exchange {
+        std::function<void(connection&, socket_type*, bool)> start;
+        on_response_type on_response;
+        bool pipelined;
+    };
+
+    struct host_type {
+        std::size_t connections = 0;
+        std::vector<std::shared_ptr<connection>> idle;
+        std::vector<std::shared_ptr<connection>> active;
+        std::deque<exchange> waiters;
+    };
+
+    template <class EventLoop>
+    static pool_ptr_type do_create(EventLoop& event_loop, const pool_limits& limits);
+
+    void do_acquire(key_type key, exchange&& ex);
+
+    void do_connect(const key_type& key, exchange&& ex);
+
+    void on_connect(const key_type& key, exchange&& ex, boost::system::error_code ec,
+        socket_type socket);
+
+    void on_response(const std::shared_ptr<connection>& conn, const response_type& rp);
+
+    void on_failure(const std::shared_ptr<connection>& conn, boost::system::error_code ec);
+
+    void do_serve(host_type& host, const std::shared_ptr<connection>& conn);
+
+    void do_drop(const std::shared_ptr<connection>& conn, std::unique_lock<std::mutex>& lock);
+
+    void do_vacate(const key_type& key, host_type& host, std::unique_lock<std::mutex>& lock);
+
+    void do_schedule();
+
+    void do_evict();
+
+    std::function<boost::asio::io_context&()> m_select_context;
+    const pool_limits m_limits;
+    boost::asio::steady_timer m_timer;
+#if defined(LINK_SSL)
+    boost::asio::ssl::context* m_ssl_ctx;
+#endif
+    mutable std::mutex m_mutex;
+    bool m_closed;
+    std::map<key_type, host_type> m_hosts;
+};
+
+/// Default http connection pool type
+using http_connection_pool_type = connection_pool<http_client_type, http_connector_type>;
+
+ROUTER_NAMESPACE_END()
+
+#if defined(LINK_SSL)
+ROUTER_SSL_NAMESPACE_BEGIN()
+/// Default tls http connection pool type
+using http_connection_pool_type = connection_pool<http_client_type, http_connector_type>;
+ROUTER_SSL_NAMESPACE_END()
+#endif
+
+#include "impl/connection_pool.ipp"
@@ -1,17 +1,42 @@
 #pragma once
 
 #include "base/config.hpp"
+#include "base/connect_race.hpp"
 #include "base/strand_stream.hpp"
 #include "common/connection.hpp"
+#include "common/dns_cache.hpp"
 #include "common/utility.hpp"
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/connect.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/system/error_code.hpp>
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <string_view>
 
 ROUTER_NAMESPACE_BEGIN()
 
+/// The strategy of connecting to the resolved endpoints
+/**
+ * By default the endpoints are tried one after another, so an unreachable
+ * one stalls the connection for the whole TCP timeout. With a delay given
+ * the attempts race instead (RFC 8305): alternating the address families, a
+ * new attempt starts every @ref attempt_delay while the previous ones are in
+ * progress, the first one connected wins and the rest are cancelled.
+ */
+struct connect_strategy {
+    /// The delay between the starts of the attempts, RFC 8305 recommends
+    /// 250ms; the attempts are made one after another if zero
+    std::chrono::steady_clock::duration attempt_delay = std::chrono::steady_clock::duration::zero();
+
+    /// The time an attempt is given; not limited if zero
+    std::chrono::steady_clock::duration attempt_timeout = std::chrono::steady_clock::duration::zero();
+};
+
 /// Makes a client connection to the given host
 template <class Protocol, class Resolver,
     class Socket, template <typename> class Endpoint>
@@ -46,6 +71,9 @@ public:
     /// The connector ptr type
     using connector_ptr_type = std::shared_ptr<self_type>;
 
+    /// The resolution cache type
+    using dns_cache_type = basic_dns_cache<protocol_type>;
+
     /// Constructor (disallowed)
     connector(const connector& srv) = delete;
 
@@ -63,7 +91,9 @@ public:
 
     /// The connection factory method
     /**
-     * @param ctx The boost context
+     * The connection runs on the io context given by the event loop policy
+     *
+     * @param event_loop A reference to the `event_loop`
      * @param address String representation of the target address
      * @param port String representation of the target port
      * @param on_action A pack of callbacks suitable for the `this` object
@@ -81,11 +111,71 @@ public:
             {
             }
         };
-        auto ret = std::make_shared<enable_make_shared>(static_cast<boost::asio::io_context&>(event_loop), std::forward<OnAction>(on_action)...);
+        auto ret = std::make_shared<enable_make_shared>(select_context(event_loop),
+            std::forward<OnAction>(on_action)...);
         ret->do_resolve(address, port);
         return ret;
     }
 
+    /// Starts an asynchronous connection to the given host
+    /**
+     * The composed operation resolves the host and connects to the first
+     * reachable endpoint following the @ref connect_strategy; neither the connector object nor the callbacks are
+     * allocated. The equivalent function signature of the handler must be as
+     * the following:
+     * @code
+     * void handler(boost::system::error_code ec, socket_type socket);
+     * @endcode
+     *
+     * @par Example
+     *
+     * @code
+     * auto [ec, socket] = co_await http_connector_type::async_connect(
+     *     event_loop, "localhost", "8080",
+     *     boost::asio::experimental::as_tuple(boost::asio::use_awaitable));
+     * @endcode
+     *
+     * @param event_loop A reference to the `event_loop`
+     * @param address String representation of the target address
+     * @param port String representation of the target port
+     * @param token The completion token e.g. `boost::asio::use_awaitable`
+     * @returns Depends on the completion token
+     */
+    template <class EventLoop, class CompletionToken>
+    static auto async_connect(EventLoop& event_loop, std::string_view address,
+        std::string_view port, CompletionToken&& token);
+
+    /// Sets the resolution cache shared by the connectors
+    /**
+     * The hosts are resolved through the cache by the connections made
+     * afterwards; every connection resolves its host if null (default)
+     *
+     * @param cache The cache
+     * @returns void
+     */
+    static void set_dns_cache(std::shared_ptr<dns_cache_type> cache);
+
+    /// Obtains the resolution cache shared by the connectors
+    /**
+     * @returns std::shared_ptr<dns_cache_type>
+     */
+    static std::shared_ptr<dns_cache_type> get_dns_cache();
+
+    /// Sets the strategy of connecting shared by the connectors
+    /**
+     * The connections made afterwards follow the strategy
+     *
+     * @param strategy The strategy
+     * @returns void
+     */
+    static void set_connect_strategy(const connect_strategy& strategy);
+
+    /// Obtains the strategy of connecting shared by the connectors
+    /**
+     * @returns @ref connect_strategy
+     */
+    static connect_strategy get_connect_strategy();
+
 protected:
     /// Constructor
     explicit connector(boost::asio::io_context& ctx,
@@ -123,6 +213,23 @@ protected:
 private:
     using connection_type = connection<socket_type, base::strand_stream::asio_type>;
 
+    struct connect_op;
+
+    template <class EventLoop>
+    static boost::asio::io_context& select_context(EventLoop& event_loop);
+
+    struct shared_settings {
+        std::mutex m_mutex;
+        std::shared_ptr<dns_cache_type> m_cache;
+        connect_strategy m_strategy;
+    };
+
+    static shared_settings& settings_instance();
+
+    template <class EndpointSequence, class Handler>
+    static void do_connect(socket_type& socket, const EndpointSequence& endpoints,
+        Handler&& handler);
+
     resolver_type m_resolver;
     on_connect_type m_on_connect;
     on_error_type m_on_error;
@@ -0,0 +1,561 @@
+#pragma once
+
+#include <algorithm>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/beast/core/stream_traits.hpp>
+#include <iterator>
+#include <utility>
+
+ROUTER_NAMESPACE_BEGIN()
+
+/// The pooled connection
+/**
+ * The connection owns the session and the router whose response handler
+ * completes the exchanges in flight in the FIFO order. Apart from the
+ * constant members, the connection is guarded by the mutex of the pool.
+ */
+template <class Session, class Connector>
+class connection_pool<Session, Connector>::connection
+    : public std::enable_shared_from_this<connection> {
+public:
+    connection(std::weak_ptr<self_type> pool, key_type key)
+        : m_pool { std::move(pool) }
+        , m_key { std::move(key) }
+        , m_router {}
+        , m_context {}
+        , m_inflight {}
+        , m_pipelined { false }
+        , m_idle_since {}
+        , m_retired { false }
+    {
+    }
+
+    void init()
+    {
+        m_router.handle_response([weak = this->weak_from_this()](const response_type& rp, context_type&) {
+            if (auto self = weak.lock()) {
+                if (auto pool = self->m_pool.lock()) {
+                    pool->on_response(self, rp);
+                }
+            }
+        });
+    }
+
+    /// Checks whether the exchange may be started
+    bool accepts(const exchange& ex, std::size_t max_pipeline) const
+    {
+        if (m_retired) {
+            return false;
+        }
+        return m_inflight.empty()
+            || (ex.pipelined && m_pipelined && m_inflight.size() < max_pipeline);
+    }
+
+    /// Starts the exchange; the session is created if the socket is given
+    /**
+     * The request is queued behind the ones in flight, the response is read
+     * unless a read is already pending
+     */
+    void start(exchange&& ex, socket_type* socket)
+    {
+        const bool reading = !m_inflight.empty();
+        m_pipelined = reading ? m_pipelined && ex.pipelined : ex.pipelined;
+        m_inflight.push_back(std::move(ex.on_response));
+        ex.start(*this, socket, !reading);
+    }
+
+    template <class Request>
+    void send(socket_type* socket, Request&& request, bool recv)
+    {
+        if (socket == nullptr) {
+            m_context->send(std::forward<Request>(request));
+            if (recv) {
+                m_context->recv();
+            }
+            return;
+        }
+
+        typename session_type::on_error_type on_error =
+            [weak = this->weak_from_this()](boost::system::error_code ec, std::string_view) {
+                if (auto self = weak.lock()) {
+                    if (auto pool = self->m_pool.lock()) {
+                        pool->on_failure(self, ec);
+                    }
+                }
+            };
+
+#if defined(LINK_SSL)
+        if constexpr (is_tls) {
+            auto pool = m_pool.lock();
+            BOOST_ASSERT(pool != nullptr && pool->m_ssl_ctx != nullptr);
+            m_context = session_type::send(*pool->m_ssl_ctx, std::move(*socket),
+                std::forward<Request>(request), m_router, std::move(on_error));
+        } else
+#endif
+        {
+            m_context = session_type::send(std::move(*socket), std::forward<Request>(request),
+                m_router, std::move(on_error));
+        }
+        m_context->recv();
+    }
+
+    /// Checks whether the idle connection may be reused
+    bool reusable(clock_type::time_point now, clock_type::duration idle_timeout)
+    {
+        if (m_retired || !m_context || !m_context->is_open() || now - m_idle_since >= idle_timeout) {
+            return false;
+        }
+
+        /// neither the end of the stream nor any data are expected while
+        /// idle, the peek does not block
+        auto& socket = boost::beast::get_lowest_layer(m_context->get_stream());
+        const bool non_blocking = socket.non_blocking();
+        boost::system::error_code ec;
+        char byte;
+        socket.non_blocking(true, ec);
+        socket.receive(boost::asio::buffer(&byte, 1), socket_type::message_peek, ec);
+
+        boost::system::error_code ignored;
+        socket.non_blocking(non_blocking, ignored);
+        return ec == boost::asio::error::would_block;
+    }
+
+    /// Takes the exchanges in flight
+    std::deque<on_response_type> abandon()
+    {
+        return std::exchange(m_inflight, {});
+    }
+
+    /// Marks the connection as dropped; returns false if it has been already
+    bool retire()
+    {
+        return !m_retired.exchange(true);
+    }
+
+    std::weak_ptr<self_type> m_pool;
+    const key_type m_key;
+    router_type m_router;
+    std::optional<context_type> m_context;
+    std::deque<on_response_type> m_inflight;
+    bool m_pipelined;
+    clock_type::time_point m_idle_since;
+    std::atomic<bool> m_retired;
+};
+
+template <class Session, class Connector>
+connection_pool<Session, Connector>::connection_pool(
+    std::function<boost::asio::io_context&()> select_context, const pool_limits& limits)
+    : m_select_context { std::move(select_context) }
+    , m_limits { limits }
+    , m_timer { boost::asio::make_strand(m_select_context()) }
+#if defined(LINK_SSL)
+    , m_ssl_ctx { nullptr }
+#endif
+    , m_mutex {}
+    , m_closed { false }
+    , m_hosts {}
+{
+}
+
+template <class Session, class Connector>
+template <class EventLoop>
+typename connection_pool<Session, Connector>::pool_ptr_type
+connection_pool<Session, Connector>::create(EventLoop& event_loop, const pool_limits& limits)
+{
+    static_assert(!is_tls, "connection_pool::create requires the TLS context");
+    return do_create(event_loop, limits);
+}
+
+#if defined(LINK_SSL)
+template <class Session, class Connector>
+template <class EventLoop>
+typename connection_pool<Session, Connector>::pool_ptr_type
+connection_pool<Session, Connector>::create(EventLoop& event_loop,
+    boost::asio::ssl::context& ssl_ctx, const pool_limits& limits)
+{
+    static_assert(is_tls, "connection_pool::create requires the plain session");
+    auto ret = do_create(event_loop, limits);
+    ret->m_ssl_ctx = &ssl_ctx;
+    return ret;
+}
+#endif
+
+template <class Session, class Connector>
+template <class EventLoop>
+typename connection_pool<Session, Connector>::pool_ptr_type
+connection_pool<Session, Connector>::do_create(EventLoop& event_loop, const pool_limits& limits)
+{
+    struct enable_make_shared : public self_type {
+        enable_make_shared(std::function<boost::asio::io_context&()> select_context,
+            const pool_limits& limits)
+            : self_type { std::move(select_context), limits }
+        {
+        }
+    };
+
+    auto ret = std::make_shared<enable_make_shared>(
+        [&event_loop]() -> boost::asio::io_context& {
+            if constexpr (utility::has_context_selector_v<EventLoop>) {
+                return event_loop.get_context();
+            } else {
+                return static_cast<boost::asio::io_context&>(event_loop);
+            }
+        },
+        limits);
+    ret->do_schedule();
+    return ret;
+}
+
+template <class Session, class Connector>
+template <class Request>
+void connection_pool<Session, Connector>::send(std::string_view host, std::string_view port,
+    Request&& request, on_response_type on_response)
+{
+    using boost::beast::http::verb;
+
+    /// only the idempotent requests are retried safely once the connection
+    /// breaks in the middle of the pipeline
+    const auto method = request.method();
+    const bool pipelined = request.keep_alive()
+        && (method == verb::get || method == verb::head || method == verb::options
+            || method == verb::trace || method == verb::put || method == verb::delete_);
+
+    exchange ex {
+        [rq = std::forward<Request>(request)](connection& conn, socket_type* socket, bool recv) mutable {
+            conn.send(socket, std::move(rq), recv);
+        },
+        std::move(on_response),
+        pipelined
+    };
+    do_acquire(key_type { std::string { host }, std::string { port }, is_tls }, std::move(ex));
+}
+
+template <class Session, class Connector>
+template <class Request, class CompletionToken>
+auto connection_pool<Session, Connector>::async_send(std::string_view host, std::string_view port,
+    Request&& request, CompletionToken&& token)
+{
+    using request_type = std::decay_t<Request>;
+
+    auto initiation = [](auto handler, std::shared_ptr<self_type> self, key_type key,
+                          request_type rq) {
+        /// the callback is copyable, the handler may be not
+        auto shared = std::make_shared<decltype(handler)>(std::move(handler));
+        const auto executor = boost::asio::get_associated_executor(*shared,
+            self->m_timer.get_executor());
+        self->send(key.host, key.port, std::move(rq),
+            [shared, executor](boost::system::error_code ec, const response_type& rp) {
+                boost::asio::dispatch(executor,
+                    [shared, ec, rp = response_type { rp }]() mutable {
+                        (*shared)(ec, std::move(rp));
+                    });
+            });
+    };
+
+    return boost::asio::async_initiate<CompletionToken,
+        void(boost::system::error_code, response_type)>(
+        std::move(initiation), token, this->shared_from_this(),
+        key_type { std::string { host }, std::string { port }, is_tls },
+        request_type { std::forward<Request>(request) });
+}
+
+template <class Session, class Connector>
+void connection_pool<Session, Connector>::close()
+{
+    std::vector<std::shared_ptr<connection>> idle;
+    std::deque<exchange> waiters;
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        m_closed = true;
+        for (auto& [key, host] : m_hosts) {
+            for (auto& conn : host.idle) {
+                if (conn->retire()) {
+                    --host.connections;
+                }
+                idle.push_back(std::move(conn));
+            }
+            host.idle.clear();
+            std::move(host.waiters.begin(), host.waiters.end(), std::back_inserter(waiters));
+            host.waiters.clear();
+        }
+    }
+
+    boost::asio::post(m_timer.get_executor(), [self = this->shared_from_this()]() {
+        self->m_timer.cancel();
+    });
+
+    for (auto& ex : waiters) {
+        ex.on_response(boost::asio::error::operation_aborted, response_type {});
+    }
+}
+
+template <class Session, class Connector>
+std::size_t connection_pool<Session, Connector>::connections(std::string_view host,
+    std::string_view port) const
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    const auto it = m_hosts.find(key_type { std::string { host }, std::string { port }, is_tls });
+    return it == m_hosts.end() ? 0 : it->second.connections;
+}
+
+template <class Session, class Connector>
+std::size_t connection_pool<Session, Connector>::idle(std::string_view host,
+    std::string_view port) const
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    const auto it = m_hosts.find(key_type { std::string { host }, std::string { port }, is_tls });
+    return it == m_hosts.end() ? 0 : it->second.idle.size();
+}
+
+template <class Session, class Connector>
+const pool_limits& connection_pool<Session, Connector>::limits() const
+{
+    return m_limits;
+}
+
+template <class Session, class Connector>
+void connection_pool<Session, Connector>::do_acquire(key_type key, exchange&& ex)
+{
+    std::vector<std::shared_ptr<connection>> stale;
+    std::unique_lock<std::mutex> lock { m_mutex };
+    if (m_closed) {
+        lock.unlock();
+        ex.on_response(boost::asio::error::operation_aborted, response_type {});
+        return;
+    }
+
+    auto& host = m_hosts[key];
+    const auto now = clock_type::now();
+    while (!host.idle.empty()) {
+        /// the most recently used connection is the least likely to be
+        /// closed by the peer
+        auto conn = std::move(host.idle.back());
+        host.idle.pop_back();
+        if (conn->reusable(now, m_limits.idle_timeout)) {
+            host.active.push_back(conn);
+            conn->start(std::move(ex), nullptr);
+            return;
+        }
+
+        if (conn->retire()) {
+            --host.connections;
+        }
+        stale.push_back(std::move(conn));
+    }
+
+    if (m_limits.max_per_host == 0 || host.connections < m_limits.max_per_host) {
+        ++host.connections;
+        lock.unlock();
+        do_connect(key, std::move(ex));
+        return;
+    }
+
+    /// the requests in order behind the waiting ones are not pipelined
+    if (host.waiters.empty()) {
+        std::shared_ptr<connection> least_busy;
+        for (const auto& conn : host.active) {
+            if (conn->accepts(ex, m_limits.max_pipeline)
+                && (!least_busy || conn->m_inflight.size() < least_busy->m_inflight.size())) {
+                least_busy = conn;
+            }
+        }
+        if (least_busy) {
+            least_busy->start(std::move(ex), nullptr);
+            return;
+        }
+    }
+
+    host.waiters.push_back(std::move(ex));
+}
+
+template <class Session, class Connector>
+void connection_pool<Session, Connector>::do_connect(const key_type& key, exchange&& ex)
+{
+    connector_type::async_connect(m_select_context(), key.host, key.port,
+        [self = this->shared_from_this(), key, ex = std::move(ex)](
+            boost::system::error_code ec, socket_type socket) mutable {
+            self->on_connect(key, std::move(ex), ec, std::move(socket));
+        });
+}
+
+template <class Session, class Connector>
+void connection_pool<Session, Connector>::on_connect(const key_type& key, exchange&& ex,
+    boost::system::error_code ec, socket_type socket)
+{
+    if (ec) {
+        {
+            std::unique_lock<std::mutex> lock { m_mutex };
+            do_vacate(key, m_hosts[key], lock);
+        }
+        ex.on_response(ec, response_type {});
+        return;
+    }
+
+    auto conn = std::make_shared<connection>(this->weak_from_this(), key);
+    conn->init();
+
+    std::lock_guard<std::mutex> lock { m_mutex };
+    auto& host = m_hosts[key];
+    host.active.push_back(conn);
+    conn->start(std::move(ex), &socket);
+    do_serve(host, conn);
+}
+
+template <class Session, class Connector>
+void connection_pool<Session, Connector>::on_response(const std::shared_ptr<connection>& conn,
+    const response_type& rp)
+{
+    on_response_type on_response;
+    std::deque<on_response_type> abandoned;
+    {
+        std::unique_lock<std::mutex> lock { m_mutex };
+
+        /// the failed exchanges have been completed by `on_failure`
+        if (conn->m_inflight.empty()) {
+            return;
+        }
+        on_response = std::move(conn->m_inflight.front());
+        conn->m_inflight.pop_front();
+
+        if (!rp.keep_alive()) {
+            abandoned = conn->abandon();
+            do_drop(conn, lock);
+        } else if (!conn->m_inflight.empty()) {
+            conn->m_context->recv();
+            do_serve(m_hosts[conn->m_key], conn);
+        } else if (m_closed || conn->m_retired) {
+            do_drop(conn, lock);
+        } else {
+            auto& host = m_hosts[conn->m_key];
+            do_serve(host, conn);
+            if (conn->m_inflight.empty()) {
+                host.active.erase(std::find(host.active.begin(), host.active.end(), conn));
+                conn->m_idle_since = clock_type::now();
+                host.idle.push_back(conn);
+            }
+        }
+    }
+
+    on_response({}, rp);
+    for (auto& on_abandon : abandoned) {
+        on_abandon(boost::asio::error::connection_aborted, response_type {});
+    }
+}
+
+template <class Session, class Connector>
+void connection_pool<Session, Connector>::on_failure(const std::shared_ptr<connection>& conn,
+    boost::system::error_code ec)
+{
+    std::deque<on_response_type> abandoned;
+    {
+        std::unique_lock<std::mutex> lock { m_mutex };
+        abandoned = conn->abandon();
+        do_drop(conn, lock);
+    }
+
+    for (auto& on_abandon : abandoned) {
+        on_abandon(ec, response_type {});
+    }
+}
+
+template <class Session, class Connector>
+void connection_pool<Session, Connector>::do_serve(host_type& host,
+    const std::shared_ptr<connection>& conn)
+{
+    /// the waiting requests keep their order
+    while (!m_closed && !host.waiters.empty()
+        && conn->accepts(host.waiters.front(), m_limits.max_pipeline)) {
+        auto ex = std::move(host.waiters.front());
+        host.waiters.pop_front();
+        conn->start(std::move(ex), nullptr);
+    }
+}
+
+template <class Session, class Connector>
+void connection_pool<Session, Connector>::do_drop(const std::shared_ptr<connection>& conn,
+    std::unique_lock<std::mutex>& lock)
+{
+    if (!conn->retire()) {
+        return;
+    }
+
+    auto& host = m_hosts[conn->m_key];
+    for (auto* list : { &host.idle, &host.active }) {
+        auto it = std::find(list->begin(), list->end(), conn);
+        if (it != list->end()) {
+            list->erase(it);
+        }
+    }
+    do_vacate(conn->m_key, host, lock);
+}
+
+template <class Session, class Connector>
+void connection_pool<Session, Connector>::do_vacate(const key_type& key, host_type& host,
+    std::unique_lock<std::mutex>& lock)
+{
+    --host.connections;
+
+    /// the place is taken by the first of the waiting requests
+    if (host.waiters.empty() || m_closed) {
+        return;
+    }
+
+    auto ex = std::move(host.waiters.front());
+    host.waiters.pop_front();
+    ++host.connections;
+    lock.unlock();
+    do_connect(key, std::move(ex));
+}
+
+template <class Session, class Connector>
+void connection_pool<Session, Connector>::do_schedule()
+{
+    if (m_limits.eviction_interval == clock_type::duration::zero()) {
+        return;
+    }
+
+    m_timer.expires_after(m_limits.eviction_interval);
+    m_timer.async_wait([weak = this->weak_from_this()](boost::system::error_code ec) {
+        if (ec) {
+            return;
+        }
+        if (auto self = weak.lock()) {
+            self->do_evict();
+            self->do_schedule();
+        }
+    });
+}
+
+template <class Session, class Connector>
+void connection_pool<Session, Connector>::do_evict()
+{
+    std::vector<std::shared_ptr<connection>> stale;
+    std::lock_guard<std::mutex> lock { m_mutex };
+
+    const auto deadline = clock_type::now() - m_limits.idle_timeout;
+    for (auto it = m_hosts.begin(); it != m_hosts.end();) {
+        auto& host = it->second;
+        const auto first = std::stable_partition(host.idle.begin(), host.idle.end(),
+            [&deadline](const std::shared_ptr<connection>& conn) {
+                return conn->m_idle_since > deadline;
+            });
+        for (auto conn = first; conn != host.idle.end(); ++conn) {
+            if ((*conn)->retire()) {
+                --host.connections;
+            }
+            stale.push_back(std::move(*conn));
+        }
+        host.idle.erase(first, host.idle.end());
+
+        if (host.connections == 0 && host.waiters.empty()) {
+            it = m_hosts.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+ROUTER_NAMESPACE_END()
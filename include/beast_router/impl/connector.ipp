@@ -38,6 +38,12 @@ CONNECTOR_TEMPLATE_DECLARE
 void connector<CONNECTOR_TEMPLATE_ATTRIBUTES>::do_resolve(
     std::string_view address, std::string_view port)
 {
+    if (auto cache = get_dns_cache()) {
+        cache->resolve(address, port, static_cast<const base::strand_stream::asio_type&>(*this),
+            boost::beast::bind_front_handler(&self_type::on_resolve, this->shared_from_this()));
+        return;
+    }
+
     m_resolver.async_resolve(
         address, port,
         boost::beast::bind_front_handler(&self_type::on_resolve,
@@ -55,14 +61,14 @@ void connector<CONNECTOR_TEMPLATE_ATTRIBUTES>::on_resolve(
         return;
     }
 
-    m_connection.async_connect(
-        std::move(results),
-        std::bind(
-            static_cast<void (self_type::*)(
-                boost::beast::error_code, typename results_type::endpoint_type)>(
-                &self_type::on_connect),
-            this->shared_from_this(), std::placeholders::_1,
-            std::placeholders::_2));
+    do_connect(m_connection.stream(), results,
+        boost::asio::bind_executor(static_cast<const base::strand_stream::asio_type&>(*this),
+            std::bind(
+                static_cast<void (self_type::*)(
+                    boost::beast::error_code, typename results_type::endpoint_type)>(
+                    &self_type::on_connect),
+                this->shared_from_this(), std::placeholders::_1,
+                std::placeholders::_2)));
 }
 
 CONNECTOR_TEMPLATE_DECLARE
@@ -82,4 +88,137 @@ void connector<CONNECTOR_TEMPLATE_ATTRIBUTES>::on_connect(
     m_on_connect(m_connection.release());
 }
 
+CONNECTOR_TEMPLATE_DECLARE
+struct connector<CONNECTOR_TEMPLATE_ATTRIBUTES>::connect_op {
+    using endpoint_result_type = typename results_type::endpoint_type;
+
+    std::unique_ptr<resolver_type> m_resolver;
+    std::unique_ptr<socket_type> m_socket;
+    std::string m_address;
+    std::string m_port;
+
+    template <class Self>
+    void operator()(Self& self)
+    {
+        if (auto cache = get_dns_cache()) {
+            /// the cache takes a copyable handler
+            const auto executor = m_resolver->get_executor();
+            auto address = m_address;
+            auto port = m_port;
+            auto op = std::make_shared<Self>(std::move(self));
+            cache->resolve(address, port, executor,
+                [op](boost::system::error_code ec, results_type results) {
+                    (*op)(ec, std::move(results));
+                });
+            return;
+        }
+
+        m_resolver->async_resolve(m_address, m_port, std::move(self));
+    }
+
+    template <class Self>
+    void operator()(Self& self, boost::system::error_code ec, results_type results)
+    {
+        if (ec) {
+            self.complete(ec, std::move(*m_socket));
+            return;
+        }
+
+        do_connect(*m_socket, results, std::move(self));
+    }
+
+    template <class Self>
+    void operator()(Self& self, boost::system::error_code ec,
+        [[maybe_unused]] endpoint_result_type ep)
+    {
+        self.complete(ec, std::move(*m_socket));
+    }
+};
+
+CONNECTOR_TEMPLATE_DECLARE
+template <class EventLoop, class CompletionToken>
+auto connector<CONNECTOR_TEMPLATE_ATTRIBUTES>::async_connect(EventLoop& event_loop,
+    std::string_view address, std::string_view port, CompletionToken&& token)
+{
+    auto& ctx = select_context(event_loop);
+
+    return boost::asio::async_compose<CompletionToken,
+        void(boost::system::error_code, socket_type)>(
+        connect_op { std::make_unique<resolver_type>(ctx),
+            std::make_unique<socket_type>(ctx), std::string { address },
+            std::string { port } },
+        token, ctx.get_executor());
+}
+
+CONNECTOR_TEMPLATE_DECLARE
+void connector<CONNECTOR_TEMPLATE_ATTRIBUTES>::set_dns_cache(
+    std::shared_ptr<dns_cache_type> cache)
+{
+    auto& instance = settings_instance();
+    std::lock_guard<std::mutex> lock { instance.m_mutex };
+    instance.m_cache = std::move(cache);
+}
+
+CONNECTOR_TEMPLATE_DECLARE
+std::shared_ptr<typename connector<CONNECTOR_TEMPLATE_ATTRIBUTES>::dns_cache_type>
+connector<CONNECTOR_TEMPLATE_ATTRIBUTES>::get_dns_cache()
+{
+    auto& instance = settings_instance();
+    std::lock_guard<std::mutex> lock { instance.m_mutex };
+    return instance.m_cache;
+}
+
+CONNECTOR_TEMPLATE_DECLARE
+void connector<CONNECTOR_TEMPLATE_ATTRIBUTES>::set_connect_strategy(
+    const connect_strategy& strategy)
+{
+    auto& instance = settings_instance();
+    std::lock_guard<std::mutex> lock { instance.m_mutex };
+    instance.m_strategy = strategy;
+}
+
+CONNECTOR_TEMPLATE_DECLARE
+connect_strategy connector<CONNECTOR_TEMPLATE_ATTRIBUTES>::get_connect_strategy()
+{
+    auto& instance = settings_instance();
+    std::lock_guard<std::mutex> lock { instance.m_mutex };
+    return instance.m_strategy;
+}
+
+CONNECTOR_TEMPLATE_DECLARE
+typename connector<CONNECTOR_TEMPLATE_ATTRIBUTES>::shared_settings&
+connector<CONNECTOR_TEMPLATE_ATTRIBUTES>::settings_instance()
+{
+    static shared_settings instance;
+    return instance;
+}
+
+CONNECTOR_TEMPLATE_DECLARE
+template <class EndpointSequence, class Handler>
+void connector<CONNECTOR_TEMPLATE_ATTRIBUTES>::do_connect(socket_type& socket,
+    const EndpointSequence& endpoints, Handler&& handler)
+{
+    const auto strategy = get_connect_strategy();
+    if (strategy.attempt_delay == std::chrono::steady_clock::duration::zero()
+        && strategy.attempt_timeout == std::chrono::steady_clock::duration::zero()) {
+        boost::asio::async_connect(socket, endpoints, std::forward<Handler>(handler));
+        return;
+    }
+
+    base::async_race_connect(socket, endpoints, strategy.attempt_delay, strategy.attempt_timeout,
+        std::forward<Handler>(handler));
+}
+
+CONNECTOR_TEMPLATE_DECLARE
+template <class EventLoop>
+boost::asio::io_context& connector<CONNECTOR_TEMPLATE_ATTRIBUTES>::select_context(
+    EventLoop& event_loop)
+{
+    if constexpr (utility::has_context_selector_v<EventLoop>) {
+        return event_loop.get_context();
+    } else {
+        return static_cast<boost::asio::io_context&>(event_loop);
+    }
+}
+
 ROUTER_NAMESPACE_END()
@@ -21,10 +21,17 @@ LISTENER_TEMPLATE_DECLARE
 listener<LISTENER_TEMPLATE_ATTRIBUTES>::listener(boost::asio::io_context& ctx,
     on_accept_type&& on_accept)
     : base::strand_stream { ctx.get_executor() }
-    , m_acceptor { ctx }
+    , m_acceptors {}
+    , m_acceptor_ctxs {}
+    , m_next_ctx { nullptr }
+    , m_reuse_port { false }
+    , m_closed { false }
     , m_io_ctx { ctx }
     , m_on_accept { std::move(on_accept) }
+    , m_on_admit { nullptr }
     , m_on_error { nullptr }
+    , m_limiter { nullptr }
+    , m_shed { 0 }
 {
 }
 
@@ -33,10 +40,37 @@ listener<LISTENER_TEMPLATE_ATTRIBUTES>::listener(boost::asio::io_context& ctx,
     on_accept_type&& on_accept,
     on_error_type&& on_error)
     : base::strand_stream { ctx.get_executor() }
-    , m_acceptor { ctx }
+    , m_acceptors {}
+    , m_acceptor_ctxs {}
+    , m_next_ctx { nullptr }
+    , m_reuse_port { false }
+    , m_closed { false }
     , m_io_ctx { ctx }
     , m_on_accept { std::move(on_accept) }
+    , m_on_admit { nullptr }
     , m_on_error { std::move(on_error) }
+    , m_limiter { nullptr }
+    , m_shed { 0 }
+{
+}
+
+LISTENER_TEMPLATE_DECLARE
+listener<LISTENER_TEMPLATE_ATTRIBUTES>::listener(boost::asio::io_context& ctx,
+    on_admit_type&& on_admit,
+    on_error_type&& on_error,
+    const connection_limits& limits)
+    : base::strand_stream { ctx.get_executor() }
+    , m_acceptors {}
+    , m_acceptor_ctxs {}
+    , m_next_ctx { nullptr }
+    , m_reuse_port { false }
+    , m_closed { false }
+    , m_io_ctx { ctx }
+    , m_on_accept { nullptr }
+    , m_on_admit { std::move(on_admit) }
+    , m_on_error { std::move(on_error) }
+    , m_limiter { std::make_shared<connection_limiter>(limits) }
+    , m_shed { 0 }
 {
 }
 
@@ -44,49 +78,212 @@ LISTENER_TEMPLATE_DECLARE
 void listener<LISTENER_TEMPLATE_ATTRIBUTES>::loop(
     const endpoint_type& endpoint)
 {
-    auto ec = boost::system::error_code {};
+    m_acceptors.emplace_back(m_io_ctx);
+    m_acceptor_ctxs.push_back(&m_io_ctx);
 
-    m_acceptor.open(endpoint.protocol(), ec);
-    CHECK_EC(ec, "open/loop");
+    auto ec = do_listen(m_acceptors.back(), endpoint, false);
+    if (ec) {
+        return;
+    }
 
-    m_acceptor.set_option(boost::asio::socket_base::reuse_address(true), ec);
-    CHECK_EC(ec, "set_option/loop");
+    m_endpoint = m_acceptors.back().local_endpoint(ec);
 
-    m_acceptor.bind(endpoint, ec);
-    CHECK_EC(ec, "bind/loop");
+    do_accept(0);
+}
 
-    m_acceptor.listen(boost::asio::socket_base::max_listen_connections, ec);
-    CHECK_EC(ec, "listen/loop");
+LISTENER_TEMPLATE_DECLARE
+void listener<LISTENER_TEMPLATE_ATTRIBUTES>::loop(
+    const endpoint_type& endpoint, reuse_port_t,
+    const std::vector<std::reference_wrapper<boost::asio::io_context>>& contexts)
+{
+    const auto acceptors = contexts.size();
 
+    m_reuse_port = true;
+    m_acceptors.reserve(acceptors);
     m_endpoint = endpoint;
 
-    do_accept();
+    for (std::size_t idx = 0; idx < acceptors; ++idx) {
+        m_acceptors.emplace_back(contexts[idx].get());
+        m_acceptor_ctxs.push_back(&contexts[idx].get());
+        auto ec = do_listen(m_acceptors.back(), m_endpoint, true);
+        if (ec) {
+            close();
+            return;
+        }
+
+        // the rest of acceptors share the port chosen by the first one
+        if (idx == 0) {
+            m_endpoint = m_acceptors.back().local_endpoint(ec);
+        }
+    }
+
+    for (std::size_t idx = 0; idx < acceptors; ++idx) {
+        do_accept(idx);
+    }
+}
+
+LISTENER_TEMPLATE_DECLARE
+boost::system::error_code listener<LISTENER_TEMPLATE_ATTRIBUTES>::do_listen(
+    acceptor_type& acceptor, const endpoint_type& endpoint, bool reuse_port)
+{
+    auto ec = boost::system::error_code {};
+
+    const auto check = [this, &ec](std::string_view msg) {
+        if (ec && m_on_error) {
+            m_on_error(ec, msg);
+        }
+        return !ec;
+    };
+
+    acceptor.open(endpoint.protocol(), ec);
+    if (!check("open/loop")) {
+        return ec;
+    }
+
+    acceptor.set_option(boost::asio::socket_base::reuse_address(true), ec);
+    if (!check("set_option/loop")) {
+        return ec;
+    }
+
+    if (reuse_port) {
+#if defined(SO_REUSEPORT)
+        using reuse_port_option = boost::asio::detail::socket_option::boolean<
+            SOL_SOCKET, SO_REUSEPORT>;
+        acceptor.set_option(reuse_port_option(true), ec);
+#else
+        ec = boost::asio::error::operation_not_supported;
+#endif
+        if (!check("reuse_port/loop")) {
+            return ec;
+        }
+    }
+
+    acceptor.bind(endpoint, ec);
+    if (!check("bind/loop")) {
+        return ec;
+    }
+
+    acceptor.listen(boost::asio::socket_base::max_listen_connections, ec);
+    check("listen/loop");
+    return ec;
 }
 
 LISTENER_TEMPLATE_DECLARE
-void listener<LISTENER_TEMPLATE_ATTRIBUTES>::do_accept()
+void listener<LISTENER_TEMPLATE_ATTRIBUTES>::do_accept(std::size_t idx)
 {
-    m_acceptor.async_accept(
-        m_io_ctx, std::bind(&self_type::on_accept, this->shared_from_this(), std::placeholders::_1, std::placeholders::_2));
+    if (m_closed.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    // the acceptor waits for a connection to be released instead of
+    // accepting the one which can not be served
+    auto reserved = false;
+    if (m_limiter && m_limiter->limits().policy == overload_policy::pause) {
+        auto resume = [self = this->weak_from_this(), idx]() {
+            if (auto lstnr = self.lock()) {
+                boost::asio::post(*lstnr->m_acceptor_ctxs[idx],
+                    std::bind(&self_type::do_accept, lstnr, idx));
+            }
+        };
+        if (!m_limiter->reserve(std::move(resume))) {
+            return;
+        }
+        reserved = true;
+    }
+
+    // the reuse port acceptors keep the sockets on their own contexts
+    auto& ctx = m_reuse_port || !m_next_ctx ? *m_acceptor_ctxs[idx] : m_next_ctx();
+    m_acceptors[idx].async_accept(
+        ctx, std::bind(&self_type::on_accept, this->shared_from_this(), idx, reserved, std::placeholders::_1, std::placeholders::_2));
 }
 
 LISTENER_TEMPLATE_DECLARE
-void listener<LISTENER_TEMPLATE_ATTRIBUTES>::on_accept(
-    boost::system::error_code ec, socket_type socket)
+void listener<LISTENER_TEMPLATE_ATTRIBUTES>::on_accept(std::size_t idx,
+    bool reserved, boost::system::error_code ec, socket_type socket)
 {
-    boost::asio::post(static_cast<base::strand_stream&>(*this),
-        std::bind(&self_type::on_spawn_connect,
-            this->shared_from_this(), ec, std::move(socket)));
-    do_accept();
+    if (m_closed.load(std::memory_order_acquire)) {
+        if (reserved) {
+            m_limiter->cancel();
+        }
+        return;
+    }
+
+    if (ec && reserved) {
+        m_limiter->cancel();
+    }
+
+    std::optional<slot_type> slot;
+    if (m_limiter && !ec) {
+        if (reserved || m_limiter->reserve()) {
+            auto remote_ec = boost::system::error_code {};
+            const auto remote = socket.remote_endpoint(remote_ec);
+            if (!remote_ec) {
+                slot = m_limiter->admit(remote.address());
+            } else {
+                m_limiter->cancel();
+            }
+        }
+
+        if (!slot) {
+            do_shed(std::move(socket));
+            do_accept(idx);
+            return;
+        }
+    }
+
+    if (m_reuse_port) {
+        // each acceptor completes on its own thread, no need to funnel
+        on_spawn_connect(ec, socket, slot);
+    } else {
+        boost::asio::post(static_cast<base::strand_stream&>(*this),
+            std::bind(&self_type::on_spawn_connect,
+                this->shared_from_this(), ec, std::move(socket), std::move(slot)));
+    }
+
+    do_accept(idx);
 }
 
 LISTENER_TEMPLATE_DECLARE
 void listener<LISTENER_TEMPLATE_ATTRIBUTES>::on_spawn_connect(
-    boost::system::error_code ec, socket_type& socket)
+    boost::system::error_code ec, socket_type& socket,
+    std::optional<slot_type>& slot)
 {
-    BOOST_ASSERT(m_on_accept != nullptr);
+    BOOST_ASSERT(m_on_accept != nullptr || m_on_admit != nullptr);
     CHECK_EC(ec, "accept/loop");
+    if (m_on_admit) {
+        m_on_admit(std::move(socket), slot ? std::move(*slot) : slot_type {});
+        return;
+    }
     m_on_accept(std::move(socket));
 }
 
+LISTENER_TEMPLATE_DECLARE
+void listener<LISTENER_TEMPLATE_ATTRIBUTES>::do_shed(socket_type socket)
+{
+    m_shed.fetch_add(1, std::memory_order_relaxed);
+
+    auto ec = boost::system::error_code {};
+    if (m_limiter->limits().policy != overload_policy::reject) {
+        socket.close(ec);
+        return;
+    }
+
+    static const prepared_response unavailable { []() {
+        auto rp = make_empty_response(http::status::service_unavailable, 11);
+        rp.set(http::field::retry_after, "1");
+        rp.prepare_payload();
+        return rp;
+    }() };
+
+    // the response is small enough not to be bounded by a timer
+    auto sock = std::make_shared<socket_type>(std::move(socket));
+    auto rp = std::make_shared<prepared_response>(unavailable.keep_alive(false));
+    boost::asio::async_write(*sock, rp->buffers(),
+        [sock, rp](boost::system::error_code, std::size_t) {
+            auto ec = boost::system::error_code {};
+            sock->shutdown(socket_type::shutdown_both, ec);
+            sock->close(ec);
+        });
+}
+
 ROUTER_NAMESPACE_END()
@@ -6,6 +6,8 @@ template <class Session>
 router<Session>::router()
     : m_method_map { new method_map_type {} }
     , m_mutex { new mutex_type {} }
+    , m_admission { nullptr }
+    , m_metrics { nullptr }
 {
     if constexpr (session_type::is_request::value) {
         not_found(&router<Session>::not_found_handler);
@@ -34,24 +36,95 @@ router<Session>::get_resource_map() const
     return m_method_map;
 }
 
+template <class Session>
+ROUTER_DECL void router<Session>::admission(std::shared_ptr<admission_controller> controller)
+{
+    m_admission = std::move(controller);
+}
+
+template <class Session>
+ROUTER_DECL std::shared_ptr<admission_controller> router<Session>::admission() const
+{
+    return m_admission;
+}
+
+template <class Session>
+ROUTER_DECL void router<Session>::metrics(std::shared_ptr<metrics_registry> registry,
+    const std::string& path)
+{
+    {
+        LOCKABLE_ENTER_TO_WRITE(get_mutex());
+        BOOST_ASSERT(m_method_map);
+
+        m_metrics = std::move(registry);
+        for (auto& [method, resource_map] : *m_method_map) {
+            for (auto& [resource, storage] : resource_map) {
+                bind_metrics(resource, method, storage);
+            }
+        }
+    }
+
+    if constexpr (session_type::is_request::value) {
+        if (m_metrics && !path.empty()) {
+            get(path, [registry = m_metrics](const typename session_type::message_type& rq,
+                          typename session_type::context_type& ctx) {
+                ctx.send(make_string_response(http::status::ok, rq.version(),
+                    registry->render(), metrics_registry::content_type));
+                if (rq.keep_alive()) {
+                    ctx.recv();
+                }
+            });
+        }
+    }
+}
+
+template <class Session>
+ROUTER_DECL std::shared_ptr<metrics_registry> router<Session>::metrics() const
+{
+    return m_metrics;
+}
+
 template <class Session>
 void router<Session>::add_resource(const std::string& path,
     const method_type& method,
     storage_type&& storage)
 {
+    // the pattern is compiled once rather than per request
+    storage.regex(path);
+
     LOCKABLE_ENTER_TO_WRITE(get_mutex());
     BOOST_ASSERT(m_method_map);
 
+    bind_metrics(path, method, storage);
+
     auto& resource_map = m_method_map->insert({ method, resource_map_type() }).first->second;
     resource_map.insert_or_assign(path, std::move(storage));
 }
 
+template <class Session>
+void router<Session>::bind_metrics(const std::string& path, const method_type& method,
+    storage_type& storage) const
+{
+    if (!m_metrics) {
+        storage.metrics(nullptr);
+        return;
+    }
+
+    // the "not_found" and the response handlers are labelled by the empty method
+    const std::string method_label { method != method_type::unknown
+            ? std::string_view { http::to_string(method) }
+            : std::string_view {} };
+    storage.metrics(m_metrics->route(method_label, path));
+}
+
 template <class Session>
 void swap(router<Session>& first, router<Session>& second) noexcept
 {
     using std::swap;
     swap(first.m_method_map, second.m_method_map);
     swap(first.m_mutex, second.m_mutex);
+    swap(first.m_admission, second.m_admission);
+    swap(first.m_metrics, second.m_metrics);
 }
 
 ROUTER_NAMESPACE_END()
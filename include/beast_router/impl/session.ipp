@@ -1,5 +1,10 @@
 #pragma once
 
+#if defined(ROUTER_HAS_IO_URING)
+#include <cerrno>
+#include <unistd.h>
+#endif
+
 ROUTER_NAMESPACE_BEGIN()
 
 template <bool IsRequest, class Body>
@@ -17,9 +22,9 @@ struct serializer<false, Body> {
 
 #define SESSION_TEMPLATE_DECLARE                                        \
     template <bool IsRequest, class Body, class Buffer, class Protocol, \
-        class Socket, class Connection>
+        class Socket, class Connection, class Tracer>
 #define SESSION_TEMPLATE_ATTRIBUTES \
-    IsRequest, Body, Buffer, Protocol, Socket, Connection
+    IsRequest, Body, Buffer, Protocol, Socket, Connection, Tracer
 
 SESSION_TEMPLATE_DECLARE
 template <class... OnAction>
@@ -59,14 +64,30 @@ session<SESSION_TEMPLATE_ATTRIBUTES>::impl::impl(socket_type&& socket,
     const on_error_type& on_error)
     : base::strand_stream { socket.get_executor() }
     , m_connection { std::move(socket), static_cast<base::strand_stream&>(*this) }
-    , m_timer { static_cast<base::strand_stream&>(*this) }
+    , m_wheel { timer_wheel::get(static_cast<base::strand_stream&>(*this).get_inner_executor()) }
+    , m_read_deadline { *this }
+    , m_write_deadline { *this }
+    , m_timeouts {}
+    , m_served { false }
+    , m_handshaking { false }
+    , m_read_deferred { false }
+    , m_body_start {}
+    , m_body_bytes { 0 }
+    , m_read_start {}
+    , m_read_bytes { 0 }
+    , m_header_done { false }
+    , m_write_start {}
+    , m_write_status { 0 }
     , m_buffer { std::move(buffer) }
     , m_on_error { on_error }
     , m_queue { *this }
     , m_serializer {}
     , m_parser {}
-    , m_dispatcher { router }
+    , m_dispatcher { router, on_error }
+    , m_attachments {}
+    , m_tracer {}
 {
+    trace(trace_point::accept);
 }
 
 #if defined(LINK_SSL)
@@ -77,14 +98,30 @@ session<SESSION_TEMPLATE_ATTRIBUTES>::impl::impl(boost::asio::ssl::context& ssl_
     const on_error_type& on_error)
     : base::strand_stream { socket.get_executor() }
     , m_connection { std::move(socket), ssl_ctx, static_cast<base::strand_stream&>(*this) }
-    , m_timer { static_cast<base::strand_stream&>(*this) }
+    , m_wheel { timer_wheel::get(static_cast<base::strand_stream&>(*this).get_inner_executor()) }
+    , m_read_deadline { *this }
+    , m_write_deadline { *this }
+    , m_timeouts {}
+    , m_served { false }
+    , m_handshaking { false }
+    , m_read_deferred { false }
+    , m_body_start {}
+    , m_body_bytes { 0 }
+    , m_read_start {}
+    , m_read_bytes { 0 }
+    , m_header_done { false }
+    , m_write_start {}
+    , m_write_status { 0 }
     , m_buffer { std::move(buffer) }
     , m_on_error { on_error }
     , m_queue { *this }
     , m_serializer {}
     , m_parser {}
-    , m_dispatcher { router }
+    , m_dispatcher { router, on_error }
+    , m_attachments {}
+    , m_tracer {}
 {
+    trace(trace_point::accept);
 }
 #endif
 
@@ -92,6 +129,7 @@ SESSION_TEMPLATE_DECLARE
 typename session<SESSION_TEMPLATE_ATTRIBUTES>::impl::self_type&
 session<SESSION_TEMPLATE_ATTRIBUTES>::impl::recv()
 {
+    m_read_deadline.m_phase = phase_type::none;
     do_read();
     return *this;
 }
@@ -105,13 +143,21 @@ session<SESSION_TEMPLATE_ATTRIBUTES>::impl::recv(timer_duration_type duration)
     return *this;
 }
 
+SESSION_TEMPLATE_DECLARE
+typename session<SESSION_TEMPLATE_ATTRIBUTES>::impl::self_type&
+session<SESSION_TEMPLATE_ATTRIBUTES>::impl::recv(const timeouts& timeouts)
+{
+    m_timeouts = timeouts;
+    return recv();
+}
+
 SESSION_TEMPLATE_DECLARE
 template <class Message>
 typename session<SESSION_TEMPLATE_ATTRIBUTES>::impl::self_type&
 session<SESSION_TEMPLATE_ATTRIBUTES>::impl::send(Message&& message,
     timer_duration_type duration)
 {
-    do_timer(std::move(duration));
+    do_timer(m_write_deadline, phase_type::total, std::move(duration));
     m_queue(std::forward<Message>(message));
     return *this;
 }
@@ -125,51 +171,237 @@ session<SESSION_TEMPLATE_ATTRIBUTES>::impl::send(Message&& message)
     return *this;
 }
 
+SESSION_TEMPLATE_DECLARE
+void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::trace(trace_point point)
+{
+    if constexpr (is_traced::value) {
+        m_tracer.trace(point, std::chrono::steady_clock::now());
+    }
+}
+
+SESSION_TEMPLATE_DECLARE
+void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::trace(trace_point point,
+    std::chrono::steady_clock::time_point at)
+{
+    if constexpr (is_traced::value) {
+        m_tracer.trace(point, at);
+    }
+}
+
 SESSION_TEMPLATE_DECLARE
 void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::do_timer(
     timer_duration_type duration)
 {
-    m_timer.expires_from_now(std::move(duration));
-    m_timer.async_wait(std::bind(&impl::on_timer, this->shared_from_this(),
-        std::placeholders::_1));
+    do_timer(m_read_deadline, phase_type::total, std::move(duration));
 }
 
 SESSION_TEMPLATE_DECLARE
-void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::on_timer(
-    boost::system::error_code ec)
+void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::do_timer(
+    deadline& dl, phase_type phase, timer_duration_type duration)
 {
-    if (ec && ec != boost::asio::error::operation_aborted) {
-        if (m_on_error) {
-            m_on_error(ec, "async_timer/on_timer");
-        }
+    dl.m_phase = phase;
+    if (duration == timer_duration_type::zero()) {
+        m_wheel.cancel(dl);
         return;
     }
+    m_wheel.arm(dl, duration, this->weak_from_this());
+}
 
-    if (m_timer.expiry() <= timer_type::clock_type::now()) {
-        if (m_on_error) {
-            auto ec = make_error_code(boost::asio::error::timed_out);
+SESSION_TEMPLATE_DECLARE
+void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::deadline::on_expire()
+{
+    boost::asio::dispatch(static_cast<base::strand_stream&>(m_owner),
+        [impl = m_owner.shared_from_this(), this]() { impl->on_timer(*this); });
+}
+
+SESSION_TEMPLATE_DECLARE
+void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::on_timer(deadline& dl)
+{
+    // the deadline was cancelled or moved meanwhile
+    if (dl.expiry() > timer_wheel::clock_type::now()) {
+        return;
+    }
+
+    if (m_on_error) {
+        auto ec = make_error_code(boost::asio::error::timed_out);
+        switch (dl.m_phase) {
+        case phase_type::first_byte:
+            m_on_error(ec, "async_timer/first_byte");
+            break;
+        case phase_type::header:
+            m_on_error(ec, "async_timer/header");
+            break;
+        case phase_type::body:
+            m_on_error(ec, "async_timer/body");
+            break;
+        case phase_type::idle:
+            m_on_error(ec, "async_timer/idle");
+            break;
+        case phase_type::write:
+            m_on_error(ec, "async_timer/write");
+            break;
+        default:
             m_on_error(ec, "async_timer/on_timer");
+            break;
         }
-        do_eof(shutdown_type::shutdown_both);
     }
+    do_eof(shutdown_type::shutdown_both);
 }
 
 SESSION_TEMPLATE_DECLARE
 void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::do_read()
 {
-    m_connection.async_read(
-        m_buffer, m_parser,
-        std::bind(&impl::on_read, this->shared_from_this(), std::placeholders::_1,
+    // the read issued while handshaking starts once the handshake completes
+    if (m_handshaking) {
+        m_read_deferred = true;
+        return;
+    }
+
+    // a parser handles a single message only
+    m_parser.emplace();
+    m_read_bytes = 0;
+    m_header_done = false;
+
+    // the counted and the traced requests are read in phases to find their
+    // first byte and the end of the header
+    const auto total = m_read_deadline.m_phase == phase_type::total;
+    const auto phased = is_traced::value || m_dispatcher.instrumented()
+        || (!total
+            && (m_timeouts.first_byte != timer_duration_type::zero()
+                || m_timeouts.header != timer_duration_type::zero()
+                || m_timeouts.idle != timer_duration_type::zero()
+                || m_timeouts.min_body_rate != 0));
+    if (!phased) {
+        m_connection.async_read(
+            m_buffer, *m_parser,
+            std::bind(&impl::on_read, this->shared_from_this(), std::placeholders::_1,
+                std::placeholders::_2));
+        return;
+    }
+
+    // a pipelined request is already in the buffer
+    if (m_buffer.size() != 0) {
+        if (m_dispatcher.instrumented()) {
+            m_read_start = route_metrics::clock_type::now();
+        }
+        if (!total) {
+            do_timer(m_read_deadline, phase_type::header, m_timeouts.header);
+        }
+        do_read_some();
+        return;
+    }
+
+    if (!total) {
+        if (m_served) {
+            do_timer(m_read_deadline, phase_type::idle, m_timeouts.idle);
+        } else {
+            do_timer(m_read_deadline, phase_type::first_byte, m_timeouts.first_byte);
+        }
+    }
+    do_read_first();
+}
+
+SESSION_TEMPLATE_DECLARE
+void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::do_read_first()
+{
+    // the parser does not report a partial header, the first bytes are read
+    // as is
+    m_connection.async_read_some(
+        m_buffer,
+        std::bind(&impl::on_read_first, this->shared_from_this(), std::placeholders::_1,
+            std::placeholders::_2));
+}
+
+SESSION_TEMPLATE_DECLARE
+void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::on_read_first(
+    boost::system::error_code ec, size_t bytes_transferred)
+{
+    if (ec == boost::asio::error::eof) {
+        ec = boost::beast::http::error::end_of_stream;
+    }
+    if (ec) {
+        on_read(ec, 0);
+        return;
+    }
+
+    m_buffer.commit(bytes_transferred);
+    if (m_dispatcher.instrumented()) {
+        m_read_start = route_metrics::clock_type::now();
+    }
+    if (m_read_deadline.m_phase != phase_type::total) {
+        do_timer(m_read_deadline, phase_type::header, m_timeouts.header);
+    }
+    do_read_some();
+}
+
+SESSION_TEMPLATE_DECLARE
+void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::do_read_some()
+{
+    m_connection.async_read_some(
+        m_buffer, *m_parser,
+        std::bind(&impl::on_read_some, this->shared_from_this(), std::placeholders::_1,
             std::placeholders::_2));
 }
 
+SESSION_TEMPLATE_DECLARE
+void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::on_read_some(
+    boost::system::error_code ec, size_t bytes_transferred)
+{
+    // the bytes consumed by the parser, i.e. the size of the request
+    m_read_bytes += bytes_transferred;
+    if (!m_header_done && m_parser->is_header_done()) {
+        m_header_done = true;
+        trace(trace_point::header);
+    }
+    if (ec || m_parser->is_done()) {
+        on_read(ec, bytes_transferred);
+        return;
+    }
+
+    // the total deadline stays as is
+    if (m_read_deadline.m_phase == phase_type::total) {
+        do_read_some();
+        return;
+    }
+
+    // the parser returns once the header is complete and then per a part of
+    // the body; the deadline entry is re-armed in place
+    if (m_timeouts.min_body_rate == 0) {
+        if (m_read_deadline.m_phase != phase_type::body) {
+            do_timer(m_read_deadline, phase_type::body, timer_duration_type::zero());
+        }
+    } else {
+        const auto now = timer_wheel::clock_type::now();
+        if (m_read_deadline.m_phase != phase_type::body) {
+            m_body_start = now;
+            m_body_bytes = 0;
+        } else {
+            m_body_bytes += bytes_transferred;
+        }
+
+        const auto allowed = std::chrono::microseconds {
+            m_body_bytes * 1000000 / m_timeouts.min_body_rate
+        };
+        do_timer(m_read_deadline, phase_type::body,
+            std::chrono::duration_cast<timer_duration_type>(m_body_start + m_timeouts.body_grace + allowed - now));
+    }
+
+    do_read_some();
+}
+
 SESSION_TEMPLATE_DECLARE
 void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::on_read(
     boost::system::error_code ec, [[maybe_unused]] size_t bytes_transferred)
 {
-    m_timer.cancel();
+    m_wheel.cancel(m_read_deadline);
+    m_read_deadline.m_phase = phase_type::none;
+    m_served = true;
 
     if (ec == boost::beast::http::error::end_of_stream) {
+        /// a client awaits the response the peer has not sent
+        if (!is_request::value && m_on_error) {
+            m_on_error(ec, "async_read/on_read");
+        }
         do_eof(shutdown_type::shutdown_both);
         return;
     }
@@ -178,7 +410,17 @@ void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::on_read(
         m_on_error(ec, "async_read/on_read");
     }
 
-    do_process_request(m_parser.release());
+    trace(trace_point::body);
+    if (!m_dispatcher.instrumented()) {
+        do_process_request(m_parser->release());
+        return;
+    }
+
+    const auto parse = route_metrics::clock_type::now() - m_read_start;
+    do_process_request(m_parser->release());
+    if (auto route = m_dispatcher.route()) {
+        route->received(m_read_bytes, parse);
+    }
 }
 
 SESSION_TEMPLATE_DECLARE
@@ -210,8 +452,26 @@ void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::do_write(
     using serializer_type =
         typename serializer<IsMessageRequest, MessageBody>::type;
 
+    if constexpr (std::is_same_v<MessageBody, boost::beast::http::file_body>) {
+        if (do_sendfile(message)) {
+            return;
+        }
+    }
+
+    if constexpr (IsMessageRequest) {
+        do_write_start(0);
+    } else {
+        do_write_start(message.result_int());
+    }
     m_serializer = std::make_any<serializer_type>(message);
 
+    // the stall is detected by writing the message piecewise
+    if (m_timeouts.write_stall != timer_duration_type::zero()
+        && m_write_deadline.m_phase != phase_type::total) {
+        do_write_some<serializer_type>(0, message.need_eof());
+        return;
+    }
+
     m_connection.async_write(
         std::any_cast<serializer_type&>(m_serializer),
         std::bind(&impl::on_write, this->shared_from_this(),
@@ -219,29 +479,236 @@ void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::do_write(
             message.need_eof()));
 }
 
+SESSION_TEMPLATE_DECLARE
+template <class Serializer>
+void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::do_write_some(
+    std::size_t bytes_transferred, bool close)
+{
+    do_write_timer();
+
+    m_connection.async_write_some(
+        std::any_cast<Serializer&>(m_serializer),
+        [self = this->shared_from_this(), bytes_transferred, close](
+            boost::system::error_code ec, std::size_t bytes) {
+            if (ec || std::any_cast<Serializer&>(self->m_serializer).is_done()) {
+                self->on_write(ec, bytes_transferred + bytes, close);
+                return;
+            }
+            self->template do_write_some<Serializer>(bytes_transferred + bytes, close);
+        });
+}
+
+SESSION_TEMPLATE_DECLARE
+void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::do_write_timer()
+{
+    if (m_write_deadline.m_phase != phase_type::total) {
+        do_timer(m_write_deadline, phase_type::write, m_timeouts.write_stall);
+    }
+}
+
+SESSION_TEMPLATE_DECLARE
+void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::do_write_start(unsigned status)
+{
+    trace(trace_point::write_start);
+
+    // the status is counted once the write completes; zero denotes a part of
+    // a response
+    m_write_status = status;
+    if (m_dispatcher.instrumented()) {
+        m_write_start = route_metrics::clock_type::now();
+    }
+}
+
+#if defined(ROUTER_HAS_IO_URING)
+SESSION_TEMPLATE_DECLARE
+template <bool IsMessageRequest, class Fields>
+void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::do_write(
+    boost::beast::http::message<IsMessageRequest,
+        boost::beast::http::file_body, Fields>& message)
+{
+    using serializer_type =
+        typename serializer<IsMessageRequest, boost::beast::http::file_body>::type;
+
+    if (do_sendfile(message)) {
+        return;
+    }
+
+    // the raw file bytes can not carry the chunk framing, the serializer does
+    if (message.chunked()) {
+        do_write<IsMessageRequest, boost::beast::http::file_body, Fields>(message);
+        return;
+    }
+
+    const auto need_eof = message.need_eof();
+    auto& body = message.body();
+
+    // the positional reads go through the ring on a duplicate of the descriptor
+    auto ec = boost::system::error_code {};
+    const auto offset = body.file().pos(ec);
+    const auto size = body.size();
+    boost::asio::random_access_file file { m_connection.stream().get_executor() };
+    if (!ec) {
+        const auto fd = ::dup(body.file().native_handle());
+        if (fd == -1) {
+            ec.assign(errno, boost::system::system_category());
+        } else {
+            file.assign(fd, ec);
+        }
+    }
+    if (ec) {
+        on_write(ec, 0, need_eof);
+        return;
+    }
+
+    if constexpr (IsMessageRequest) {
+        do_write_start(0);
+    } else {
+        do_write_start(message.result_int());
+    }
+    m_serializer = std::make_any<serializer_type>(message);
+
+    do_write_timer();
+    m_connection.async_write_header(
+        std::any_cast<serializer_type&>(m_serializer),
+        [self = this->shared_from_this(), file = std::move(file), offset, size,
+            need_eof](boost::system::error_code ec, std::size_t) mutable {
+            if (ec) {
+                self->on_write(ec, 0, need_eof);
+                return;
+            }
+
+            self->m_connection.async_write_file(std::move(file), offset, size,
+                std::bind(&impl::on_write, self, std::placeholders::_1,
+                    std::placeholders::_2, need_eof));
+        });
+}
+#endif
+
+SESSION_TEMPLATE_DECLARE
+template <bool IsMessageRequest, class Fields>
+bool session<SESSION_TEMPLATE_ATTRIBUTES>::impl::do_sendfile(
+    boost::beast::http::message<IsMessageRequest,
+        boost::beast::http::file_body, Fields>& message)
+{
+#if defined(LINK_SSL) && defined(ROUTER_HAS_SENDFILE)
+    using serializer_type =
+        typename serializer<IsMessageRequest, boost::beast::http::file_body>::type;
+
+    // the file is sent within the kernel once it encrypts the writes
+    if constexpr (connection_type::is_ssl_context::value) {
+        auto ec = boost::system::error_code {};
+        const auto offset = message.body().file().pos(ec);
+        if (!m_connection.is_ktls() || message.chunked() || ec) {
+            return false;
+        }
+
+        const auto need_eof = message.need_eof();
+        const auto fd = message.body().file().native_handle();
+        const auto size = message.body().size();
+
+        if constexpr (IsMessageRequest) {
+            do_write_start(0);
+        } else {
+            do_write_start(message.result_int());
+        }
+        m_serializer = std::make_any<serializer_type>(message);
+
+        // the queued message keeps the file open until the write completes
+        do_write_timer();
+        m_connection.async_write_header(
+            std::any_cast<serializer_type&>(m_serializer),
+            [self = this->shared_from_this(), fd, offset, size, need_eof](
+                boost::system::error_code ec, std::size_t) {
+                if (ec) {
+                    self->on_write(ec, 0, need_eof);
+                    return;
+                }
+
+                self->m_connection.async_sendfile(fd, offset, size,
+                    std::bind(&impl::on_write, self, std::placeholders::_1,
+                        std::placeholders::_2, need_eof));
+            });
+        return true;
+    }
+#endif
+    boost::ignore_unused(message);
+    return false;
+}
+
+SESSION_TEMPLATE_DECLARE
+void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::do_write(base::stream_head& head)
+{
+    using serializer_type = boost::beast::http::response_serializer<
+        boost::beast::http::empty_body>;
+
+    do_write_start(head.message.result_int());
+    m_serializer = std::make_any<serializer_type>(head.message);
+
+    do_write_timer();
+    m_connection.async_write_header(
+        std::any_cast<serializer_type&>(m_serializer),
+        std::bind(&impl::on_write, this->shared_from_this(),
+            std::placeholders::_1, std::placeholders::_2, false));
+}
+
+SESSION_TEMPLATE_DECLARE
+void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::do_write(prepared_response& response)
+{
+    do_write_start(static_cast<unsigned>(response.result()));
+    do_write_timer();
+    m_connection.async_write_buffers(
+        response.buffers(),
+        std::bind(&impl::on_write, this->shared_from_this(),
+            std::placeholders::_1, std::placeholders::_2, response.need_eof()));
+}
+
+SESSION_TEMPLATE_DECLARE
+void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::do_write(base::stream_chunk& chunk)
+{
+    do_write_start(0);
+    do_write_timer();
+    m_connection.async_write_buffers(
+        chunk.buffers(),
+        std::bind(&impl::on_write, this->shared_from_this(),
+            std::placeholders::_1, std::placeholders::_2, chunk.need_eof()));
+}
+
 SESSION_TEMPLATE_DECLARE
 void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::on_write(
     boost::system::error_code ec,
-    [[maybe_unused]] std::size_t bytes_transferred, bool close)
+    std::size_t bytes_transferred, bool close)
 {
-    m_timer.cancel();
+    m_wheel.cancel(m_write_deadline);
+    m_write_deadline.m_phase = phase_type::none;
+    trace(trace_point::write_end);
+
+    if (auto route = m_dispatcher.route(); route && !ec) {
+        route->sent(m_write_status, bytes_transferred,
+            route_metrics::clock_type::now() - m_write_start);
+    }
 
     if (ec == boost::beast::http::error::end_of_stream) {
+        m_queue.cancel(ec);
         do_eof(shutdown_type::shutdown_both);
         return;
     }
 
-    if (ec && m_on_error) {
-        m_on_error(ec, "async_write/on_write");
+    if (ec) {
+        if (m_on_error) {
+            m_on_error(ec, "async_write/on_write");
+        }
+        m_queue.cancel(ec);
         return;
     }
 
     if (close) {
+        m_queue.on_write(ec, bytes_transferred, false);
+        m_queue.cancel(boost::asio::error::operation_aborted);
         do_eof(shutdown_type::shutdown_both);
         return;
     }
 
-    m_queue.on_write();
+    m_queue.on_write(ec, bytes_transferred);
 }
 
 #if defined(LINK_SSL)
@@ -259,9 +726,17 @@ session<SESSION_TEMPLATE_ATTRIBUTES>::impl::do_handshake(Func&& func)
         }
     };
 
+    m_handshaking = true;
     if constexpr (is_request::value) {
         m_connection.async_handshake(boost::asio::ssl::stream_base::server, std::move(clb));
     } else {
+        /// the cached session of the upstream is offered if any
+        auto* native = m_connection.stream().native_handle();
+        if (auto cache = ssl::session_cache::get(SSL_get_SSL_CTX(native))) {
+            boost::system::error_code ec;
+            const auto peer = boost::beast::get_lowest_layer(m_connection.stream()).remote_endpoint(ec);
+            cache->resume(native, peer.address().to_string() + ":" + std::to_string(peer.port()));
+        }
         m_connection.async_handshake(boost::asio::ssl::stream_base::client, std::move(clb));
     }
     return *this;
@@ -272,14 +747,16 @@ template <class Func>
 typename session<SESSION_TEMPLATE_ATTRIBUTES>::impl::self_type&
 session<SESSION_TEMPLATE_ATTRIBUTES>::impl::do_handshake(Func&& func, timer_duration_type duration)
 {
-    m_timer.expires_from_now(std::move(duration));
+    do_timer(std::move(duration));
     return do_handshake(std::forward<Func>(func));
 }
 
 SESSION_TEMPLATE_DECLARE
 void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::on_handshake(boost::system::error_code ec)
 {
-    m_timer.cancel();
+    m_wheel.cancel(m_read_deadline);
+    m_handshaking = false;
+    const auto deferred = std::exchange(m_read_deferred, false);
 
     if (ec == boost::beast::http::error::end_of_stream) {
         do_eof(shutdown_type::shutdown_both);
@@ -290,6 +767,19 @@ void session<SESSION_TEMPLATE_ATTRIBUTES>::impl::on_handshake(boost::system::err
         m_on_error(ec, "async_handshake/on_handshake");
         return;
     }
+
+    if (!ec) {
+        auto* native = m_connection.stream().native_handle();
+        if (auto cache = ssl::session_cache::get(SSL_get_SSL_CTX(native))) {
+            cache->on_handshake(native);
+        }
+        m_connection.enable_ktls();
+        trace(trace_point::handshake);
+
+        if (deferred) {
+            do_read();
+        }
+    }
 }
 #endif
 
@@ -313,7 +803,8 @@ ROUTER_DECL void session<SESSION_TEMPLATE_ATTRIBUTES>::context<Impl>::recv()
 
 SESSION_TEMPLATE_DECLARE
 template <class Impl>
-template <class TimeDuration>
+template <class TimeDuration,
+    std::enable_if_t<utility::is_chrono_duration_v<std::decay_t<TimeDuration>>, bool>>
 ROUTER_DECL void session<SESSION_TEMPLATE_ATTRIBUTES>::context<Impl>::recv(
     TimeDuration&& duration)
 {
@@ -329,6 +820,18 @@ ROUTER_DECL void session<SESSION_TEMPLATE_ATTRIBUTES>::context<Impl>::recv(
                 std::forward<TimeDuration>(duration))));
 }
 
+SESSION_TEMPLATE_DECLARE
+template <class Impl>
+ROUTER_DECL void session<SESSION_TEMPLATE_ATTRIBUTES>::context<Impl>::recv(
+    const timeouts& timeouts)
+{
+    BOOST_ASSERT(m_impl != nullptr);
+    boost::asio::dispatch(
+        static_cast<base::strand_stream>(*m_impl),
+        std::bind(static_cast<Impl& (Impl::*)(const struct timeouts&)>(&Impl::recv),
+            m_impl->shared_from_this(), timeouts));
+}
+
 SESSION_TEMPLATE_DECLARE
 template <class Impl>
 template <class Message>
@@ -344,7 +847,17 @@ ROUTER_DECL void session<SESSION_TEMPLATE_ATTRIBUTES>::context<Impl>::send(
 
 SESSION_TEMPLATE_DECLARE
 template <class Impl>
-template <class Message, class TimeDuration>
+ROUTER_DECL typename session<SESSION_TEMPLATE_ATTRIBUTES>::template context<Impl>::executor_type
+session<SESSION_TEMPLATE_ATTRIBUTES>::context<Impl>::get_executor() const
+{
+    BOOST_ASSERT(m_impl != nullptr);
+    return static_cast<const base::strand_stream::asio_type&>(*m_impl);
+}
+
+SESSION_TEMPLATE_DECLARE
+template <class Impl>
+template <class Message, class TimeDuration,
+    std::enable_if_t<utility::is_chrono_duration_v<std::decay_t<TimeDuration>>, bool>>
 ROUTER_DECL void session<SESSION_TEMPLATE_ATTRIBUTES>::context<Impl>::send(
     Message&& message, TimeDuration&& duration) const
 {
@@ -358,6 +871,52 @@ ROUTER_DECL void session<SESSION_TEMPLATE_ATTRIBUTES>::context<Impl>::send(
         });
 }
 
+SESSION_TEMPLATE_DECLARE
+template <class Impl>
+template <class Message, class CompletionToken,
+    std::enable_if_t<!utility::is_chrono_duration_v<std::decay_t<CompletionToken>>, bool>>
+ROUTER_DECL auto session<SESSION_TEMPLATE_ATTRIBUTES>::context<Impl>::send(
+    Message&& message, CompletionToken&& token) const
+{
+    BOOST_ASSERT(m_impl != nullptr);
+
+    using message_type = std::decay_t<Message>;
+
+    auto initiation = [](auto handler, std::shared_ptr<Impl> impl, message_type msg) {
+        boost::asio::dispatch(static_cast<base::strand_stream>(*impl),
+            [impl, msg = std::move(msg), handler = std::move(handler)]() mutable {
+                // the queue completes on the strand; the handler is resumed
+                // on its own executor
+                impl->m_queue(std::move(msg),
+                    [impl, handler = std::move(handler)](boost::system::error_code ec,
+                        std::size_t bytes_transferred) mutable {
+                        const auto executor = boost::asio::get_associated_executor(handler,
+                            static_cast<const base::strand_stream::asio_type&>(*impl));
+                        boost::asio::dispatch(executor,
+                            boost::beast::bind_front_handler(std::move(handler), ec,
+                                bytes_transferred));
+                    });
+            });
+    };
+
+    return boost::asio::async_initiate<CompletionToken,
+        void(boost::system::error_code, std::size_t)>(
+        std::move(initiation), token, m_impl->shared_from_this(),
+        message_type { std::forward<Message>(message) });
+}
+
+SESSION_TEMPLATE_DECLARE
+template <class Impl>
+ROUTER_DECL base::stream_writer<Impl> session<SESSION_TEMPLATE_ATTRIBUTES>::context<Impl>::stream(
+    boost::beast::http::response<boost::beast::http::empty_body>&& header,
+    std::size_t high_watermark) const
+{
+    static_assert(is_request::value, "context::stream requirements are not met");
+
+    BOOST_ASSERT(m_impl != nullptr);
+    return base::stream_writer<Impl> { *m_impl, std::move(header), high_watermark };
+}
+
 SESSION_TEMPLATE_DECLARE
 template <class Impl>
 template <class Func>
@@ -398,6 +957,15 @@ ROUTER_DECL bool session<SESSION_TEMPLATE_ATTRIBUTES>::context<Impl>::is_open()
     return m_impl->m_connection.is_open();
 }
 
+SESSION_TEMPLATE_DECLARE
+template <class Impl>
+ROUTER_DECL typename session<SESSION_TEMPLATE_ATTRIBUTES>::tracer_type&
+session<SESSION_TEMPLATE_ATTRIBUTES>::context<Impl>::tracer() const
+{
+    BOOST_ASSERT(m_impl != nullptr);
+    return m_impl->m_tracer;
+}
+
 SESSION_TEMPLATE_DECLARE
 template <class Impl>
 template <class Type>
@@ -423,6 +991,20 @@ ROUTER_DECL void session<SESSION_TEMPLATE_ATTRIBUTES>::context<Impl>::set_user_d
     m_user_data = std::make_any<Type>(std::forward<Type>(data));
 }
 
+SESSION_TEMPLATE_DECLARE
+template <class Impl>
+template <class Type>
+ROUTER_DECL void session<SESSION_TEMPLATE_ATTRIBUTES>::context<Impl>::attach(
+    Type&& object) const
+{
+    BOOST_ASSERT(m_impl != nullptr);
+    boost::asio::dispatch(static_cast<base::strand_stream>(*m_impl),
+        [impl = m_impl->shared_from_this(),
+            obj = std::make_shared<std::decay_t<Type>>(std::forward<Type>(object))]() mutable {
+            impl->m_attachments.push_back(std::move(obj));
+        });
+}
+
 SESSION_TEMPLATE_DECLARE
 template <class Impl>
 ROUTER_DECL typename session<SESSION_TEMPLATE_ATTRIBUTES>::connection_type::stream_type&
@@ -2,16 +2,32 @@
 
 #include "base/config.hpp"
 #include "base/strand_stream.hpp"
+#include "common/connection_limiter.hpp"
+#include "common/http_utility.hpp"
+#include "common/prepared_response.hpp"
 #include "common/utility.hpp"
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/socket_base.hpp>
+#include <algorithm>
+#include <atomic>
 #include <boost/system/error_code.hpp>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string_view>
+#include <vector>
 
 ROUTER_NAMESPACE_BEGIN()
 
+/// Tag type selecting the listener mode with several `SO_REUSEPORT` acceptors
+struct reuse_port_t {
+    explicit reuse_port_t() = default;
+};
+
+/// Tag selecting the listener mode with several `SO_REUSEPORT` acceptors
+inline constexpr reuse_port_t reuse_port {};
+
 /// Listens and accepts the incoming connections.
 /**
  * The main class which listens and accepts the incoming connections.
@@ -39,6 +55,38 @@ ROUTER_NAMESPACE_BEGIN()
 
  *  http_listener_type::launch(g_ioc, {address, port}, on_accept, on_error);
  * ```
+ *
+ * By default the listener opens a single acceptor and passes the accepted
+ * sockets through its strand, i.e. `on_accept` is never invoked concurrently.
+ * The @ref reuse_port mode opens one acceptor per io thread bound to the same
+ * endpoint by `SO_REUSEPORT`; the kernel balances the incoming connections
+ * among them and `on_accept` is invoked right on the accepting thread, hence
+ * it has to be thread safe.
+ *
+ * With the @ref event_loop::topology::per_core event loop, the single acceptor
+ * assigns every accepted socket to an io context by the event loop policy
+ * whereas the @ref reuse_port acceptors run one per io context and the
+ * sockets stay on the context which has accepted them.
+ *
+ * The listener launched by the @ref on_admit_type callback counts the live
+ * connections within the given @ref connection_limits: every connection is
+ * handed over together with its @ref slot_type which has to live as long as
+ * the connection, e.g. by being attached to the session. Once the limits are
+ * reached, the accepting is paused or the connections are shed according to
+ * the @ref overload_policy.
+ *
+ * ```cpp
+ * beast_router::connection_limits limits;
+ * limits.max_connections = 10000;
+ * limits.max_per_address = 100;
+ *
+ * http_listener_type::on_admit_type on_admit = [&on_error](http_listener_type::socket_type socket,
+ *     http_listener_type::slot_type slot) {
+ *     http_server_type::recv(std::move(socket), g_router, on_error).attach(std::move(slot));
+ * };
+ *
+ * http_listener_type::launch(g_ioc, {address, port}, std::move(on_admit), std::move(on_error), limits);
+ * ```
  */
 template <class Protocol, class Acceptor,
     class Socket, template <typename> class Endpoint>
@@ -67,6 +115,12 @@ public:
     /// The on accept callback type
     using on_accept_type = std::function<void(socket_type)>;
 
+    /// The slot of an admitted connection
+    using slot_type = connection_limiter::slot;
+
+    /// The on accept callback type of the connections counted within the limits
+    using on_admit_type = std::function<void(socket_type, slot_type)>;
+
     /// The on error callback type
     using on_error_type = std::function<void(boost::system::error_code, std::string_view)>;
 
@@ -76,11 +130,11 @@ public:
     /// Assignment (disallowed)
     self_type& operator=(const listener&) = delete;
 
-    /// Constructor (default)
-    listener(listener&&) = default;
+    /// Constructor (disallowed)
+    listener(listener&&) = delete;
 
-    /// Assignment (default)
-    self_type& operator=(listener&&) = default;
+    /// Assignment (disallowed)
+    self_type& operator=(listener&&) = delete;
 
     /// Destructor
     ~listener() = default;
@@ -111,17 +165,116 @@ public:
 
         auto lstnr = std::make_shared<enable_make_shared>(static_cast<boost::asio::io_context&>(event_loop),
             std::forward<OnAction>(on_action)...);
+        if constexpr (utility::has_context_selector_v<EventLoop>) {
+            lstnr->m_next_ctx = [&event_loop]() -> boost::asio::io_context& {
+                return event_loop.get_context();
+            };
+        }
         lstnr->loop(endpoint);
         return lstnr;
     }
 
-    /// The method closes the associated acceptor
+    /// The factory method which creates `self_type` and starts listening by
+    /// several acceptors sharing the same endpoint
+    /**
+     * Opens one acceptor per thread of the event loop by using the
+     * `SO_REUSEPORT` socket option; the i-th acceptor runs on the i-th io
+     * context of the event loop
+     *
+     * @param event_loop A reference to the `event_loop`
+     * @param endpoint A const reference to the endpoint_type
+     * @param tag The @ref reuse_port tag
+     * @param on_action A list of actions suitable for the self construction i.e.
+     * `on_accept`, `on_error` signatures
+     * @returns `selft_type::listener_ptr_type`
+     */
+    template <class EventLoop, class... OnAction>
+    static auto launch(EventLoop& event_loop, const endpoint_type& endpoint,
+        reuse_port_t tag, OnAction&&... on_action)
+        -> decltype(self_type { static_cast<boost::asio::io_context&>(event_loop), std::declval<OnAction>()... }, listener_ptr_type())
+    {
+        struct enable_make_shared : public self_type {
+            enable_make_shared(boost::asio::io_context& ctx, OnAction&&... on_actions)
+                : self_type { ctx, std::forward<OnAction>(on_actions)... }
+            {
+            }
+        };
+
+        auto lstnr = std::make_shared<enable_make_shared>(static_cast<boost::asio::io_context&>(event_loop),
+            std::forward<OnAction>(on_action)...);
+        // a plain io context gets a single acceptor
+        std::vector<std::reference_wrapper<boost::asio::io_context>> contexts;
+        if constexpr (utility::has_context_selector_v<EventLoop>) {
+            for (std::size_t idx = 0; idx < std::max<std::size_t>(1, event_loop.get_threads()); ++idx) {
+                contexts.emplace_back(event_loop.get_context(idx % event_loop.get_contexts()));
+            }
+        } else {
+            contexts.emplace_back(static_cast<boost::asio::io_context&>(event_loop));
+        }
+        lstnr->loop(endpoint, tag, contexts);
+        return lstnr;
+    }
+
+    /// Returns the endpoint the listener is bound to
+    /**
+     * @returns `endpoint_type`
+     */
+    ROUTER_DECL endpoint_type local_endpoint() const
+    {
+        return m_endpoint;
+    }
+
+    /// Returns the number of acceptors
+    /**
+     * @returns std::size_t
+     */
+    ROUTER_DECL std::size_t acceptors() const
+    {
+        return m_acceptors.size();
+    }
+
+    /// Returns the number of the live connections
+    /**
+     * The connections are counted by the listener launched by the
+     * @ref on_admit_type callback only
+     *
+     * @returns std::size_t
+     */
+    ROUTER_DECL std::size_t connections() const
+    {
+        return m_limiter ? m_limiter->connections() : 0;
+    }
+
+    /// Returns the number of the live connections of the address
+    /**
+     * @param address The remote address
+     * @returns std::size_t
+     */
+    ROUTER_DECL std::size_t connections(const connection_limiter::address_type& address) const
+    {
+        return m_limiter ? m_limiter->connections(address) : 0;
+    }
+
+    /// Returns the number of the connections shed over the limits
+    /**
+     * @returns std::size_t
+     */
+    ROUTER_DECL std::size_t shed() const
+    {
+        return m_shed.load(std::memory_order_relaxed);
+    }
+
+    /// The method closes the associated acceptors
     /**
      * @returns void
      */
     ROUTER_DECL void close()
     {
-        m_acceptor.close();
+        m_closed.store(true, std::memory_order_release);
+        for (auto& acceptor : m_acceptors) {
+            auto ec = boost::system::error_code {};
+            acceptor.close(ec);
+        }
     }
 
 protected:
@@ -132,6 +285,10 @@ protected:
     explicit listener(boost::asio::io_context& ctx, on_accept_type&& on_accept,
         on_error_type&& on_error);
 
+    /// Constructor
+    explicit listener(boost::asio::io_context& ctx, on_admit_type&& on_admit,
+        on_error_type&& on_error, const connection_limits& limits = {});
+
     /// Starts a loop on the given endpoint
     /**
      * @param endpoint
@@ -139,22 +296,48 @@ protected:
      */
     void loop(const endpoint_type& endpoint);
 
+    /// Starts a loop on the given endpoint by several acceptors
+    /**
+     * @param endpoint
+     * @param tag The @ref reuse_port tag
+     * @param contexts The io context of each acceptor
+     * @returns void
+     */
+    void loop(const endpoint_type& endpoint, reuse_port_t tag,
+        const std::vector<std::reference_wrapper<boost::asio::io_context>>& contexts);
+
+    /// Opens, binds and starts listening by the acceptor
+    boost::system::error_code do_listen(acceptor_type& acceptor,
+        const endpoint_type& endpoint, bool reuse_port);
+
     /// An async accept method. Passes on_accept() as an internal callback which
     /// triggers on new connection
-    void do_accept();
+    void do_accept(std::size_t idx);
 
     /// An internal on_accept callback and passes the event to on_spawn_method
     /// through the loop
-    void on_accept(boost::system::error_code ec, socket_type socket);
+    void on_accept(std::size_t idx, bool reserved, boost::system::error_code ec,
+        socket_type socket);
 
     /// Calls the given user specified on_accept callback
-    void on_spawn_connect(boost::system::error_code ec, socket_type& socket);
+    void on_spawn_connect(boost::system::error_code ec, socket_type& socket,
+        std::optional<slot_type>& slot);
+
+    /// Closes the connection over the limits by the policy
+    void do_shed(socket_type socket);
 
 private:
-    acceptor_type m_acceptor;
+    std::vector<acceptor_type> m_acceptors;
+    std::vector<boost::asio::io_context*> m_acceptor_ctxs;
+    std::function<boost::asio::io_context&()> m_next_ctx;
+    bool m_reuse_port;
+    std::atomic<bool> m_closed;
     boost::asio::io_context& m_io_ctx;
     on_accept_type m_on_accept;
+    on_admit_type m_on_admit;
     on_error_type m_on_error;
+    std::shared_ptr<connection_limiter> m_limiter;
+    std::atomic<std::size_t> m_shed;
     endpoint_type m_endpoint;
 };
 
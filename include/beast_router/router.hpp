@@ -3,7 +3,11 @@
 #include "base/config.hpp"
 #include "base/lockable.hpp"
 #include "base/storage.hpp"
+#include "common/admission_controller.hpp"
 #include "common/http_utility.hpp"
+#include "common/metrics.hpp"
+#include "common/prepared_response.hpp"
+#include "common/route_options.hpp"
 #include "common/utility.hpp"
 #include <regex>
 #include <unordered_map>
@@ -41,6 +45,10 @@ ROUTER_NAMESPACE_BEGIN()
  *
  * g_router.get(R"(^/.*$)", std::move(clb));
  * @endcode
+ *
+ * The handlers run inline on the io thread unless the route is registered
+ * within the @ref route_options::offload pool; then the chain runs on the
+ * pool whereas the context still sends through the session strand.
  */
 template <class Session>
 class router final {
@@ -158,6 +166,36 @@ public:
             storage_type { std::forward<OnRequest>(on_request)... });
     }
 
+    /// The method adds handlers within the route options and links them within
+    /// the given path (RegExp) for the `"GET"` method
+    /**
+     * @param path The <tt>std::string</tt> type and refers to RegExp associated
+     * within the handlers
+     * @param options The route options, see @ref route_options
+     * @param on_request A variadic template of the handlers to be sequentially
+     * executed for the given <tt>path</tt>
+     * @returns void
+     *
+     * @note For more in details please refere to the @ref get() method
+     * description
+     */
+    template <class... OnRequest,
+#if not ROUTER_DOXYGEN
+        bool is_request = session_type::is_request::value,
+        std::enable_if_t<
+            utility::is_class_creatable_v<storage_type, OnRequest...> && is_request,
+            bool>
+        = true
+#endif
+        >
+    ROUTER_DECL void get(const std::string& path, route_options options,
+        OnRequest&&... on_request)
+    {
+        storage_type storage { std::forward<OnRequest>(on_request)... };
+        storage.options(std::move(options));
+        add_resource(path, method_type::get, std::move(storage));
+    }
+
     /// The methods adds handlers and links them within the given path (RegExp)
     /// for the `"PUT"` method
     /**
@@ -188,6 +226,36 @@ public:
             storage_type { std::forward<OnRequest>(on_request)... });
     }
 
+    /// The method adds handlers within the route options and links them within
+    /// the given path (RegExp) for the `"PUT"` method
+    /**
+     * @param path The <tt>std::string</tt> type and refers to RegExp associated
+     * within the handlers
+     * @param options The route options, see @ref route_options
+     * @param on_request A variadic template of the handlers to be sequentially
+     * executed for the given <tt>path</tt>
+     * @returns void
+     *
+     * @note For more in details please refere to the @ref get() method
+     * description
+     */
+    template <class... OnRequest,
+#if not ROUTER_DOXYGEN
+        bool is_request = session_type::is_request::value,
+        std::enable_if_t<
+            utility::is_class_creatable_v<storage_type, OnRequest...> && is_request,
+            bool>
+        = true
+#endif
+        >
+    ROUTER_DECL void put(const std::string& path, route_options options,
+        OnRequest&&... on_request)
+    {
+        storage_type storage { std::forward<OnRequest>(on_request)... };
+        storage.options(std::move(options));
+        add_resource(path, method_type::put, std::move(storage));
+    }
+
     /// The methods adds handlers and links them within the given path (RegExp)
     /// for the `"POST"` method
     /**
@@ -218,6 +286,36 @@ public:
             storage_type { std::forward<OnRequest>(on_request)... });
     }
 
+    /// The method adds handlers within the route options and links them within
+    /// the given path (RegExp) for the `"POST"` method
+    /**
+     * @param path The <tt>std::string</tt> type and refers to RegExp associated
+     * within the handlers
+     * @param options The route options, see @ref route_options
+     * @param on_request A variadic template of the handlers to be sequentially
+     * executed for the given <tt>path</tt>
+     * @returns void
+     *
+     * @note For more in details please refere to the @ref get() method
+     * description
+     */
+    template <class... OnRequest,
+#if not ROUTER_DOXYGEN
+        bool is_request = session_type::is_request::value,
+        std::enable_if_t<
+            utility::is_class_creatable_v<storage_type, OnRequest...> && is_request,
+            bool>
+        = true
+#endif
+        >
+    ROUTER_DECL void post(const std::string& path, route_options options,
+        OnRequest&&... on_request)
+    {
+        storage_type storage { std::forward<OnRequest>(on_request)... };
+        storage.options(std::move(options));
+        add_resource(path, method_type::post, std::move(storage));
+    }
+
     /// The methods adds handlers and links them within the given path (RegExp)
     /// for the `"DELETE"` method
     /**
@@ -248,6 +346,36 @@ public:
             storage_type { std::forward<OnRequest>(on_request)... });
     }
 
+    /// The method adds handlers within the route options and links them within
+    /// the given path (RegExp) for the `"DELETE"` method
+    /**
+     * @param path The <tt>std::string</tt> type and refers to RegExp associated
+     * within the handlers
+     * @param options The route options, see @ref route_options
+     * @param on_request A variadic template of the handlers to be sequentially
+     * executed for the given <tt>path</tt>
+     * @returns void
+     *
+     * @note For more in details please refere to the @ref get() method
+     * description
+     */
+    template <class... OnRequest,
+#if not ROUTER_DOXYGEN
+        bool is_request = session_type::is_request::value,
+        std::enable_if_t<
+            utility::is_class_creatable_v<storage_type, OnRequest...> && is_request,
+            bool>
+        = true
+#endif
+        >
+    ROUTER_DECL void delete_(const std::string& path, route_options options,
+        OnRequest&&... on_request)
+    {
+        storage_type storage { std::forward<OnRequest>(on_request)... };
+        storage.options(std::move(options));
+        add_resource(path, method_type::delete_, std::move(storage));
+    }
+
     /// The actions executors when no handlers for the resource are found
     /**
      * @param on_action the list of actions to be seq. invoked
@@ -302,20 +430,70 @@ public:
      */
     ROUTER_DECL method_const_map_pointer get_resource_map() const;
 
+    /// Sets the controller shedding the requests under the overload
+    /**
+     * The controller applies to the sessions created afterwards
+     *
+     * @param controller The admission controller; nothing is shed if null
+     * @returns void
+     */
+    ROUTER_DECL void admission(std::shared_ptr<admission_controller> controller);
+
+    /// Obtains the admission controller
+    /**
+     * @returns std::shared_ptr<admission_controller>
+     */
+    ROUTER_DECL std::shared_ptr<admission_controller> admission() const;
+
+    /// Sets the registry counting the requests per route
+    /**
+     * Binds the counters of the routes added so far and afterwards; the
+     * registry applies to the sessions created afterwards. The registry is
+     * rendered in the Prometheus text format by `GET` on the given path.
+     *
+     * @param registry The registry; nothing is counted if null
+     * @param path The RegExp of the metrics route; no route is added if empty
+     * @returns void
+     *
+     * @note The route is added for the session::is_request == true a.k.a
+     * server mode
+     */
+    ROUTER_DECL void metrics(std::shared_ptr<metrics_registry> registry,
+        const std::string& path = R"(^/metrics$)");
+
+    /// Obtains the metrics registry
+    /**
+     * @returns std::shared_ptr<metrics_registry>
+     */
+    ROUTER_DECL std::shared_ptr<metrics_registry> metrics() const;
+
 private:
     void add_resource(const std::string& path, const method_type& method,
         storage_type&& storage);
 
+    void bind_metrics(const std::string& path, const method_type& method,
+        storage_type& storage) const;
+
     static bool not_found_handler(const typename session_type::message_type& rq,
         typename session_type::context_type& ctx)
     {
-        ctx.send(make_string_response(http::status::not_found, rq.version(),
-            "Not Found"));
+        static const prepared_response not_found_rp {
+            make_string_response(http::status::not_found, 11, "Not Found")
+        };
+
+        if (rq.version() == not_found_rp.version()) {
+            ctx.send(not_found_rp.keep_alive(rq.keep_alive()));
+        } else {
+            ctx.send(make_string_response(http::status::not_found, rq.version(),
+                "Not Found"));
+        }
         return false; // break the chain of calls
     }
 
     method_map_pointer m_method_map;
     mutable mutex_pointer_type m_mutex;
+    std::shared_ptr<admission_controller> m_admission;
+    std::shared_ptr<metrics_registry> m_metrics;
 };
 
 ROUTER_NAMESPACE_END()
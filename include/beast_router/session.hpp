@@ -6,24 +6,35 @@
 #include "base/lockable.hpp"
 #include "base/storage.hpp"
 #include "base/strand_stream.hpp"
+#include "base/stream_writer.hpp"
 #include "common/connection.hpp"
+#include "common/timeouts.hpp"
 #include "common/timer.hpp"
+#include "common/timer_wheel.hpp"
+#include "common/tracing.hpp"
 #include "router.hpp"
 #include <algorithm>
 #include <any>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/async_result.hpp>
 #include <boost/asio/dispatch.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/socket_base.hpp>
+#include <boost/beast/core/bind_handler.hpp>
 #include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/stream_traits.hpp>
+#include <boost/beast/http/file_body.hpp>
 #include <boost/beast/http/parser.hpp>
 #include <boost/beast/http/serializer.hpp>
 #include <boost/beast/http/string_body.hpp>
+#include <optional>
 #include <string_view>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 ROUTER_NAMESPACE_BEGIN()
-template <bool, class, class, class, class, class>
+template <bool, class, class, class, class, class, class = null_tracer>
 class session;
 
 /// Default http server session type
@@ -47,6 +58,7 @@ ROUTER_NAMESPACE_END()
 
 #if defined(LINK_SSL)
 #include "common/ssl/connection.hpp"
+#include "common/ssl/session_cache.hpp"
 ROUTER_SSL_NAMESPACE_BEGIN()
 /// Default tls http server session type
 using http_server_type = session<true,
@@ -82,9 +94,12 @@ ROUTER_NAMESPACE_BEGIN()
  * @li Buffer -- A flat buffer which uses the default allocator
  * @li Protocol -- Defines a protocl used for
  * @li Socket -- Defines a sicket type
+ * @li Connection -- Defines a connection type
+ * @li Tracer -- Receives the timestamps of the request processing, see
+ * @ref null_tracer
  */
 template <bool IsRequest, class Body, class Buffer,
-    class Protocol, class Socket, class Connection>
+    class Protocol, class Socket, class Connection, class Tracer>
 class session final {
     class impl;
 
@@ -124,8 +139,16 @@ public:
     /// The connection type
     using connection_type = Connection;
 
+    /// The tracer type
+    using tracer_type = Tracer;
+
+    /// Indicates if the sessions are traced
+    using is_traced = std::conditional_t<std::is_same_v<tracer_type, null_tracer>, std::false_type,
+        std::true_type>;
+
     /// The self type
-    using self_type = session<is_request::value, body_type, buffer_type, protocol_type, socket_type, connection_type>;
+    using self_type = session<is_request::value, body_type, buffer_type, protocol_type, socket_type,
+        connection_type, tracer_type>;
 
     /// The mutex type
     using mutex_type = base::lockable::mutex_type;
@@ -163,6 +186,9 @@ public:
     /// Typedef definition of the dispatcher
     using dispatcher_type = base::dispatcher<self_type>;
 
+    /// Typedef definition of the response body streaming writer
+    using stream_writer_type = base::stream_writer<impl_type>;
+
     /// The method for receiving data
     /**
      * The method receives data send by a connection
@@ -196,6 +222,7 @@ public:
      * @returns @ref context_type
      */
     template <class TimeDuration,
+        std::enable_if_t<utility::is_chrono_duration_v<std::decay_t<TimeDuration>>, bool> = true,
         class... OnAction>
     static auto recv(std::piecewise_construct_t, socket_type&& socket, const router_type& router,
         TimeDuration&& duration, OnAction&&... on_action)
@@ -208,6 +235,29 @@ public:
         return ctx;
     }
 
+    /// The method for receiving data whithin the deadlines of the phases
+    /**
+     * The method receives data send by a connection; the deadlines are kept
+     * by the session and apply to every request of the connection
+     *
+     * @param socket An rvalue reference to the socket
+     * @param router A const reference to the Router
+     * @param timeouts The deadlines of the phases, see @ref timeouts
+     * @param on_action A list of callbacks
+     * @returns @ref context_type
+     */
+    template <class... OnAction>
+    static auto recv(std::piecewise_construct_t, socket_type&& socket, const router_type& router,
+        const timeouts& timeouts, OnAction&&... on_action)
+        -> decltype(not is_ssl_context_v, context_type())
+    {
+        static_assert(is_request::value, "session::recv requirements are not met");
+        context_type ctx = init_context(std::move(socket), router,
+            std::forward<OnAction>(on_action)...);
+        ctx.recv(timeouts);
+        return ctx;
+    }
+
     /// The method for sending data
     /**
      * The method does send data by the using the corresponding socket
@@ -269,7 +319,9 @@ public:
         return ctx;
     }
 
-    template <class TimeDuration, class... OnAction>
+    template <class TimeDuration,
+        std::enable_if_t<utility::is_chrono_duration_v<std::decay_t<TimeDuration>>, bool> = true,
+        class... OnAction>
     static auto recv(std::piecewise_construct_t, boost::asio::ssl::context& ssl_ctx,
         socket_type&& socket, const router_type& router, TimeDuration&& duration,
         OnAction&&... on_action)
@@ -284,6 +336,25 @@ public:
         return ctx;
     }
 
+    template <class... OnAction>
+    static auto recv(std::piecewise_construct_t, boost::asio::ssl::context& ssl_ctx,
+        socket_type&& socket, const router_type& router, const timeouts& timeouts,
+        OnAction&&... on_action)
+        -> decltype(is_ssl_context_v, context_type())
+    {
+        static_assert(is_request::value, "session::recv requirements are not met");
+        context_type ctx = init_context(ssl_ctx, std::move(socket), router,
+            std::forward<OnAction>(on_action)...);
+        // the handshake is bounded as a header is
+        auto func = [timeouts](context_type& ctx) { ctx.recv(timeouts); };
+        if (timeouts.header != timer_duration_type::zero()) {
+            ctx.handshake(std::move(func), timer_duration_type { timeouts.header });
+        } else {
+            ctx.handshake(std::move(func));
+        }
+        return ctx;
+    }
+
     template <class Request, class... OnAction>
     static auto send(boost::asio::ssl::context& ssl_ctx,
         socket_type&& socket, Request&& request,
@@ -337,6 +408,9 @@ private:
         template <class>
         friend class base::conn_queue;
 
+        template <class>
+        friend class base::stream_writer;
+
         using request_parser_type = boost::beast::http::request_parser<body_type>;
         using response_parser_type = boost::beast::http::response_parser<body_type>;
 
@@ -356,6 +430,7 @@ private:
 
         self_type& recv();
         self_type& recv(timer_duration_type duration);
+        self_type& recv(const timeouts& timeouts);
 
         template <class Message>
         self_type& send(Message&& message);
@@ -364,11 +439,42 @@ private:
         self_type& send(Message&& message,
             timer_duration_type duration);
 
+        void trace(trace_point point);
+        void trace(trace_point point, std::chrono::steady_clock::time_point at);
+
     private:
+        enum class phase_type {
+            none,
+            total,
+            first_byte,
+            header,
+            body,
+            idle,
+            write
+        };
+
+        struct deadline final : timer_wheel::entry {
+            explicit deadline(impl& owner)
+                : m_owner { owner }
+                , m_phase { phase_type::none }
+            {
+            }
+
+            void on_expire() override;
+
+            impl& m_owner;
+            phase_type m_phase;
+        };
+
         void do_timer(timer_duration_type duraion);
-        void on_timer(boost::system::error_code ec);
+        void do_timer(deadline& dl, phase_type phase, timer_duration_type duration);
+        void on_timer(deadline& dl);
 
         void do_read();
+        void do_read_first();
+        void on_read_first(boost::system::error_code ec, size_t bytes_transferred);
+        void do_read_some();
+        void on_read_some(boost::system::error_code ec, size_t bytes_transferred);
         void on_read(boost::system::error_code ec, size_t bytes_transferred);
 
         void do_eof(shutdown_type type);
@@ -380,6 +486,29 @@ private:
         void do_write(boost::beast::http::message<IsMessageRequest, MessageBody,
             Fields>& message);
 
+#if defined(ROUTER_HAS_IO_URING)
+        template <bool IsMessageRequest, class Fields>
+        void do_write(boost::beast::http::message<IsMessageRequest,
+            boost::beast::http::file_body, Fields>& message);
+#endif
+
+        template <bool IsMessageRequest, class Fields>
+        bool do_sendfile(boost::beast::http::message<IsMessageRequest,
+            boost::beast::http::file_body, Fields>& message);
+
+        void do_write(base::stream_head& head);
+
+        void do_write(prepared_response& response);
+
+        void do_write(base::stream_chunk& chunk);
+
+        template <class Serializer>
+        void do_write_some(std::size_t bytes_transferred, bool close);
+
+        void do_write_timer();
+
+        void do_write_start(unsigned status);
+
         void on_write(boost::system::error_code ec, std::size_t bytes_transferred,
             bool close);
 
@@ -395,13 +524,28 @@ private:
 
     private:
         connection_type m_connection;
-        timer_type m_timer;
+        timer_wheel& m_wheel;
+        deadline m_read_deadline;
+        deadline m_write_deadline;
+        timeouts m_timeouts;
+        bool m_served;
+        bool m_handshaking;
+        bool m_read_deferred;
+        timer_wheel::time_point_type m_body_start;
+        std::size_t m_body_bytes;
+        route_metrics::clock_type::time_point m_read_start;
+        std::size_t m_read_bytes;
+        bool m_header_done;
+        route_metrics::clock_type::time_point m_write_start;
+        unsigned m_write_status;
         buffer_type m_buffer;
         on_error_type m_on_error;
         conn_queue_type m_queue;
         std::any m_serializer;
-        parser_type m_parser;
+        std::optional<parser_type> m_parser;
         dispatcher_type m_dispatcher;
+        std::vector<std::shared_ptr<void>> m_attachments;
+        tracer_type m_tracer;
     };
 
 public:
@@ -421,9 +565,18 @@ public:
         friend class session;
 
     public:
+        /// The executor type i.e. the strand of the session
+        using executor_type = base::strand_stream::asio_type;
+
         /// Constructor
         context(Impl& impl);
 
+        /// Obtains the strand of the session
+        /**
+         * @returns @ref executor_type
+         */
+        ROUTER_DECL executor_type get_executor() const;
+
         /// The method receives a data send by the socket
         /**
          * @returns void
@@ -435,9 +588,20 @@ public:
          * @param duration A time duration used by the timer
          * @returns void
          */
-        template <class TimeDuration>
+        template <class TimeDuration,
+            std::enable_if_t<utility::is_chrono_duration_v<std::decay_t<TimeDuration>>, bool> = true>
         ROUTER_DECL void recv(TimeDuration&& duration);
 
+        /// The method receives a data send by the socket whithin the deadlines
+        /**
+         * The deadlines are kept by the session and apply to the subsequent
+         * calls of @ref recv() as well
+         *
+         * @param timeouts The deadlines of the phases, see @ref timeouts
+         * @returns void
+         */
+        ROUTER_DECL void recv(const timeouts& timeouts);
+
         /// The overloaded method does send data back to client
         /**
          * @param message The messge type associated with the Body
@@ -452,15 +616,61 @@ public:
          * @param duration A time duration used by the timer
          * @returns void
          */
-        template <class Message, class TimeDuration>
+        template <class Message, class TimeDuration,
+            std::enable_if_t<utility::is_chrono_duration_v<std::decay_t<TimeDuration>>, bool> = true>
         ROUTER_DECL void send(Message&& message, TimeDuration&& duration) const;
 
+        /// The overloaded method does send data back to client and completes once it is written
+        /**
+         * The equivalent function signature of the handler must be as the following:
+         * @code
+         * void handler(boost::system::error_code ec, std::size_t bytes_transferred);
+         * @endcode
+         *
+         * @par Example
+         *
+         * @code
+         * co_await ctx.send(std::move(response), boost::asio::use_awaitable);
+         * @endcode
+         *
+         * @param message The message type associated with the Body
+         * @param token The completion token e.g. `boost::asio::use_awaitable`
+         * @returns Depends on the completion token
+         */
+        template <class Message, class CompletionToken,
+            std::enable_if_t<!utility::is_chrono_duration_v<std::decay_t<CompletionToken>>, bool> = true>
+        ROUTER_DECL auto send(Message&& message, CompletionToken&& token) const;
+
+        /// The method starts streaming a response body back to client
+        /**
+         * The header is sent right away whereas the body is sent incrementally
+         * by using the returned writer, see @ref base::stream_writer
+         *
+         * @param header The response header
+         * @param high_watermark The number of pending bytes which triggers the
+         * backpressure
+         * @returns @ref base::stream_writer
+         */
+        ROUTER_DECL base::stream_writer<Impl> stream(
+            boost::beast::http::response<boost::beast::http::empty_body>&& header,
+            std::size_t high_watermark = base::stream_writer<Impl>::default_high_watermark) const;
+
         /// Obtains the state of the connection
         /**
          * @returns bool
          */
         [[nodiscard]] ROUTER_DECL bool is_open() const;
 
+        /// Obtains the tracer of the session
+        /**
+         * The tracer is called on the strand of the session, the handlers
+         * running inline may use it e.g. to correlate the points with the
+         * request
+         *
+         * @returns tracer_type
+         */
+        ROUTER_DECL tracer_type& tracer() const;
+
         /// Obtains the user data; lvalue reference context
         /**
          * @returns Type reference
@@ -483,6 +693,17 @@ public:
         template <class Type>
         ROUTER_DECL void set_user_data(Type&& data);
 
+        /// Attaches the object to the session
+        /**
+         * The object lives as long as the session does, e.g. the slot of the
+         * connection admitted by the listener
+         *
+         * @param object The object to be owned by the session
+         * @returns void
+         */
+        template <class Type>
+        ROUTER_DECL void attach(Type&& object) const;
+
         /// Obtains the current associated stream
         /**
          * @returns Reference of `connection_type::stream_type`
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <string_view>
+#include <thread>
+
+#include "beast_router.hpp"
+
+namespace test {
+
+namespace net = boost::asio;
+
+using server_type = beast_router::http_server_type;
+
+/// The time given to the loopback exchanges before the test fails
+inline constexpr std::chrono::seconds default_timeout { 10 };
+
+/// Serves a single connection by the router on its own io thread
+class loopback_server {
+public:
+    explicit loopback_server(const server_type::router_type& router)
+        : m_ioc {}
+        , m_acceptor { m_ioc, { net::ip::address_v4::loopback(), 0 } }
+        , m_on_error { [](boost::system::error_code, std::string_view) {} }
+        , m_thread {}
+    {
+        m_acceptor.async_accept([this, &router](boost::system::error_code ec, net::ip::tcp::socket socket) {
+            if (!ec) {
+                server_type::recv(std::move(socket), router, m_on_error);
+            }
+        });
+        m_thread = std::thread { [this]() { m_ioc.run(); } };
+    }
+
+    loopback_server(const loopback_server&) = delete;
+
+    loopback_server& operator=(const loopback_server&) = delete;
+
+    ~loopback_server()
+    {
+        net::post(m_ioc, [this]() {
+            boost::system::error_code ec;
+            m_acceptor.close(ec);
+        });
+        m_thread.join();
+    }
+
+    /// Returns the endpoint the connection is accepted on
+    net::ip::tcp::endpoint local_endpoint() const { return m_acceptor.local_endpoint(); }
+
+    /// Returns the id of the io thread
+    std::thread::id thread_id() const { return m_thread.get_id(); }
+
+    /// Sends a GET request and reads the response within the default timeout
+    beast_router::http_string_response fetch(std::string_view target, unsigned version = 11)
+    {
+        net::io_context client_ioc;
+        net::ip::tcp::socket socket { client_ioc };
+        socket.connect(m_acceptor.local_endpoint());
+
+        auto rq = beast_router::make_empty_request(beast_router::http::verb::get, version, target);
+        beast_router::http::write(socket, rq);
+
+        boost::beast::flat_buffer buffer;
+        beast_router::http_string_response rp;
+        bool done = false;
+        beast_router::http::async_read(socket, buffer, rp,
+            [&done](boost::system::error_code ec, std::size_t) {
+                BOOST_CHECK(!ec);
+                done = true;
+            });
+        client_ioc.run_for(default_timeout);
+        BOOST_CHECK_MESSAGE(done, "no response to " << target);
+
+        boost::system::error_code ec;
+        socket.close(ec);
+        return rp;
+    }
+
+private:
+    net::io_context m_ioc;
+    net::ip::tcp::acceptor m_acceptor;
+    server_type::on_error_type m_on_error;
+    std::thread m_thread;
+};
+
+/// Sends a GET request to the router over a loopback connection
+inline beast_router::http_string_response fetch(const server_type::router_type& router,
+    std::string_view target, unsigned version = 11)
+{
+    loopback_server server { router };
+    return server.fetch(target, version);
+}
+
+/// Waits for the predicate to hold
+/**
+ * @returns false once the timeout expires
+ */
+template <class Predicate>
+bool wait_until(Predicate&& pred, std::chrono::steady_clock::duration timeout = default_timeout)
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+} // namespace test
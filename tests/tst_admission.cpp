@@ -0,0 +1,86 @@
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "beast_router.hpp"
+#include "test_utility.hpp"
+
+using namespace std::chrono_literals;
+
+using controller_type = beast_router::admission_controller;
+using beast_router::route_priority;
+
+namespace {
+
+void next_interval(controller_type& controller, controller_type::duration_type delay)
+{
+    std::this_thread::sleep_for(20ms);
+    controller.record(delay);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(shedding_levels)
+{
+    controller_type::settings config;
+    config.target = 5ms;
+    config.interval = 10ms;
+    controller_type controller { config };
+
+    // a momentary spike is tolerated
+    controller.record(50ms);
+    controller.record(1ms);
+    next_interval(controller, 50ms);
+    BOOST_CHECK_EQUAL(controller.level(), 0u);
+    BOOST_CHECK(controller.admit(route_priority::low));
+
+    // a standing queue sheds the low priority first
+    next_interval(controller, 50ms);
+    BOOST_CHECK_EQUAL(controller.level(), 1u);
+    BOOST_CHECK(!controller.admit(route_priority::low));
+    BOOST_CHECK(controller.admit(route_priority::normal));
+
+    next_interval(controller, 50ms);
+    BOOST_CHECK_EQUAL(controller.level(), 2u);
+    BOOST_CHECK(!controller.admit(route_priority::normal));
+    BOOST_CHECK(controller.admit(route_priority::high));
+    BOOST_CHECK_EQUAL(controller.rejected(), 2u);
+
+    // the level goes down once the queue drains
+    next_interval(controller, 1ms);
+    next_interval(controller, 1ms);
+    next_interval(controller, 1ms);
+    BOOST_CHECK_EQUAL(controller.level(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(shed_response)
+{
+    using server_type = beast_router::http_server_type;
+
+    // the backlog of the io context stays over the target
+    controller_type::settings config;
+    config.target = 5ms;
+    config.interval = 10ms;
+    config.backlog = []() { return controller_type::duration_type { 1s }; };
+    auto controller = std::make_shared<controller_type>(config);
+
+    std::atomic<int> served { 0 };
+    server_type::router_type router;
+    router.admission(controller);
+    router.get(R"(^/low$)", beast_router::route_options { nullptr, route_priority::low },
+        [&served](const auto& rq, auto& ctx) {
+            ++served;
+            ctx.send(beast_router::make_string_response(beast_router::http::status::ok, rq.version(), "ok"));
+        });
+
+    std::this_thread::sleep_for(20ms);
+    controller->record(0ms);
+    BOOST_REQUIRE_EQUAL(controller->level(), 1u);
+
+    const auto rp = test::fetch(router, "/low");
+    BOOST_CHECK_EQUAL(rp.result(), beast_router::http::status::service_unavailable);
+    BOOST_CHECK_EQUAL(rp[beast_router::http::field::retry_after], "1");
+    BOOST_CHECK_EQUAL(served, 0);
+}
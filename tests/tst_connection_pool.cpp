@@ -0,0 +1,307 @@
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "beast_router.hpp"
+#include "test_utility.hpp"
+
+namespace net = boost::asio;
+namespace http = beast_router::http;
+
+using namespace std::chrono_literals;
+
+using pool_type = beast_router::http_connection_pool_type;
+using listener_type = beast_router::http_listener_type;
+using server_type = beast_router::http_server_type;
+
+namespace {
+
+/// Serves any number of the connections and counts them
+class upstream {
+public:
+    upstream()
+        : m_router {}
+        , m_ioc {}
+        , m_listener {}
+        , m_accepted { 0 }
+        , m_thread {}
+    {
+        m_router.get(R"(^/$)", [](server_type::context_type& ctx) {
+            ctx.send(beast_router::make_string_response(http::status::ok, 11, "ok"));
+            ctx.recv();
+        });
+        m_router.post(R"(^/$)", [](server_type::context_type& ctx) {
+            ctx.send(beast_router::make_string_response(http::status::ok, 11, "posted"));
+            ctx.recv();
+        });
+        m_router.get(R"(^/echo/(\d+)$)", [](const server_type::message_type&, server_type::context_type& ctx,
+                                              const std::smatch& match) {
+            ctx.send(beast_router::make_string_response(http::status::ok, 11, match[1].str()));
+            ctx.recv();
+        });
+        m_router.get(R"(^/close$)", [](server_type::context_type& ctx) {
+            auto rp = beast_router::make_string_response(http::status::ok, 11, "close");
+            rp.keep_alive(false);
+            ctx.send(std::move(rp));
+        });
+        // promises to keep the connection open but closes it
+        m_router.get(R"(^/drop$)", [](server_type::context_type& ctx) {
+            ctx.send(beast_router::make_string_response(http::status::ok, 11, "drop"));
+        });
+
+        listener_type::on_accept_type on_accept = [this](listener_type::socket_type socket) {
+            ++m_accepted;
+            server_type::recv(std::move(socket), m_router,
+                server_type::on_error_type { [](boost::system::error_code, std::string_view) {} });
+        };
+        m_listener = listener_type::launch(m_ioc, { net::ip::address_v4::loopback(), 0 },
+            std::move(on_accept));
+        m_thread = std::thread { [this]() { m_ioc.run(); } };
+    }
+
+    upstream(const upstream&) = delete;
+
+    upstream& operator=(const upstream&) = delete;
+
+    ~upstream()
+    {
+        m_listener->close();
+        m_ioc.stop();
+        m_thread.join();
+    }
+
+    std::string port() const { return std::to_string(m_listener->local_endpoint().port()); }
+
+    int accepted() const { return m_accepted; }
+
+private:
+    server_type::router_type m_router;
+    net::io_context m_ioc;
+    listener_type::listener_ptr_type m_listener;
+    std::atomic<int> m_accepted;
+    std::thread m_thread;
+};
+
+/// Runs the io context of the pool
+class client {
+public:
+    client()
+        : m_ioc {}
+        , m_work { net::make_work_guard(m_ioc) }
+        , m_thread { [this]() { m_ioc.run(); } }
+    {
+    }
+
+    client(const client&) = delete;
+
+    client& operator=(const client&) = delete;
+
+    ~client()
+    {
+        m_work.reset();
+        m_ioc.stop();
+        m_thread.join();
+    }
+
+    net::io_context& ioc() { return m_ioc; }
+
+private:
+    net::io_context m_ioc;
+    net::executor_work_guard<net::io_context::executor_type> m_work;
+    std::thread m_thread;
+};
+
+/// Sends the request and waits for the completion
+std::pair<boost::system::error_code, std::string> fetch(pool_type& pool, const std::string& port,
+    std::string_view target)
+{
+    std::atomic<bool> done { false };
+    boost::system::error_code result;
+    std::string body;
+    pool.send("127.0.0.1", port, beast_router::make_empty_request(http::verb::get, 11, target),
+        [&](boost::system::error_code ec, const pool_type::response_type& rp) {
+            result = ec;
+            body = rp.body();
+            done = true;
+        });
+    BOOST_CHECK(test::wait_until([&done]() { return done.load(); }));
+    return { result, body };
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(connection_reuse)
+{
+    upstream server;
+    client clnt;
+    auto pool = pool_type::create(clnt.ioc());
+
+    for (int idx = 0; idx < 4; ++idx) {
+        const auto [ec, body] = fetch(*pool, server.port(), "/");
+        BOOST_CHECK(!ec);
+        BOOST_CHECK_EQUAL(body, "ok");
+    }
+
+    BOOST_CHECK_EQUAL(server.accepted(), 1);
+    BOOST_CHECK_EQUAL(pool->connections("127.0.0.1", server.port()), 1u);
+    BOOST_CHECK_EQUAL(pool->idle("127.0.0.1", server.port()), 1u);
+    pool->close();
+}
+
+BOOST_AUTO_TEST_CASE(per_host_limit)
+{
+    upstream server;
+    client clnt;
+    auto pool = pool_type::create(clnt.ioc(), beast_router::pool_limits { 2 });
+
+    constexpr int requests = 16;
+    std::atomic<int> succeeded { 0 };
+    std::atomic<int> completed { 0 };
+    for (int idx = 0; idx < requests; ++idx) {
+        pool->send("127.0.0.1", server.port(), beast_router::make_empty_request(http::verb::get, 11, "/"),
+            [&](boost::system::error_code ec, const pool_type::response_type& rp) {
+                if (!ec && rp.body() == "ok") {
+                    ++succeeded;
+                }
+                ++completed;
+            });
+        BOOST_CHECK_LE(pool->connections("127.0.0.1", server.port()), 2u);
+    }
+
+    BOOST_CHECK(test::wait_until([&completed]() { return completed == requests; }));
+    BOOST_CHECK_EQUAL(succeeded, requests);
+    BOOST_CHECK_LE(server.accepted(), 2);
+    BOOST_CHECK_EQUAL(pool->connections("127.0.0.1", server.port()), pool->idle("127.0.0.1", server.port()));
+    pool->close();
+}
+
+BOOST_AUTO_TEST_CASE(closed_connections)
+{
+    upstream server;
+    client clnt;
+    auto pool = pool_type::create(clnt.ioc());
+
+    // the response asks to close the connection
+    BOOST_CHECK_EQUAL(fetch(*pool, server.port(), "/close").second, "close");
+    BOOST_CHECK_EQUAL(pool->connections("127.0.0.1", server.port()), 0u);
+
+    // the peer closes the idle connection, detected before the reuse
+    BOOST_CHECK_EQUAL(fetch(*pool, server.port(), "/drop").second, "drop");
+    BOOST_CHECK_EQUAL(pool->idle("127.0.0.1", server.port()), 1u);
+    std::this_thread::sleep_for(50ms);
+
+    const auto [ec, body] = fetch(*pool, server.port(), "/");
+    BOOST_CHECK(!ec);
+    BOOST_CHECK_EQUAL(body, "ok");
+    BOOST_CHECK_EQUAL(server.accepted(), 3);
+    BOOST_CHECK_EQUAL(pool->connections("127.0.0.1", server.port()), 1u);
+    pool->close();
+}
+
+BOOST_AUTO_TEST_CASE(idle_eviction)
+{
+    upstream server;
+    client clnt;
+    auto pool = pool_type::create(clnt.ioc(), beast_router::pool_limits { 8, 50ms, 10ms });
+
+    BOOST_CHECK(!fetch(*pool, server.port(), "/").first);
+    BOOST_CHECK_EQUAL(pool->idle("127.0.0.1", server.port()), 1u);
+    BOOST_CHECK(test::wait_until([&]() {
+        return pool->connections("127.0.0.1", server.port()) == 0;
+    }));
+    pool->close();
+}
+
+BOOST_AUTO_TEST_CASE(connect_error)
+{
+    std::string port;
+    {
+        net::io_context ioc;
+        net::ip::tcp::acceptor acceptor { ioc, { net::ip::address_v4::loopback(), 0 } };
+        port = std::to_string(acceptor.local_endpoint().port());
+    }
+
+    client clnt;
+    auto pool = pool_type::create(clnt.ioc());
+    BOOST_CHECK(fetch(*pool, port, "/").first);
+    BOOST_CHECK_EQUAL(pool->connections("127.0.0.1", port), 0u);
+
+    pool->close();
+    BOOST_CHECK_EQUAL(fetch(*pool, port, "/").first, net::error::operation_aborted);
+}
+
+BOOST_AUTO_TEST_CASE(pipelining)
+{
+    upstream server;
+    client clnt;
+    beast_router::pool_limits limits;
+    limits.max_per_host = 1;
+    limits.max_pipeline = 4;
+    auto pool = pool_type::create(clnt.ioc(), limits);
+
+    // the responses are matched to the requests in the order sent
+    constexpr int requests = 16;
+    std::mutex mutex;
+    std::vector<int> completed;
+    for (int idx = 0; idx < requests; ++idx) {
+        pool->send("127.0.0.1", server.port(),
+            beast_router::make_empty_request(http::verb::get, 11, "/echo/" + std::to_string(idx)),
+            [&, idx](boost::system::error_code ec, const pool_type::response_type& rp) {
+                BOOST_CHECK(!ec);
+                BOOST_CHECK_EQUAL(rp.body(), std::to_string(idx));
+                std::lock_guard<std::mutex> lock { mutex };
+                completed.push_back(idx);
+            });
+    }
+
+    BOOST_CHECK(test::wait_until([&]() {
+        std::lock_guard<std::mutex> lock { mutex };
+        return completed.size() == requests;
+    }));
+    for (int idx = 0; idx < requests; ++idx) {
+        BOOST_CHECK_EQUAL(completed[idx], idx);
+    }
+    BOOST_CHECK_EQUAL(server.accepted(), 1);
+    BOOST_CHECK_EQUAL(pool->idle("127.0.0.1", server.port()), 1u);
+    pool->close();
+}
+
+BOOST_AUTO_TEST_CASE(pipeline_abort)
+{
+    upstream server;
+    client clnt;
+    beast_router::pool_limits limits;
+    limits.max_per_host = 1;
+    limits.max_pipeline = 4;
+    auto pool = pool_type::create(clnt.ioc(), limits);
+
+    // the request behind the one closing the connection is never answered
+    std::atomic<int> completed { 0 };
+    pool->send("127.0.0.1", server.port(), beast_router::make_empty_request(http::verb::get, 11, "/close"),
+        [&](boost::system::error_code ec, const pool_type::response_type& rp) {
+            BOOST_CHECK(!ec);
+            BOOST_CHECK_EQUAL(rp.body(), "close");
+            ++completed;
+        });
+    pool->send("127.0.0.1", server.port(), beast_router::make_empty_request(http::verb::get, 11, "/"),
+        [&](boost::system::error_code ec, const pool_type::response_type&) {
+            BOOST_CHECK_EQUAL(ec, net::error::connection_aborted);
+            ++completed;
+        });
+
+    // the non idempotent request waits for the connection to be idle
+    pool->send("127.0.0.1", server.port(), beast_router::make_empty_request(http::verb::post, 11, "/"),
+        [&](boost::system::error_code ec, const pool_type::response_type&) {
+            BOOST_CHECK(!ec);
+            ++completed;
+        });
+
+    BOOST_CHECK(test::wait_until([&completed]() { return completed == 3; }));
+    BOOST_CHECK_EQUAL(server.accepted(), 2);
+    pool->close();
+}
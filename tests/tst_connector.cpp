@@ -0,0 +1,136 @@
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "beast_router.hpp"
+#include "test_utility.hpp"
+
+namespace net = boost::asio;
+
+using namespace std::chrono_literals;
+
+using connector_type = beast_router::http_connector_type;
+using beast_router::dns_cache;
+
+namespace {
+
+/// Listens without accepting; once the backlog is full the SYNs are dropped
+class blackhole {
+public:
+    explicit blackhole(net::io_context& ioc)
+        : m_acceptor { ioc }
+        , m_fillers {}
+    {
+        const net::ip::tcp::endpoint endpoint { net::ip::address_v4::loopback(), 0 };
+        m_acceptor.open(endpoint.protocol());
+        m_acceptor.bind(endpoint);
+        m_acceptor.listen(0);
+
+        for (int idx = 0; idx < 4; ++idx) {
+            m_fillers.push_back(std::make_unique<net::ip::tcp::socket>(ioc));
+            m_fillers.back()->async_connect(m_acceptor.local_endpoint(), [](boost::system::error_code) {});
+        }
+        ioc.run_for(50ms);
+        ioc.restart();
+    }
+
+    net::ip::tcp::endpoint endpoint() const { return m_acceptor.local_endpoint(); }
+
+private:
+    net::ip::tcp::acceptor m_acceptor;
+    std::vector<std::unique_ptr<net::ip::tcp::socket>> m_fillers;
+};
+
+/// Resolves the host to the given endpoints
+dns_cache::resolver_type static_resolver(std::vector<net::ip::tcp::endpoint> endpoints)
+{
+    return [endpoints](const std::string& host, const std::string& port, dns_cache::handler_type handler) {
+        handler({}, dns_cache::results_type::create(endpoints.begin(), endpoints.end(), host, port));
+    };
+}
+
+/// Connects through the strategy and runs the io context until completed
+std::pair<boost::system::error_code, unsigned short> connect(net::io_context& ioc,
+    std::vector<net::ip::tcp::endpoint> endpoints, const beast_router::connect_strategy& strategy)
+{
+    connector_type::set_dns_cache(dns_cache::create(static_resolver(std::move(endpoints))));
+    connector_type::set_connect_strategy(strategy);
+
+    bool done = false;
+    boost::system::error_code result;
+    unsigned short port = 0;
+    connector_type::async_connect(ioc, "backend", "0",
+        [&](boost::system::error_code ec, connector_type::socket_type socket) {
+            result = ec;
+            if (!ec) {
+                port = socket.remote_endpoint().port();
+            }
+            done = true;
+        });
+    ioc.restart();
+    while (!done && ioc.run_one_for(test::default_timeout)) {
+    }
+
+    connector_type::set_dns_cache(nullptr);
+    connector_type::set_connect_strategy({});
+    BOOST_CHECK(done);
+    return { result, port };
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(racing_attempts)
+{
+    net::io_context ioc;
+    blackhole dead { ioc };
+    net::ip::tcp::acceptor live { ioc, { net::ip::address_v4::loopback(), 0 } };
+
+    // the live endpoint wins the race started after the delay
+    const auto started = std::chrono::steady_clock::now();
+    const auto [ec, port] = connect(ioc, { dead.endpoint(), live.local_endpoint() },
+        beast_router::connect_strategy { 50ms, 0s });
+    BOOST_CHECK(!ec);
+    BOOST_CHECK_EQUAL(port, live.local_endpoint().port());
+    BOOST_CHECK(std::chrono::steady_clock::now() - started < test::default_timeout / 2);
+}
+
+BOOST_AUTO_TEST_CASE(attempt_timeout)
+{
+    net::io_context ioc;
+    blackhole dead { ioc };
+    net::ip::tcp::acceptor live { ioc, { net::ip::address_v4::loopback(), 0 } };
+
+    // the attempts made one after another are limited
+    const auto [ec, port] = connect(ioc, { dead.endpoint(), live.local_endpoint() },
+        beast_router::connect_strategy { 0s, 50ms });
+    BOOST_CHECK(!ec);
+    BOOST_CHECK_EQUAL(port, live.local_endpoint().port());
+
+    BOOST_CHECK_EQUAL(connect(ioc, { dead.endpoint() }, beast_router::connect_strategy { 0s, 50ms }).first,
+        net::error::timed_out);
+}
+
+BOOST_AUTO_TEST_CASE(refused_attempts)
+{
+    std::vector<net::ip::tcp::endpoint> closed;
+    {
+        net::io_context ioc;
+        for (int idx = 0; idx < 2; ++idx) {
+            net::ip::tcp::acceptor acceptor { ioc, { net::ip::address_v4::loopback(), 0 } };
+            closed.push_back(acceptor.local_endpoint());
+        }
+    }
+
+    // the failed attempt starts the next one right away
+    net::io_context ioc;
+    net::ip::tcp::acceptor live { ioc, { net::ip::address_v4::loopback(), 0 } };
+    const auto [ec, port] = connect(ioc, { closed[0], closed[1], live.local_endpoint() },
+        beast_router::connect_strategy { 10s, 0s });
+    BOOST_CHECK(!ec);
+    BOOST_CHECK_EQUAL(port, live.local_endpoint().port());
+
+    BOOST_CHECK_EQUAL(connect(ioc, closed, beast_router::connect_strategy { 10s, 0s }).first,
+        net::error::connection_refused);
+}
@@ -0,0 +1,114 @@
+// std::exchange is used by the awaitable header of the older boost versions
+#include <utility>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+
+#include "beast_router.hpp"
+#include "test_utility.hpp"
+
+namespace net = boost::asio;
+
+using server_type = beast_router::http_server_type;
+using router_type = server_type::router_type;
+using message_type = server_type::message_type;
+using context_type = server_type::context_type;
+
+BOOST_AUTO_TEST_CASE(awaitable_route)
+{
+    std::size_t bytes_sent = 0;
+    bool on_strand = false;
+    bool after_called = false;
+
+    router_type router;
+    router.get(
+        R"(^/co/(\d+)$)",
+        [](const message_type&, context_type&, const std::smatch& match) {
+            return match[1].str() != "0";
+        },
+        [&](const message_type& rq, context_type& ctx, const std::smatch& match) -> net::awaitable<bool> {
+            bytes_sent = co_await ctx.send(beast_router::make_string_response(
+                                               beast_router::http::status::ok, rq.version(), match[1].str()),
+                net::use_awaitable);
+            on_strand = ctx.get_executor().running_in_this_thread();
+            co_return true;
+        },
+        [&](context_type& ctx) {
+            after_called = true;
+            ctx.recv();
+        });
+
+    const auto rp = test::fetch(router, "/co/42");
+
+    BOOST_CHECK_EQUAL(rp.body(), "42");
+    BOOST_CHECK(bytes_sent > 0);
+    BOOST_CHECK(on_strand);
+    BOOST_CHECK(after_called);
+}
+
+BOOST_AUTO_TEST_CASE(awaitable_connector)
+{
+    net::io_context ioc;
+    net::ip::tcp::acceptor acceptor { ioc, { net::ip::address_v4::loopback(), 0 } };
+
+    bool accepted = false;
+    acceptor.async_accept([&](boost::system::error_code ec, net::ip::tcp::socket) {
+        accepted = !ec;
+    });
+
+    bool is_open = false;
+
+    net::co_spawn(
+        ioc,
+        [&]() -> net::awaitable<void> {
+            auto socket = co_await beast_router::http_connector_type::async_connect(ioc,
+                "127.0.0.1", std::to_string(acceptor.local_endpoint().port()),
+                net::use_awaitable);
+            is_open = socket.is_open();
+        },
+        net::detached);
+
+    ioc.run();
+
+    BOOST_CHECK(accepted);
+    BOOST_CHECK(is_open);
+}
+
+BOOST_AUTO_TEST_CASE(awaitable_pool)
+{
+    router_type router;
+    router.get(R"(^/co/(\d+)$)", [](const message_type& rq, context_type& ctx, const std::smatch& match) {
+        ctx.send(beast_router::make_string_response(beast_router::http::status::ok, rq.version(),
+            match[1].str()));
+        ctx.recv();
+    });
+    test::loopback_server server { router };
+    const auto port = std::to_string(server.local_endpoint().port());
+
+    net::io_context ioc;
+    auto pool = beast_router::http_connection_pool_type::create(ioc);
+    std::vector<std::string> bodies;
+
+    net::co_spawn(
+        ioc,
+        [&]() -> net::awaitable<void> {
+            for (const auto* target : { "/co/1", "/co/2" }) {
+                auto rp = co_await pool->async_send("127.0.0.1", port,
+                    beast_router::make_empty_request(beast_router::http::verb::get, 11, target),
+                    net::use_awaitable);
+                bodies.push_back(rp.body());
+            }
+            pool->close();
+        },
+        net::detached);
+
+    ioc.run_for(test::default_timeout);
+
+    BOOST_REQUIRE_EQUAL(bodies.size(), 2u);
+    BOOST_CHECK_EQUAL(bodies[0], "1");
+    BOOST_CHECK_EQUAL(bodies[1], "2");
+}
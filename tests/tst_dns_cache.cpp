@@ -0,0 +1,201 @@
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "beast_router.hpp"
+#include "test_utility.hpp"
+
+namespace net = boost::asio;
+
+using namespace std::chrono_literals;
+
+using beast_router::dns_cache;
+
+namespace {
+
+/// Resolves `*.test` to the loopback address, the rest fails
+class local_resolver {
+public:
+    explicit local_resolver(net::io_context& ioc)
+        : m_ioc { ioc }
+        , m_calls { 0 }
+        , m_failing { false }
+    {
+    }
+
+    dns_cache::resolver_type get()
+    {
+        return [this](const std::string& host, const std::string& port, dns_cache::handler_type handler) {
+            ++m_calls;
+            net::post(m_ioc, [this, host, port, handler = std::move(handler)]() {
+                if (m_failing || host.size() < 5 || host.compare(host.size() - 5, 5, ".test") != 0) {
+                    handler(net::error::host_not_found, {});
+                    return;
+                }
+                const net::ip::tcp::endpoint endpoint { net::ip::address_v4::loopback(),
+                    static_cast<unsigned short>(std::stoi(port)) };
+                handler({}, dns_cache::results_type::create(endpoint, host, port));
+            });
+        };
+    }
+
+    int calls() const { return m_calls; }
+
+    void failing(bool value) { m_failing = value; }
+
+private:
+    net::io_context& m_ioc;
+    std::atomic<int> m_calls;
+    std::atomic<bool> m_failing;
+};
+
+/// Looks up the host and runs the io context until completed
+boost::system::error_code lookup(net::io_context& ioc, dns_cache& cache, const std::string& host,
+    dns_cache::results_type* results = nullptr)
+{
+    bool done = false;
+    boost::system::error_code result;
+    cache.resolve(host, "8080", ioc.get_executor(),
+        [&](boost::system::error_code ec, dns_cache::results_type res) {
+            result = ec;
+            if (results) {
+                *results = std::move(res);
+            }
+            done = true;
+        });
+    ioc.restart();
+    while (!done && ioc.run_one_for(test::default_timeout)) {
+    }
+    BOOST_CHECK(done);
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(cached_results)
+{
+    net::io_context ioc;
+    local_resolver resolver { ioc };
+    auto cache = dns_cache::create(resolver.get(), beast_router::dns_cache_settings { 10s, 10s, 0s });
+
+    dns_cache::results_type results;
+    BOOST_CHECK(!lookup(ioc, *cache, "backend.test", &results));
+    BOOST_REQUIRE_EQUAL(results.size(), 1u);
+    BOOST_CHECK_EQUAL(results.begin()->endpoint().port(), 8080);
+
+    for (int idx = 0; idx < 4; ++idx) {
+        BOOST_CHECK(!lookup(ioc, *cache, "backend.test"));
+    }
+    BOOST_CHECK_EQUAL(resolver.calls(), 1);
+    BOOST_CHECK_EQUAL(cache->stats().hits, 4u);
+    BOOST_CHECK_EQUAL(cache->stats().misses, 1u);
+
+    cache->clear();
+    BOOST_CHECK(!lookup(ioc, *cache, "backend.test"));
+    BOOST_CHECK_EQUAL(resolver.calls(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(shared_resolution)
+{
+    net::io_context ioc;
+    local_resolver resolver { ioc };
+    auto cache = dns_cache::create(resolver.get());
+
+    // the lookups made before the resolution completes share it
+    int completed = 0;
+    for (int idx = 0; idx < 8; ++idx) {
+        cache->resolve("backend.test", "8080", ioc.get_executor(),
+            [&completed](boost::system::error_code ec, dns_cache::results_type) {
+                BOOST_CHECK(!ec);
+                ++completed;
+            });
+    }
+    ioc.run_for(test::default_timeout / 10);
+    BOOST_CHECK_EQUAL(completed, 8);
+    BOOST_CHECK_EQUAL(resolver.calls(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(expiration)
+{
+    net::io_context ioc;
+    local_resolver resolver { ioc };
+    auto cache = dns_cache::create(resolver.get(), beast_router::dns_cache_settings { 30ms, 30ms, 0s });
+
+    // the failures are cached for the negative ttl
+    BOOST_CHECK_EQUAL(lookup(ioc, *cache, "unknown"), net::error::host_not_found);
+    BOOST_CHECK_EQUAL(lookup(ioc, *cache, "unknown"), net::error::host_not_found);
+    BOOST_CHECK_EQUAL(resolver.calls(), 1);
+    BOOST_CHECK_EQUAL(cache->stats().negative_hits, 1u);
+
+    BOOST_CHECK(!lookup(ioc, *cache, "backend.test"));
+    std::this_thread::sleep_for(50ms);
+    BOOST_CHECK_EQUAL(lookup(ioc, *cache, "unknown"), net::error::host_not_found);
+    BOOST_CHECK(!lookup(ioc, *cache, "backend.test"));
+    BOOST_CHECK_EQUAL(resolver.calls(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(refresh_ahead)
+{
+    net::io_context ioc;
+    local_resolver resolver { ioc };
+    auto cache = dns_cache::create(resolver.get(), beast_router::dns_cache_settings { 100ms, 0s, 80ms });
+
+    BOOST_CHECK(!lookup(ioc, *cache, "backend.test"));
+    std::this_thread::sleep_for(40ms);
+
+    // the entry about to expire is returned and refreshed in the background
+    BOOST_CHECK(!lookup(ioc, *cache, "backend.test"));
+    ioc.restart();
+    ioc.poll();
+    BOOST_CHECK_EQUAL(resolver.calls(), 2);
+    BOOST_CHECK_EQUAL(cache->stats().refreshes, 1u);
+
+    // the failed refresh keeps the endpoints until they expire
+    resolver.failing(true);
+    std::this_thread::sleep_for(40ms);
+    BOOST_CHECK(!lookup(ioc, *cache, "backend.test"));
+    ioc.restart();
+    ioc.poll();
+    BOOST_CHECK_EQUAL(resolver.calls(), 3);
+    BOOST_CHECK(!lookup(ioc, *cache, "backend.test"));
+    BOOST_CHECK_EQUAL(cache->stats().misses, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(cached_connector)
+{
+    net::io_context ioc;
+    net::ip::tcp::acceptor acceptor { ioc, { net::ip::address_v4::loopback(), 0 } };
+    const auto port = std::to_string(acceptor.local_endpoint().port());
+
+    local_resolver resolver { ioc };
+    beast_router::http_connector_type::set_dns_cache(dns_cache::create(resolver.get()));
+
+    int connected = 0;
+    for (int idx = 0; idx < 3; ++idx) {
+        beast_router::http_connector_type::async_connect(ioc, "backend.test", port,
+            [&connected](boost::system::error_code ec, beast_router::http_connector_type::socket_type) {
+                BOOST_CHECK(!ec);
+                ++connected;
+            });
+    }
+
+    int failed = 0;
+    beast_router::http_connector_type::on_connect_type on_connect = [](beast_router::http_connector_type::socket_type) {
+        BOOST_FAIL("unknown host connected");
+    };
+    beast_router::http_connector_type::on_error_type on_error = [&failed](boost::system::error_code ec, std::string_view) {
+        BOOST_CHECK_EQUAL(ec, net::error::host_not_found);
+        ++failed;
+    };
+    beast_router::http_connector_type::connect(ioc, "unknown", port, std::move(on_connect), std::move(on_error));
+
+    ioc.run_for(test::default_timeout / 10);
+    beast_router::http_connector_type::set_dns_cache(nullptr);
+
+    BOOST_CHECK_EQUAL(connected, 3);
+    BOOST_CHECK_EQUAL(failed, 1);
+    BOOST_CHECK_EQUAL(resolver.calls(), 2);
+}
@@ -0,0 +1,86 @@
+#include <boost/test/unit_test.hpp>
+#include <string>
+
+#include "beast_router.hpp"
+
+namespace net = boost::asio;
+
+namespace {
+
+std::string to_string(const beast_router::prepared_response::buffers_type& buffers)
+{
+    std::string ret;
+    for (const auto& buffer : buffers) {
+        ret.append(static_cast<const char*>(buffer.data()), buffer.size());
+    }
+    return ret;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(http_date_format)
+{
+    beast_router::http_date::buffer_type out;
+
+    beast_router::http_date::format(0, out);
+    BOOST_CHECK_EQUAL(std::string(out.data(), out.size()), "Thu, 01 Jan 1970 00:00:00 GMT");
+
+    beast_router::http_date::format(784111777, out);
+    BOOST_CHECK_EQUAL(std::string(out.data(), out.size()), "Sun, 06 Nov 1994 08:49:37 GMT");
+
+    beast_router::http_date::format(951782400, out);
+    BOOST_CHECK_EQUAL(std::string(out.data(), out.size()), "Tue, 29 Feb 2000 00:00:00 GMT");
+
+    beast_router::http_date::format(4102444799, out);
+    BOOST_CHECK_EQUAL(std::string(out.data(), out.size()), "Thu, 31 Dec 2099 23:59:59 GMT");
+}
+
+BOOST_AUTO_TEST_CASE(prepared_response_bytes)
+{
+    auto rp = beast_router::make_string_response(beast_router::http::status::not_found,
+        11, "Not Found", "text/plain");
+    rp.set(beast_router::http::field::date, "stale");
+    rp.keep_alive(false);
+
+    const beast_router::prepared_response prepared { std::move(rp) };
+    BOOST_CHECK(prepared.need_eof());
+    BOOST_CHECK(prepared.result() == beast_router::http::status::not_found);
+    BOOST_CHECK_EQUAL(prepared.bytes().find("Date"), std::string_view::npos);
+    BOOST_CHECK_EQUAL(prepared.bytes().find("Connection"), std::string_view::npos);
+
+    auto keep_alive = prepared.keep_alive(true);
+    BOOST_CHECK(!keep_alive.need_eof());
+    BOOST_CHECK_EQUAL(keep_alive.bytes().data(), prepared.bytes().data());
+
+    const auto bytes = to_string(keep_alive.buffers());
+
+    beast_router::http::response_parser<beast_router::http::string_body> parser;
+    boost::system::error_code ec;
+    auto buffer = net::buffer(bytes);
+    while (!ec && !parser.is_done() && buffer.size()) {
+        buffer += parser.put(buffer, ec);
+    }
+    BOOST_REQUIRE(!ec);
+    BOOST_REQUIRE(parser.is_done());
+
+    const auto& msg = parser.get();
+    BOOST_CHECK(msg.keep_alive());
+    BOOST_CHECK_EQUAL(msg.body(), "Not Found");
+    BOOST_CHECK_EQUAL(msg[beast_router::http::field::content_type], "text/plain");
+    BOOST_CHECK_EQUAL(msg[beast_router::http::field::date].size(), beast_router::http_date::length);
+}
+
+BOOST_AUTO_TEST_CASE(http_date_cache)
+{
+    using clock_type = beast_router::http_date::clock_type;
+
+    beast_router::http_date::update(clock_type::time_point { std::chrono::seconds { 784111777 } });
+    BOOST_CHECK_EQUAL(beast_router::http_date::now(), "Sun, 06 Nov 1994 08:49:37 GMT");
+
+    const auto rp = beast_router::make_empty_response(beast_router::http::status::ok, 11);
+    BOOST_CHECK_EQUAL(rp[beast_router::http::field::date], "Sun, 06 Nov 1994 08:49:37 GMT");
+
+    beast_router::http_date::reset();
+    BOOST_CHECK_NE(beast_router::http_date::now(), "Sun, 06 Nov 1994 08:49:37 GMT");
+    BOOST_CHECK_EQUAL(beast_router::http_date::now().size(), beast_router::http_date::length);
+}
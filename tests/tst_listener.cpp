@@ -0,0 +1,212 @@
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "beast_router.hpp"
+#include "test_utility.hpp"
+
+namespace net = boost::asio;
+
+using listener_type = beast_router::http_listener_type;
+
+BOOST_AUTO_TEST_CASE(reuse_port_listener)
+{
+    auto event_loop = beast_router::event_loop::create(2u);
+
+    std::atomic<int> accepted { 0 };
+    listener_type::on_accept_type on_accept = [&accepted](listener_type::socket_type) {
+        ++accepted;
+    };
+    listener_type::on_error_type on_error = [](boost::system::error_code ec, std::string_view msg) {
+        BOOST_FAIL(std::string { msg } + ": " + ec.message());
+    };
+
+    auto lstnr = listener_type::launch(*event_loop, { net::ip::address_v4::loopback(), 0 },
+        beast_router::reuse_port, std::move(on_accept), std::move(on_error));
+    BOOST_REQUIRE_EQUAL(lstnr->acceptors(), 2u);
+    BOOST_REQUIRE_NE(lstnr->local_endpoint().port(), 0);
+
+    std::thread io_thread { [&event_loop]() { event_loop->exec(); } };
+
+    net::io_context client_ioc;
+    for (int i = 0; i < 8; ++i) {
+        net::ip::tcp::socket socket { client_ioc };
+        socket.connect(lstnr->local_endpoint());
+    }
+
+    BOOST_CHECK(test::wait_until([&accepted]() { return accepted >= 8; }));
+
+    lstnr->close();
+    event_loop->stop();
+    io_thread.join();
+
+    BOOST_CHECK_EQUAL(accepted, 8);
+}
+
+BOOST_AUTO_TEST_CASE(reuse_port_io_context)
+{
+    net::io_context ioc;
+
+    listener_type::on_accept_type on_accept = [](listener_type::socket_type) {};
+    auto lstnr = listener_type::launch(ioc, { net::ip::address_v4::loopback(), 0 },
+        beast_router::reuse_port, std::move(on_accept));
+    BOOST_CHECK_EQUAL(lstnr->acceptors(), 1u);
+
+    lstnr->close();
+    ioc.run();
+}
+
+BOOST_AUTO_TEST_CASE(per_core_round_robin)
+{
+    auto event_loop = beast_router::event_loop::create(2u,
+        beast_router::event_loop::settings { beast_router::event_loop::topology::per_core });
+    BOOST_REQUIRE_EQUAL(event_loop->get_contexts(), 2u);
+
+    std::mutex mutex;
+    std::map<net::execution_context*, int> contexts;
+    listener_type::on_accept_type on_accept = [&](listener_type::socket_type socket) {
+        std::lock_guard<std::mutex> lock { mutex };
+        ++contexts[&socket.get_executor().context()];
+    };
+
+    auto lstnr = listener_type::launch(*event_loop, { net::ip::address_v4::loopback(), 0 },
+        std::move(on_accept));
+
+    std::thread io_thread { [&event_loop]() { event_loop->exec(); } };
+
+    net::io_context client_ioc;
+    for (int i = 0; i < 4; ++i) {
+        net::ip::tcp::socket socket { client_ioc };
+        socket.connect(lstnr->local_endpoint());
+    }
+
+    const auto accepted = [&]() {
+        std::lock_guard<std::mutex> lock { mutex };
+        auto ret = 0;
+        for (const auto& [ctx, count] : contexts) {
+            ret += count;
+        }
+        return ret;
+    };
+    BOOST_CHECK(test::wait_until([&accepted]() { return accepted() >= 4; }));
+
+    lstnr->close();
+    event_loop->stop();
+    io_thread.join();
+
+    BOOST_CHECK_EQUAL(contexts.size(), 2u);
+    BOOST_CHECK_EQUAL(contexts[&event_loop->get_context(0)], 2);
+    BOOST_CHECK_EQUAL(contexts[&event_loop->get_context(1)], 2);
+}
+
+BOOST_AUTO_TEST_CASE(pinned_threads)
+{
+    std::atomic<int> errors { 0 };
+    beast_router::event_loop::settings config {};
+    config.layout = beast_router::event_loop::topology::per_core;
+    config.pin_threads = true;
+    config.on_error = [&errors](boost::system::error_code, std::string_view) { ++errors; };
+
+    // more threads than CPUs wrap around the affinity mask
+    auto event_loop = beast_router::event_loop::create(
+        std::thread::hardware_concurrency() + 1, std::move(config));
+
+    std::thread io_thread { [&event_loop]() { event_loop->exec(); } };
+    event_loop->stop();
+    io_thread.join();
+    // joins the rest of the threads
+    event_loop.reset();
+
+    BOOST_CHECK_EQUAL(errors, 0);
+}
+
+BOOST_AUTO_TEST_CASE(connection_limits_pause)
+{
+    net::io_context ioc;
+
+    std::mutex mutex;
+    std::vector<listener_type::slot_type> slots;
+    listener_type::on_admit_type on_admit = [&](listener_type::socket_type, listener_type::slot_type slot) {
+        std::lock_guard<std::mutex> lock { mutex };
+        slots.push_back(std::move(slot));
+    };
+    const auto admitted = [&]() {
+        std::lock_guard<std::mutex> lock { mutex };
+        return slots.size();
+    };
+
+    beast_router::connection_limits limits;
+    limits.max_connections = 1;
+    auto lstnr = listener_type::launch(ioc, { net::ip::address_v4::loopback(), 0 },
+        std::move(on_admit), listener_type::on_error_type {}, limits);
+
+    auto work = net::make_work_guard(ioc);
+    std::thread io_thread { [&ioc]() { ioc.run(); } };
+
+    net::io_context client_ioc;
+    net::ip::tcp::socket first { client_ioc }, second { client_ioc };
+    first.connect(lstnr->local_endpoint());
+    second.connect(lstnr->local_endpoint());
+
+    BOOST_CHECK(test::wait_until([&]() { return admitted() == 1; }));
+    // the second one waits in the backlog
+    std::this_thread::sleep_for(std::chrono::milliseconds { 100 });
+    BOOST_CHECK_EQUAL(admitted(), 1u);
+    BOOST_CHECK_EQUAL(lstnr->connections(), 1u);
+
+    // releasing the slot resumes the accepting
+    {
+        std::lock_guard<std::mutex> lock { mutex };
+        slots.front().release();
+    }
+    BOOST_CHECK(test::wait_until([&]() { return admitted() == 2; }));
+    BOOST_CHECK_EQUAL(lstnr->shed(), 0u);
+
+    lstnr->close();
+    work.reset();
+    io_thread.join();
+}
+
+BOOST_AUTO_TEST_CASE(connection_limits_reject)
+{
+    net::io_context ioc;
+
+    std::vector<listener_type::slot_type> slots;
+    listener_type::on_admit_type on_admit = [&](listener_type::socket_type, listener_type::slot_type slot) {
+        slots.push_back(std::move(slot));
+    };
+
+    beast_router::connection_limits limits;
+    limits.max_per_address = 1;
+    limits.policy = beast_router::overload_policy::reject;
+    auto lstnr = listener_type::launch(ioc, { net::ip::address_v4::loopback(), 0 },
+        std::move(on_admit), listener_type::on_error_type {}, limits);
+
+    net::ip::tcp::socket first { ioc }, second { ioc };
+    first.connect(lstnr->local_endpoint());
+    second.connect(lstnr->local_endpoint());
+
+    // the second connection of the address is responded with 503
+    boost::beast::flat_buffer buffer;
+    beast_router::http_string_response rp;
+    bool done = false;
+    beast_router::http::async_read(second, buffer, rp, [&](boost::system::error_code ec, std::size_t) {
+        BOOST_CHECK(!ec);
+        done = true;
+        ioc.stop();
+    });
+    ioc.run_for(test::default_timeout);
+
+    BOOST_REQUIRE(done);
+    BOOST_CHECK_EQUAL(rp.result(), beast_router::http::status::service_unavailable);
+    BOOST_CHECK_EQUAL(slots.size(), 1u);
+    BOOST_CHECK_EQUAL(lstnr->connections(), 1u);
+    BOOST_CHECK_EQUAL(lstnr->connections(net::ip::address_v4::loopback()), 1u);
+    BOOST_CHECK_EQUAL(lstnr->shed(), 1u);
+
+    lstnr->close();
+}
@@ -0,0 +1,114 @@
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "beast_router.hpp"
+#include "test_utility.hpp"
+
+using namespace std::chrono_literals;
+
+using beast_router::latency_histogram;
+using beast_router::metrics_registry;
+
+BOOST_AUTO_TEST_CASE(histogram_buckets)
+{
+    // the small values are exact
+    for (std::uint64_t value = 0; value < 8; ++value) {
+        BOOST_CHECK_EQUAL(latency_histogram::index(value), value);
+        BOOST_CHECK_EQUAL(latency_histogram::upper_bound(value), value + 1);
+    }
+
+    // every value falls below the bound of its bucket
+    for (std::uint64_t value = 8; value < 100000; value += 7) {
+        const auto idx = latency_histogram::index(value);
+        BOOST_CHECK_LT(value, latency_histogram::upper_bound(idx));
+        BOOST_CHECK_GE(value, latency_histogram::upper_bound(idx - 1));
+    }
+
+    BOOST_CHECK_EQUAL(latency_histogram::index(latency_histogram::max_value), latency_histogram::buckets - 1);
+    BOOST_CHECK_EQUAL(latency_histogram::index(~std::uint64_t { 0 }), latency_histogram::buckets - 1);
+
+    latency_histogram histogram;
+    for (std::uint64_t value = 1; value <= 100; ++value) {
+        histogram.record(value * 1000);
+    }
+    BOOST_CHECK_EQUAL(histogram.count, 100u);
+    BOOST_CHECK_EQUAL(histogram.sum, 5050000u);
+
+    // the relative error stays within a quarter
+    const auto median = histogram.value_at(0.5);
+    BOOST_CHECK_GE(median, 50000u);
+    BOOST_CHECK_LE(median, 62500u);
+    BOOST_CHECK_GE(histogram.value_at(1.0), 100000u);
+}
+
+BOOST_AUTO_TEST_CASE(sharded_counters)
+{
+    metrics_registry registry { 4 };
+    auto route = registry.route("GET", "^/$");
+    BOOST_CHECK_EQUAL(route, registry.route("GET", "^/$"));
+
+    std::vector<std::thread> threads;
+    for (int idx = 0; idx < 8; ++idx) {
+        threads.emplace_back([route]() {
+            for (int count = 0; count < 1000; ++count) {
+                route->request();
+                route->received(10, 5us);
+                route->sent(200, 20, 5us);
+                route->sent(0, 1, 0us);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto snapshot = route->snapshot();
+    BOOST_CHECK_EQUAL(snapshot.requests, 8000u);
+    BOOST_CHECK_EQUAL(snapshot.responses[1], 8000u);
+    BOOST_CHECK_EQUAL(snapshot.bytes_in, 80000u);
+    BOOST_CHECK_EQUAL(snapshot.bytes_out, 168000u);
+    BOOST_CHECK_EQUAL(snapshot.parse.count, 8000u);
+    BOOST_CHECK_EQUAL(snapshot.write.count, 8000u);
+}
+
+BOOST_AUTO_TEST_CASE(prometheus_route)
+{
+    using server_type = beast_router::http_server_type;
+
+    auto registry = std::make_shared<metrics_registry>();
+    server_type::router_type router;
+    router.get(R"(^/hello$)", [](const auto& rq, auto& ctx) {
+        ctx.send(beast_router::make_string_response(beast_router::http::status::ok, rq.version(), "hello"));
+    });
+    router.metrics(registry);
+
+    BOOST_CHECK_EQUAL(test::fetch(router, "/hello").body(), "hello");
+    BOOST_CHECK_EQUAL(test::fetch(router, "/nowhere").result(), beast_router::http::status::not_found);
+
+    // the counters of the write are recorded after the response is sent
+    const auto hello = registry->route("GET", R"(^/hello$)");
+    BOOST_REQUIRE(test::wait_until([&hello]() { return hello->snapshot().responses[1] == 1; }));
+
+    const auto snapshot = hello->snapshot();
+    BOOST_CHECK_EQUAL(snapshot.requests, 1u);
+    BOOST_CHECK_GT(snapshot.bytes_in, 0u);
+    BOOST_CHECK_GT(snapshot.bytes_out, 0u);
+    BOOST_CHECK_EQUAL(snapshot.parse.count, 1u);
+    BOOST_CHECK_EQUAL(snapshot.handler.count, 1u);
+    BOOST_CHECK_EQUAL(snapshot.write.count, 1u);
+
+    const auto rp = test::fetch(router, "/metrics");
+    BOOST_CHECK_EQUAL(rp.result(), beast_router::http::status::ok);
+    BOOST_CHECK_EQUAL(rp[beast_router::http::field::content_type], metrics_registry::content_type);
+
+    const auto& body = rp.body();
+    BOOST_CHECK(body.find("# TYPE beast_router_requests_total counter") != std::string::npos);
+    BOOST_CHECK(body.find(R"(beast_router_requests_total{method="GET",route="^/hello$"} 1)") != std::string::npos);
+    BOOST_CHECK(body.find(R"(beast_router_responses_total{method="",route="",code="4xx"} 1)") != std::string::npos);
+    BOOST_CHECK(body.find(R"(beast_router_handler_seconds_bucket{method="GET",route="^/hello$",le="+Inf"} 1)") != std::string::npos);
+    BOOST_CHECK(body.find(R"(beast_router_parse_seconds_count{method="GET",route="^/hello$"} 1)") != std::string::npos);
+}
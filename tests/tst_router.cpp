@@ -44,6 +44,11 @@ struct tst_session {
         {
         }
 
+        self_type& recv()
+        {
+            return *this;
+        }
+
         template <class Message>
         self_type& send([[maybe_unused]] Message&& message)
         {
@@ -0,0 +1,148 @@
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "beast_router.hpp"
+#include "test_ssl_utility.hpp"
+
+namespace net = boost::asio;
+namespace http = beast_router::http;
+
+using server_type = test::tls_server_type;
+using beast_router::ssl::handshake_pool;
+
+namespace {
+
+/// Records the threads the handshakes and the requests are handled by
+class threads_log {
+public:
+    void handshake() { add(m_handshakes); }
+
+    void request() { add(m_requests); }
+
+    bool disjoint() const
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        for (const auto& id : m_handshakes) {
+            if (m_requests.count(id)) {
+                return false;
+            }
+        }
+        return !m_handshakes.empty() && !m_requests.empty();
+    }
+
+private:
+    void add(std::set<std::thread::id>& ids)
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        ids.insert(std::this_thread::get_id());
+    }
+
+    mutable std::mutex m_mutex;
+    std::set<std::thread::id> m_handshakes;
+    std::set<std::thread::id> m_requests;
+};
+
+threads_log g_log;
+
+/// Serves the tls connections making the handshakes by the pool
+class pooled_upstream {
+public:
+    explicit pooled_upstream(const beast_router::ssl::handshake_settings& settings)
+        : m_pool { handshake_pool::create(settings) }
+        , m_router {}
+        , m_server {}
+    {
+        m_router.get(R"(^/$)", [](server_type::context_type& ctx) {
+            g_log.request();
+            ctx.send(beast_router::make_string_response(http::status::ok, 11, "ok"));
+            ctx.recv();
+        });
+        m_server.emplace(m_router, [this](net::ssl::context& ssl_ctx) {
+            m_pool->attach(ssl_ctx);
+            SSL_CTX_set_info_callback(ssl_ctx.native_handle(), [](const SSL*, int where, int) {
+                if (where & SSL_CB_HANDSHAKE_START) {
+                    g_log.handshake();
+                }
+            });
+        });
+    }
+
+    net::ip::tcp::endpoint endpoint() const { return m_server->endpoint(); }
+
+    handshake_pool& pool() { return *m_pool; }
+
+private:
+    handshake_pool::pool_ptr_type m_pool;
+    server_type::router_type m_router;
+    std::optional<test::tls_server> m_server;
+};
+
+/// Makes the client context
+net::ssl::context make_client()
+{
+    net::ssl::context ssl_ctx { net::ssl::context::tls_client };
+    ssl_ctx.set_verify_mode(net::ssl::verify_none);
+    return ssl_ctx;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(offloaded_handshakes)
+{
+    pooled_upstream server { beast_router::ssl::handshake_settings { 2, 64 } };
+    auto ssl_ctx = make_client();
+
+    for (int idx = 0; idx < 3; ++idx) {
+        BOOST_CHECK(test::tls_fetch(ssl_ctx, server.endpoint(), { "/", "/" })
+            == (std::vector<std::string> { "ok", "ok" }));
+    }
+    BOOST_CHECK_EQUAL(server.pool().stats().handshakes, 3u);
+    BOOST_CHECK_EQUAL(server.pool().stats().active, 0u);
+
+    // the requests are not handled by the threads of the handshakes
+    BOOST_CHECK(g_log.disjoint());
+}
+
+BOOST_AUTO_TEST_CASE(concurrency_limit)
+{
+    pooled_upstream server { beast_router::ssl::handshake_settings { 2, 1 } };
+    auto ssl_ctx = make_client();
+
+    // the storm is served one handshake at a time
+    std::vector<std::thread> clients;
+    std::atomic<int> served { 0 };
+    for (int idx = 0; idx < 8; ++idx) {
+        clients.emplace_back([&]() {
+            if (test::tls_fetch(ssl_ctx, server.endpoint(), { "/" }) == std::vector<std::string> { "ok" }) {
+                ++served;
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+
+    const auto stats = server.pool().stats();
+    BOOST_CHECK_EQUAL(served.load(), 8);
+    BOOST_CHECK_EQUAL(stats.handshakes, 8u);
+    BOOST_CHECK_EQUAL(stats.max_active, 1u);
+    BOOST_CHECK_EQUAL(stats.waiting, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(client_handshakes)
+{
+    pooled_upstream server { beast_router::ssl::handshake_settings {} };
+    auto pool = handshake_pool::create();
+    auto ssl_ctx = make_client();
+    pool->attach(ssl_ctx);
+
+    BOOST_CHECK(test::tls_fetch(ssl_ctx, server.endpoint(), { "/" }) == std::vector<std::string> { "ok" });
+    BOOST_CHECK_EQUAL(pool->stats().handshakes, 1u);
+    BOOST_CHECK(handshake_pool::get(ssl_ctx.native_handle()) == pool);
+}
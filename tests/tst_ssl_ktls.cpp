@@ -0,0 +1,130 @@
+#include <boost/test/unit_test.hpp>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "beast_router.hpp"
+#include "test_ssl_utility.hpp"
+
+namespace net = boost::asio;
+namespace http = beast_router::http;
+
+using server_type = test::tls_server_type;
+using beast_router::ssl::ktls;
+
+namespace {
+
+/// Serves the small and the file responses
+class file_upstream {
+public:
+    explicit file_upstream(const std::string& content)
+        : m_file_name { (std::filesystem::temp_directory_path() / "tst_ssl_ktls.bin").string() }
+        , m_router {}
+        , m_server {}
+    {
+        std::ofstream { m_file_name, std::ios::binary } << content;
+
+        m_router.get(R"(^/$)", [](server_type::context_type& ctx) {
+            ctx.send(beast_router::make_string_response(http::status::ok, 11, "ok"));
+            ctx.recv();
+        });
+        m_router.get(R"(^/file$)", [this](server_type::context_type& ctx) {
+            ctx.send(beast_router::make_file_response(11, m_file_name));
+            ctx.recv();
+        });
+        m_server.emplace(m_router, [](net::ssl::context& ssl_ctx) { ktls::enable(ssl_ctx); });
+    }
+
+    file_upstream(const file_upstream&) = delete;
+
+    file_upstream& operator=(const file_upstream&) = delete;
+
+    ~file_upstream()
+    {
+        m_server.reset();
+        std::filesystem::remove(m_file_name);
+    }
+
+    net::ip::tcp::endpoint endpoint() const { return m_server->endpoint(); }
+
+private:
+    std::string m_file_name;
+    server_type::router_type m_router;
+    std::optional<test::tls_server> m_server;
+};
+
+/// Makes the client context offloading the writes
+net::ssl::context make_client(net::ssl::context::method method)
+{
+    net::ssl::context ssl_ctx { method };
+    ssl_ctx.set_verify_mode(net::ssl::verify_none);
+    ktls::enable(ssl_ctx);
+    return ssl_ctx;
+}
+
+/// Makes the content not repeating within the records
+std::string make_content(std::size_t size)
+{
+    std::string content(size, '\0');
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        content[idx] = static_cast<char>('a' + (idx * 7 + idx / 26) % 26);
+    }
+    return content;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(enabled_context)
+{
+    net::ssl::context ssl_ctx { net::ssl::context::tls_client };
+    BOOST_CHECK(!ktls::enabled(ssl_ctx.native_handle()));
+
+    ktls::enable(ssl_ctx);
+    BOOST_CHECK(ktls::enabled(ssl_ctx.native_handle()));
+
+    ktls::enable(ssl_ctx, false);
+    BOOST_CHECK(!ktls::enabled(ssl_ctx.native_handle()));
+}
+
+BOOST_AUTO_TEST_CASE(offloaded_writes)
+{
+    const auto content = make_content(3 * 1024 * 1024 + 17);
+    file_upstream server { content };
+
+    // either offloaded or served by OpenSSL, the responses are the same
+    auto ssl_ctx = make_client(net::ssl::context::tlsv12_client);
+    SSL_CTX_set_cipher_list(ssl_ctx.native_handle(), "ECDHE-RSA-AES128-GCM-SHA256:ECDHE-RSA-AES256-GCM-SHA384");
+
+    const auto before = ktls::stats();
+    const auto bodies = test::tls_fetch(ssl_ctx, server.endpoint(), { "/", "/file", "/", "/file" });
+    BOOST_REQUIRE_EQUAL(bodies.size(), 4u);
+    BOOST_CHECK_EQUAL(bodies[0], "ok");
+    BOOST_CHECK(bodies[1] == content);
+    BOOST_CHECK_EQUAL(bodies[2], "ok");
+    BOOST_CHECK(bodies[3] == content);
+
+    // both the client and the server tried
+    const auto after = ktls::stats();
+    BOOST_CHECK_EQUAL(after.offloaded + after.fallbacks, before.offloaded + before.fallbacks + 2);
+}
+
+BOOST_AUTO_TEST_CASE(fallback)
+{
+    const auto content = make_content(64 * 1024);
+    file_upstream server { content };
+
+    // the TLS 1.3 connections stay with OpenSSL
+    auto ssl_ctx = make_client(net::ssl::context::tlsv13_client);
+
+    const auto before = ktls::stats();
+    const auto bodies = test::tls_fetch(ssl_ctx, server.endpoint(), { "/file", "/" });
+    BOOST_REQUIRE_EQUAL(bodies.size(), 2u);
+    BOOST_CHECK(bodies[0] == content);
+    BOOST_CHECK_EQUAL(bodies[1], "ok");
+
+    const auto after = ktls::stats();
+    BOOST_CHECK_EQUAL(after.offloaded, before.offloaded);
+    BOOST_CHECK_EQUAL(after.fallbacks, before.fallbacks + 2);
+}
@@ -0,0 +1,115 @@
+#include <boost/test/unit_test.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "beast_router.hpp"
+#include "test_ssl_utility.hpp"
+
+namespace net = boost::asio;
+namespace http = beast_router::http;
+
+using server_type = test::tls_server_type;
+using beast_router::ssl::session_cache;
+
+namespace {
+
+/// Serves the tls connections resuming the sessions
+class tls_upstream {
+public:
+    explicit tls_upstream(const beast_router::ssl::resumption_settings& settings)
+        : m_cache { session_cache::create(settings) }
+        , m_router {}
+        , m_server {}
+    {
+        m_router.get(R"(^/$)", [](server_type::context_type& ctx) {
+            ctx.send(beast_router::make_string_response(http::status::ok, 11, "ok"));
+            ctx.recv();
+        });
+        m_server.emplace(m_router, [this](net::ssl::context& ssl_ctx) { m_cache->attach(ssl_ctx); });
+    }
+
+    net::ip::tcp::endpoint endpoint() const { return m_server->endpoint(); }
+
+    session_cache& cache() { return *m_cache; }
+
+private:
+    session_cache::cache_ptr_type m_cache;
+    server_type::router_type m_router;
+    std::optional<test::tls_server> m_server;
+};
+
+/// Makes a new connection and waits for the response
+bool fetch(net::ssl::context& ssl_ctx, const net::ip::tcp::endpoint& endpoint)
+{
+    return test::tls_fetch(ssl_ctx, endpoint, { "/" }) == std::vector<std::string> { "ok" };
+}
+
+/// Makes the client context resuming the sessions
+net::ssl::context make_client(session_cache::cache_ptr_type cache, net::ssl::context::method method)
+{
+    net::ssl::context ssl_ctx { method };
+    ssl_ctx.set_verify_mode(net::ssl::verify_none);
+    cache->attach(ssl_ctx);
+    return ssl_ctx;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(session_tickets)
+{
+    tls_upstream server { beast_router::ssl::resumption_settings {} };
+    auto cache = session_cache::create();
+    auto ssl_ctx = make_client(cache, net::ssl::context::tls_client);
+
+    for (int idx = 0; idx < 3; ++idx) {
+        BOOST_CHECK(fetch(ssl_ctx, server.endpoint()));
+    }
+    BOOST_CHECK_EQUAL(cache->size(), 1u);
+    BOOST_CHECK_EQUAL(cache->stats().handshakes, 3u);
+    BOOST_CHECK_EQUAL(cache->stats().offered, 2u);
+    BOOST_CHECK_EQUAL(cache->stats().resumed, 2u);
+    BOOST_CHECK_EQUAL(server.cache().stats().resumed, 2u);
+    BOOST_CHECK_CLOSE(server.cache().stats().hit_rate(), 2.0 / 3.0, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(ticket_key_rotation)
+{
+    tls_upstream server { beast_router::ssl::resumption_settings {} };
+    auto cache = session_cache::create();
+    auto ssl_ctx = make_client(cache, net::ssl::context::tls_client);
+
+    // the ticket of the previous key is accepted
+    BOOST_CHECK(fetch(ssl_ctx, server.endpoint()));
+    server.cache().rotate_ticket_keys();
+    BOOST_CHECK(fetch(ssl_ctx, server.endpoint()));
+    BOOST_CHECK_EQUAL(server.cache().stats().resumed, 1u);
+
+    // the ticket of the older one is not
+    server.cache().rotate_ticket_keys();
+    server.cache().rotate_ticket_keys();
+    BOOST_CHECK(fetch(ssl_ctx, server.endpoint()));
+    BOOST_CHECK_EQUAL(server.cache().stats().handshakes, 3u);
+    BOOST_CHECK_EQUAL(server.cache().stats().resumed, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(server_session_cache)
+{
+    beast_router::ssl::resumption_settings settings;
+    settings.tickets = false;
+    tls_upstream server { settings };
+    auto cache = session_cache::create();
+    auto ssl_ctx = make_client(cache, net::ssl::context::tlsv12_client);
+
+    for (int idx = 0; idx < 3; ++idx) {
+        BOOST_CHECK(fetch(ssl_ctx, server.endpoint()));
+    }
+    BOOST_CHECK_EQUAL(server.cache().stats().handshakes, 3u);
+    BOOST_CHECK_EQUAL(server.cache().stats().resumed, 2u);
+
+    // the dropped sessions are not offered
+    cache->clear();
+    BOOST_CHECK(fetch(ssl_ctx, server.endpoint()));
+    BOOST_CHECK_EQUAL(cache->stats().offered, 2u);
+    BOOST_CHECK_EQUAL(server.cache().stats().resumed, 2u);
+}
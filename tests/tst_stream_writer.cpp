@@ -0,0 +1,85 @@
+#include <boost/test/unit_test.hpp>
+#include <string>
+
+#include "beast_router.hpp"
+#include "test_utility.hpp"
+
+namespace net = boost::asio;
+
+using server_type = beast_router::http_server_type;
+using router_type = server_type::router_type;
+using message_type = server_type::message_type;
+using context_type = server_type::context_type;
+
+using test::fetch;
+
+BOOST_AUTO_TEST_CASE(chunked_stream)
+{
+    router_type router;
+    router.get(R"(^/chunked$)", [](const message_type& rq, context_type& ctx) {
+        auto writer = ctx.stream(beast_router::make_empty_response(
+            beast_router::http::status::ok, rq.version()));
+        BOOST_CHECK(writer.write("Hello"));
+        BOOST_CHECK(writer.write(", "));
+        BOOST_CHECK(writer.write("World"));
+        writer.close();
+        BOOST_CHECK(!writer.write("ignored"));
+    });
+
+    const auto rp = fetch(router, "/chunked");
+    BOOST_CHECK(rp.chunked());
+    BOOST_CHECK_EQUAL(rp.body(), "Hello, World");
+}
+
+BOOST_AUTO_TEST_CASE(chunked_stream_http10)
+{
+    router_type router;
+    router.get(R"(^/raw$)", [](const message_type& rq, context_type& ctx) {
+        auto writer = ctx.stream(beast_router::make_empty_response(
+            beast_router::http::status::ok, rq.version()));
+        writer.write("raw body");
+        writer.close();
+    });
+
+    const auto rp = fetch(router, "/raw", 10);
+    BOOST_CHECK(!rp.chunked());
+    BOOST_CHECK_EQUAL(rp.body(), "raw body");
+}
+
+BOOST_AUTO_TEST_CASE(event_stream)
+{
+    router_type router;
+    router.get(R"(^/events$)", [](const message_type& rq, context_type& ctx) {
+        auto writer = ctx.stream(beast_router::make_event_stream_response(rq.version()));
+        writer.write_event("first");
+        writer.write_event("multi\nline", "update", "2");
+        writer.close();
+    });
+
+    const auto rp = fetch(router, "/events");
+    BOOST_CHECK_EQUAL(rp[beast_router::http::field::content_type], "text/event-stream");
+    BOOST_CHECK_EQUAL(rp.body(),
+        "data: first\n\n"
+        "event: update\nid: 2\ndata: multi\ndata: line\n\n");
+}
+
+BOOST_AUTO_TEST_CASE(stream_backpressure)
+{
+    router_type router;
+    router.get(R"(^/large$)", [](const message_type& rq, context_type& ctx) {
+        auto writer = ctx.stream(beast_router::make_empty_response(
+                                     beast_router::http::status::ok, rq.version()),
+            16);
+        BOOST_CHECK(writer.write("0123456789"));
+        BOOST_CHECK(!writer.write("0123456789"));
+        BOOST_CHECK_EQUAL(writer.pending(), 20u);
+
+        writer.on_drain([writer]() mutable {
+            writer.write("done");
+            writer.close();
+        });
+    });
+
+    const auto rp = fetch(router, "/large");
+    BOOST_CHECK_EQUAL(rp.body(), "01234567890123456789done");
+}
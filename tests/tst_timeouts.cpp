@@ -0,0 +1,154 @@
+#include <array>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "beast_router.hpp"
+#include "test_utility.hpp"
+
+namespace net = boost::asio;
+
+using namespace std::chrono_literals;
+using server_type = beast_router::http_server_type;
+using router_type = server_type::router_type;
+
+namespace {
+
+/// Serves a connection by the router within the deadlines and keeps the
+/// reported timeouts
+class timeouts_server {
+public:
+    timeouts_server(net::io_context& ioc, const router_type& router,
+        const beast_router::timeouts& timeouts)
+        : m_acceptor { ioc, { net::ip::address_v4::loopback(), 0 } }
+        , m_on_error { [this](boost::system::error_code ec, std::string_view what) {
+            if (ec == net::error::timed_out) {
+                m_expired.emplace_back(what);
+            }
+        } }
+        , m_expired {}
+    {
+        m_acceptor.async_accept([this, &router, timeouts](boost::system::error_code ec, net::ip::tcp::socket socket) {
+            BOOST_REQUIRE(!ec);
+            server_type::recv(std::piecewise_construct, std::move(socket), router, timeouts, m_on_error);
+        });
+    }
+
+    net::ip::tcp::endpoint endpoint() const { return m_acceptor.local_endpoint(); }
+
+    const std::vector<std::string>& expired() const { return m_expired; }
+
+private:
+    net::ip::tcp::acceptor m_acceptor;
+    server_type::on_error_type m_on_error;
+    std::vector<std::string> m_expired;
+};
+
+/// Reads until the server closes the connection
+boost::system::error_code read_until_closed(net::io_context& ioc, net::ip::tcp::socket& socket,
+    std::string& data)
+{
+    boost::system::error_code result;
+    std::function<void()> do_read;
+    auto buffer = std::make_shared<std::array<char, 512>>();
+    do_read = [&]() {
+        socket.async_read_some(net::buffer(*buffer), [&](boost::system::error_code ec, std::size_t size) {
+            if (ec) {
+                result = ec;
+                return;
+            }
+            data.append(buffer->data(), size);
+            do_read();
+        });
+    };
+    do_read();
+    ioc.run_for(test::default_timeout);
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(header_timeout)
+{
+    router_type router;
+    router.get(R"(^/$)", [](const auto& rq, auto& ctx) {
+        ctx.send(beast_router::make_string_response(beast_router::http::status::ok, rq.version(), "ok"));
+    });
+
+    beast_router::timeouts timeouts;
+    timeouts.first_byte = 5s;
+    timeouts.header = 100ms;
+
+    net::io_context ioc;
+    timeouts_server server { ioc, router, timeouts };
+
+    // the header is never completed
+    net::ip::tcp::socket socket { ioc };
+    socket.connect(server.endpoint());
+    net::write(socket, net::buffer(std::string_view { "GET / HTTP/1.1\r\nHost: " }));
+
+    std::string data;
+    BOOST_CHECK(read_until_closed(ioc, socket, data) == net::error::eof);
+    BOOST_CHECK(data.empty());
+    BOOST_CHECK((server.expired() == std::vector<std::string> { "async_timer/header" }));
+}
+
+BOOST_AUTO_TEST_CASE(body_rate)
+{
+    router_type router;
+    router.post(R"(^/$)", [](const auto& rq, auto& ctx) {
+        ctx.send(beast_router::make_string_response(beast_router::http::status::ok, rq.version(), "ok"));
+    });
+
+    beast_router::timeouts timeouts;
+    timeouts.header = 5s;
+    timeouts.min_body_rate = 1000;
+    timeouts.body_grace = 100ms;
+
+    net::io_context ioc;
+    timeouts_server server { ioc, router, timeouts };
+
+    // the body stalls after the first bytes
+    net::ip::tcp::socket socket { ioc };
+    socket.connect(server.endpoint());
+    net::write(socket, net::buffer(std::string_view { "POST / HTTP/1.1\r\nContent-Length: 100000\r\n\r\n0123456789" }));
+
+    std::string data;
+    BOOST_CHECK(read_until_closed(ioc, socket, data) == net::error::eof);
+    BOOST_CHECK((server.expired() == std::vector<std::string> { "async_timer/body" }));
+}
+
+BOOST_AUTO_TEST_CASE(idle_timeout)
+{
+    router_type router;
+    router.get(R"(^/$)", [](const auto& rq, auto& ctx) {
+        auto rp = beast_router::make_string_response(beast_router::http::status::ok, rq.version(), "ok");
+        rp.keep_alive(true);
+        ctx.send(std::move(rp));
+        ctx.recv();
+    });
+
+    beast_router::timeouts timeouts;
+    timeouts.first_byte = 5s;
+    timeouts.header = 5s;
+    timeouts.idle = 100ms;
+    timeouts.write_stall = 5s;
+
+    net::io_context ioc;
+    timeouts_server server { ioc, router, timeouts };
+
+    // the request is served and the kept alive connection is closed once idle
+    net::ip::tcp::socket socket { ioc };
+    socket.connect(server.endpoint());
+    net::write(socket, net::buffer(std::string_view { "GET / HTTP/1.1\r\n\r\n" }));
+
+    std::string data;
+    BOOST_CHECK(read_until_closed(ioc, socket, data) == net::error::eof);
+    BOOST_CHECK(data.find("200 OK") != std::string::npos);
+    BOOST_CHECK(data.find("\r\n\r\nok") != std::string::npos);
+    BOOST_CHECK((server.expired() == std::vector<std::string> { "async_timer/idle" }));
+}
@@ -0,0 +1,107 @@
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "beast_router.hpp"
+#include "test_utility.hpp"
+
+namespace net = boost::asio;
+
+using namespace std::chrono_literals;
+using wheel_type = beast_router::timer_wheel;
+
+namespace {
+
+struct deadline : wheel_type::entry {
+    explicit deadline(std::vector<int>& fired, int id)
+        : m_fired { fired }
+        , m_id { id }
+    {
+    }
+
+    void on_expire() override
+    {
+        BOOST_CHECK(expiry() <= wheel_type::clock_type::now());
+        m_fired.push_back(m_id);
+    }
+
+    std::vector<int>& m_fired;
+    int m_id;
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(expiration_order)
+{
+    net::io_context ioc;
+    auto& wheel = wheel_type::get(ioc.get_executor());
+
+    std::vector<int> fired;
+    auto owner = std::make_shared<int>(0);
+
+    // the last ones are cascaded from the upper level
+    deadline first { fired, 1 }, second { fired, 2 }, third { fired, 3 }, cancelled { fired, 4 }, rearmed { fired, 5 };
+    wheel.arm(third, 900ms, owner);
+    wheel.arm(first, 20ms, owner);
+    wheel.arm(second, 150ms, owner);
+    wheel.arm(cancelled, 50ms, owner);
+    wheel.arm(rearmed, 10ms, owner);
+    wheel.arm(rearmed, 700ms, owner);
+    BOOST_CHECK(wheel.cancel(cancelled));
+    BOOST_CHECK(!wheel.cancel(cancelled));
+    BOOST_CHECK_EQUAL(wheel.size(), 4u);
+
+    // the wheel stops ticking once it is empty
+    ioc.run_for(5s);
+
+    BOOST_CHECK_EQUAL(wheel.size(), 0u);
+    BOOST_CHECK((fired == std::vector<int> { 1, 2, 5, 3 }));
+}
+
+BOOST_AUTO_TEST_CASE(expired_owner)
+{
+    net::io_context ioc;
+    auto& wheel = wheel_type::get(ioc.get_executor());
+
+    std::vector<int> fired;
+    deadline dl { fired, 1 };
+    {
+        auto owner = std::make_shared<int>(0);
+        wheel.arm(dl, 10ms, owner);
+    }
+
+    ioc.run_for(1s);
+
+    BOOST_CHECK(fired.empty());
+}
+
+BOOST_AUTO_TEST_CASE(session_timeout)
+{
+    using server_type = beast_router::http_server_type;
+
+    server_type::router_type router;
+
+    net::io_context ioc;
+    net::ip::tcp::acceptor acceptor { ioc, { net::ip::address_v4::loopback(), 0 } };
+
+    server_type::on_error_type on_error = [](boost::system::error_code, std::string_view) {};
+    acceptor.async_accept([&](boost::system::error_code ec, net::ip::tcp::socket socket) {
+        BOOST_REQUIRE(!ec);
+        server_type::recv(std::piecewise_construct, std::move(socket), router, 50ms, on_error);
+    });
+
+    net::ip::tcp::socket socket { ioc };
+    socket.connect(acceptor.local_endpoint());
+
+    // the idle connection is closed by the server
+    char data = 0;
+    boost::system::error_code read_ec;
+    socket.async_read_some(net::buffer(&data, 1), [&read_ec](boost::system::error_code ec, std::size_t) {
+        read_ec = ec;
+    });
+
+    ioc.run_for(test::default_timeout);
+
+    BOOST_CHECK(read_ec == net::error::eof);
+}
@@ -0,0 +1,119 @@
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "beast_router.hpp"
+#include "test_utility.hpp"
+
+using beast_router::trace_point;
+
+namespace {
+
+namespace net = boost::asio;
+
+using time_point_type = std::chrono::steady_clock::time_point;
+
+std::mutex g_mutex;
+std::vector<std::pair<trace_point, time_point_type>> g_points;
+
+/// Collects the points of all the sessions
+struct recording_tracer {
+    void trace(trace_point point, time_point_type at)
+    {
+        std::lock_guard<std::mutex> lock { g_mutex };
+        g_points.emplace_back(point, at);
+    }
+
+    int requests = 0;
+};
+
+using socket_type = net::basic_stream_socket<net::ip::tcp>;
+
+using traced_server_type = beast_router::session<true,
+    beast_router::http::string_body,
+    boost::beast::flat_buffer,
+    net::ip::tcp,
+    socket_type,
+    beast_router::connection<socket_type, beast_router::base::strand_stream::asio_type>,
+    recording_tracer>;
+
+std::vector<trace_point> points()
+{
+    std::lock_guard<std::mutex> lock { g_mutex };
+    std::vector<trace_point> result;
+    for (const auto& [point, at] : g_points) {
+        result.push_back(point);
+    }
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(null_tracer)
+{
+    static_assert(!beast_router::http_server_type::is_traced::value);
+    static_assert(traced_server_type::is_traced::value);
+    static_assert(std::is_empty_v<beast_router::null_tracer>);
+}
+
+BOOST_AUTO_TEST_CASE(request_timeline)
+{
+    traced_server_type::router_type router;
+    router.get(R"(^/traced$)", [](const auto& rq, auto& ctx) {
+        ++ctx.tracer().requests;
+        BOOST_CHECK_EQUAL(ctx.tracer().requests, 1);
+        ctx.send(beast_router::make_string_response(beast_router::http::status::ok, rq.version(), "traced"));
+    });
+
+    net::io_context ioc;
+    net::ip::tcp::acceptor acceptor { ioc, { net::ip::address_v4::loopback(), 0 } };
+    traced_server_type::on_error_type on_error = [](boost::system::error_code, std::string_view) {};
+    acceptor.async_accept([&](boost::system::error_code ec, net::ip::tcp::socket socket) {
+        if (!ec) {
+            traced_server_type::recv(std::move(socket), router, on_error);
+        }
+    });
+    std::thread server { [&ioc]() { ioc.run_for(test::default_timeout); } };
+
+    net::io_context client_ioc;
+    net::ip::tcp::socket socket { client_ioc };
+    socket.connect(acceptor.local_endpoint());
+    beast_router::http::write(socket,
+        beast_router::make_empty_request(beast_router::http::verb::get, 11, "/traced"));
+
+    boost::beast::flat_buffer buffer;
+    beast_router::http_string_response rp;
+    beast_router::http::read(socket, buffer, rp);
+    BOOST_CHECK_EQUAL(rp.body(), "traced");
+
+    BOOST_REQUIRE(test::wait_until([]() { return points().size() >= 7; }));
+    socket.close();
+    ioc.stop();
+    server.join();
+
+    const std::vector<trace_point> expected {
+        trace_point::accept,
+        trace_point::header,
+        trace_point::body,
+        trace_point::route,
+        trace_point::handler,
+        trace_point::write_start,
+        trace_point::write_end
+    };
+    const auto actual = points();
+
+    // the response is written before the handler returns
+    BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+    BOOST_CHECK(std::is_permutation(expected.begin(), expected.end(), actual.begin()));
+    BOOST_CHECK(std::equal(expected.begin(), expected.begin() + 4, actual.begin()));
+
+    // the timestamps are monotonic
+    std::lock_guard<std::mutex> lock { g_mutex };
+    for (std::size_t idx = 1; idx < g_points.size(); ++idx) {
+        BOOST_CHECK(g_points[idx - 1].second <= g_points[idx].second);
+    }
+}
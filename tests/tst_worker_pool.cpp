@@ -0,0 +1,77 @@
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "beast_router.hpp"
+#include "test_utility.hpp"
+
+namespace net = boost::asio;
+
+using server_type = beast_router::http_server_type;
+using router_type = server_type::router_type;
+using message_type = server_type::message_type;
+using context_type = server_type::context_type;
+
+BOOST_AUTO_TEST_CASE(worker_pool_tasks)
+{
+    std::atomic<int> counter { 0 };
+    {
+        beast_router::worker_pool pool { 4 };
+        BOOST_CHECK_EQUAL(pool.get_threads(), 4u);
+
+        for (int i = 0; i < 100; ++i) {
+            pool.post([&pool, &counter]() {
+                ++counter;
+                // queued locally and stolen by the idle workers
+                for (int j = 0; j < 10; ++j) {
+                    pool.post([&counter]() { ++counter; });
+                }
+            });
+        }
+    }
+
+    BOOST_CHECK_EQUAL(counter, 1100);
+}
+
+BOOST_AUTO_TEST_CASE(worker_pool_exceptions)
+{
+    std::atomic<int> errors { 0 };
+    std::atomic<int> counter { 0 };
+    {
+        beast_router::worker_pool pool { 2, [&errors](std::exception_ptr) { ++errors; } };
+        pool.post([]() { throw std::runtime_error { "failure" }; });
+        pool.post([&counter]() { ++counter; });
+    }
+
+    BOOST_CHECK_EQUAL(errors, 1);
+    BOOST_CHECK_EQUAL(counter, 1);
+}
+
+BOOST_AUTO_TEST_CASE(offloaded_route)
+{
+    auto pool = std::make_shared<beast_router::worker_pool>(2);
+
+    std::thread::id handler_thread_id;
+
+    router_type router;
+    router.get(R"(^/offload/(\d+)$)", beast_router::route_options { pool },
+        [&](const message_type& rq, context_type& ctx, const std::smatch& match) {
+            handler_thread_id = std::this_thread::get_id();
+            ctx.send(beast_router::make_string_response(
+                beast_router::http::status::ok, rq.version(), match[1].str()));
+        });
+
+    std::thread::id io_thread_id;
+    beast_router::http_string_response rp;
+    {
+        test::loopback_server server { router };
+        io_thread_id = server.thread_id();
+        rp = server.fetch("/offload/42");
+    }
+
+    BOOST_CHECK_EQUAL(rp.body(), "42");
+    BOOST_CHECK(handler_thread_id != std::thread::id {});
+    BOOST_CHECK(handler_thread_id != io_thread_id);
+}